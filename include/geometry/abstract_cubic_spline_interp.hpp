@@ -30,6 +30,8 @@
 #include <gromacs/math/vec.h>
 
 #include "geometry/basis_spline.hpp"
+#include "geometry/bspline_basis_set.hpp"
+#include "geometry/spline_interp_workspace.hpp"
 
 
 enum eSplineInterpBoundaryCondition {eSplineInterpBoundaryHermite, 
@@ -142,7 +144,9 @@ enum eSplineInterpDerivEstimate {eSplineInterpDerivSimple,
  * AbstractCubicSplineInterp provides the utilities for correctly assembling 
  * the system matrix and right hand side, the routines for solving the system 
  * are implemented in the derived classes CubicSplineInterp1D and 
- * CubicSplineInterp3D.
+ * CubicSplineInterp3D. The system is stored in and solved by a 
+ * SplineInterpWorkspace, which is kept as a member so that an interpolation
+ * object that is used repeatedly does not reallocate its buffers.
  */
 class AbstractCubicSplineInterp
 {
@@ -157,6 +161,7 @@ class AbstractCubicSplineInterp
         // member variables:
         const int degree_ = 3;
         eSplineInterpBoundaryCondition bc_;
+        SplineInterpWorkspace workspace_;
 
         // internal helper functions:
         void assembleDiagonals(std::vector<real> &knotVector,
@@ -165,6 +170,7 @@ class AbstractCubicSplineInterp
                                real *mainDiag,
                                real *superDiag,
                                eSplineInterpBoundaryCondition bc);
+        real sparseBasisElement(const SparseBasis &basis, unsigned int idx);
         void assembleRhs(std::vector<real> &x,
                          std::vector<real> &f,
                          real *rhsVec,
@@ -30,6 +30,7 @@
 #include <gromacs/math/vec.h>
 
 #include "geometry/bspline_basis_set.hpp"
+#include "geometry/shared_array.hpp"
 
 
 /*!
@@ -53,17 +54,30 @@ const short int PP = 2;
 
 /*!
  * \brief Abstract base class for spline curves in unspecified dimensions.
+ *
+ * The knot vector is held in shared immutable storage, so that copying a 
+ * spline curve does not copy its knots. Accessors return references or views
+ * into this storage rather than copies.
+ *
+ * Whenever the knot vector is set, the class checks whether the unique knots
+ * are uniformly spaced (as is the case after arc length parameterisation). If
+ * so, the knot interval containing an evaluation point is found by index 
+ * arithmetic in constant time rather than by binary search.
  */
 class AbstractSplineCurve
 {
     public:
 
+        // constructor:
+        AbstractSplineCurve();
+
         // getter methods:
         int degree() const;
         int nCtrlPoints() const;
         int nKnots() const;
-        std::vector<real> knotVector() const;
-        std::vector<real> uniqueKnots() const;
+        bool hasUniformKnots() const;
+        const std::vector<real>& knotVector() const;
+        ArrayView<real> uniqueKnots() const;
 
         // method to shift the internal coordinate system:
         void shift(const gmx::RVec &shift);
@@ -75,13 +89,24 @@ class AbstractSplineCurve
         int degree_;
         int nCtrlPoints_;
         int nKnots_;
-        std::vector<real> knots_;
+        SharedArray<real> knots_;
+
+        // uniform knot spacing utilities:
+        bool uniformKnots_;
+        real knotSpacingInv_;
 
         // basis spline (derivative) functor:
         BSplineBasisSet B_;
 
         // internal utility functions:
-        int findInterval(const real &evalPoint);
+        void setKnots(SharedArray<real> knots);
+        int findInterval(const real &evalPoint) const;
+        SparseBasis evaluateBasis(const real &eval, unsigned int deriv);
+
+    private:
+
+        // detection of uniform knot spacing:
+        void detectUniformKnots();
 };
 
 
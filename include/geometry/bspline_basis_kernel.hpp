@@ -0,0 +1,140 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef BSPLINE_BASIS_KERNEL_HPP
+#define BSPLINE_BASIS_KERNEL_HPP
+
+#include <array>
+
+#include <gromacs/utility/real.h> 
+
+
+/*!
+ * \brief Compile-time specialised evaluation of nonzero B-spline basis 
+ * functions and their derivatives.
+ *
+ * This is the counterpart of BSplineBasisSet for a spline degree and 
+ * derivative order known at compile time. All temporaries are held in 
+ * fixed-size std::array objects and all loops have compile-time trip counts,
+ * so that the compiler can fully unroll the Cox-de Boor recursion and no heap
+ * memory is allocated. Spline curves dispatch to this kernel for the degrees
+ * used in CHAP (linear and cubic) and use BSplineBasisSet otherwise.
+ *
+ * The kernel returns the \f$ p + 1 \f$ nonzero basis functions (or their
+ * \f$ k \f$-th derivatives) \f$ B_{i,p}^{(k)}(x) \f$ with 
+ * \f$ i \in [j - p, j] \f$, where \f$ j \f$ is the knot span index, which 
+ * must be determined by the caller.
+ */
+template<int Degree, int Deriv>
+class BSplineBasisKernel
+{
+    public:
+
+        // type of array of nonzero basis elements:
+        typedef std::array<real, Degree + 1> Elements;
+
+        // evaluation of nonzero basis elements:
+        static inline Elements evaluate(
+                real eval,
+                const real *knots,
+                int knotSpanIdx);
+};
+
+
+/*!
+ * Evaluates the nonzero basis elements (for Deriv = 0) or their derivatives. 
+ * The basis functions up to degree \f$ p - k \f$ are computed with the 
+ * triangular scheme of algorithm A2.2 from The NURBS Book. The derivative is 
+ * then obtained by applying the recursion
+ *
+ * \f[
+ *      B_{i,q}'(x) = q \left( \frac{B_{i,q-1}(x)}{t_{i+q} - t_i} 
+ *                  - \frac{B_{i+1,q-1}(x)}{t_{i+q+1} - t_{i+1}} \right)
+ * \f]
+ *
+ * \f$ k \f$ times, which raises the degree back to \f$ p \f$. Within a 
+ * nonempty knot span, none of the denominators involved can vanish. 
+ * Derivatives of order higher than the degree are identically zero.
+ */
+template<int Degree, int Deriv>
+inline typename BSplineBasisKernel<Degree, Deriv>::Elements
+BSplineBasisKernel<Degree, Deriv>::evaluate(
+        real eval,
+        const real *knots,
+        int knotSpanIdx)
+{
+    // degree of basis functions from which derivatives are built:
+    const int baseDegree = Deriv > Degree ? -1 : Degree - Deriv;
+
+    // nonzero basis elements, initially zero:
+    Elements basis;
+    basis.fill(0.0);
+    if( baseDegree < 0 )
+    {
+        return basis;
+    }
+
+    // Cox-de Boor recursion up to base degree:
+    std::array<real, Degree + 1> left;
+    std::array<real, Degree + 1> right;
+    basis[0] = 1.0;
+    for(int q = 1; q <= baseDegree; q++)
+    {
+        left[q] = eval - knots[knotSpanIdx + 1 - q];
+        right[q] = knots[knotSpanIdx + q] - eval;
+
+        real saved = 0.0;
+        for(int r = 0; r < q; r++)
+        {
+            real tmp = basis[r]/(right[r + 1] + left[q - r]);
+            basis[r] = saved + right[r + 1]*tmp;
+            saved = left[q - r]*tmp;
+        }
+        basis[q] = saved;
+    }
+
+    // differentiate by raising degree back to spline degree:
+    for(int q = baseDegree + 1; q <= Degree; q++)
+    {
+        // go backwards so that lower degree elements are still available:
+        for(int r = q; r >= 0; r--)
+        {
+            int i = knotSpanIdx - q + r;
+            real deriv = 0.0;
+            if( r > 0 )
+            {
+                deriv += basis[r - 1]/(knots[i + q] - knots[i]);
+            }
+            if( r < q )
+            {
+                deriv -= basis[r]/(knots[i + q + 1] - knots[i + 1]);
+            }
+            basis[r] = q*deriv;
+        }
+    }
+
+    return basis;
+}
+
+#endif
@@ -77,6 +77,14 @@ class BSplineBasisSet
                 unsigned int degree, 
                 unsigned int deriv);
 
+        // public interface for evaluation in a known knot span:
+        SparseBasis operator()(
+                real eval, 
+                const std::vector<real> &knots, 
+                unsigned int degree, 
+                unsigned int deriv,
+                size_t knotSpanIdx);
+
     private:
 
         // method for finding the correct knot span:
@@ -34,6 +34,10 @@
 /*!
  * \brief Functor class for performing cubic spline interpolation in one 
  * dimension.
+ *
+ * Several functions sampled at the same abscissa points can be interpolated
+ * in a single call. As the system matrix only depends on the abscissa, it is
+ * then assembled and factorised only once for all right hand sides.
  */
 class CubicSplineInterp1D : public AbstractCubicSplineInterp
 {
@@ -50,6 +54,14 @@ class CubicSplineInterp1D : public AbstractCubicSplineInterp
         SplineCurve1D operator()(std::vector<real> &x,
                                  std::vector<real> &f,
                                  eSplineInterpBoundaryCondition bc);
+        std::vector<SplineCurve1D> interpolate(
+                std::vector<real> &x,
+                std::vector<std::vector<real>> &f,
+                eSplineInterpBoundaryCondition bc);
+        std::vector<SplineCurve1D> operator()(
+                std::vector<real> &x,
+                std::vector<std::vector<real>> &f,
+                eSplineInterpBoundaryCondition bc);
 
         // curve properties:
         std::pair<real, real> findMinimum() const;
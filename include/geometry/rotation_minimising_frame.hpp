@@ -0,0 +1,95 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef ROTATION_MINIMISING_FRAME_HPP
+#define ROTATION_MINIMISING_FRAME_HPP
+
+#include <vector>
+
+#include <gromacs/math/vec.h>
+#include <gromacs/utility/real.h>
+
+
+/*!
+ * \brief Lookup table of a rotation-minimising frame along a curve.
+ *
+ * A rotation-minimising (or parallel transport) frame consists of the unit
+ * tangent \f$ \mathbf{t} \f$ of a curve and two unit vectors 
+ * \f$ \mathbf{n} \f$ and \f$ \mathbf{b} = \mathbf{t} \times \mathbf{n} \f$ 
+ * orthogonal to it, which are transported along the curve without any 
+ * rotation about the tangent. In contrast to the Frenet frame, this is well
+ * defined on straight segments and does not twist around the curve.
+ *
+ * The frame is tabulated at uniformly spaced values of the curve parameter
+ * and is computed by the double reflection method of Wang et al. (ACM Trans.
+ * Graph. 27, 2008). Between table entries, normal and binormal are linearly 
+ * interpolated. Beyond either end of the table, the frame is held constant,
+ * which is exact for the linear extrapolation used by SplineCurve3D.
+ *
+ * This frame defines the angular coordinate \f$ \phi \f$ around the centre 
+ * line, which is measured from \f$ \mathbf{n} \f$ towards \f$ \mathbf{b} \f$
+ * so that a point at angle \f$ \phi \f$ lies in direction 
+ * \f$ \cos(\phi) \mathbf{n} + \sin(\phi) \mathbf{b} \f$.
+ */
+class RotationMinimisingFrame
+{
+    public:
+
+        // constructors:
+        RotationMinimisingFrame();
+        RotationMinimisingFrame(
+                real step,
+                const std::vector<gmx::RVec> &points,
+                const std::vector<gmx::RVec> &tangents);
+
+        // size of lookup table:
+        bool empty() const;
+        size_t size() const;
+
+        // frame vectors at given parameter value:
+        gmx::RVec normal(real s) const;
+        gmx::RVec binormal(real s) const;
+
+        // angular coordinate and its inverse:
+        real angle(real s, const gmx::RVec &radial) const;
+        gmx::RVec direction(real s, real phi) const;
+
+    private:
+
+        // parameter spacing of table entries:
+        real step_;
+
+        // tabulated frame vectors:
+        std::vector<gmx::RVec> normals_;
+        std::vector<gmx::RVec> binormals_;
+
+        // table lookup utilities:
+        inline void lookup(real s, size_t &idx, real &weight) const;
+        inline gmx::RVec interpolate(
+                const std::vector<gmx::RVec> &table,
+                size_t idx,
+                real weight) const;
+};
+
+#endif
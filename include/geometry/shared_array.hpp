@@ -0,0 +1,204 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SHARED_ARRAY_HPP
+#define SHARED_ARRAY_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+/*!
+ * \brief Non-owning, read-only view of a contiguous range of elements.
+ *
+ * This is returned by accessors which expose part of an internal array, so
+ * that element access does not require a copy. The view remains valid for as
+ * long as the storage it refers to is alive. It can be converted to a 
+ * std::vector where a copy is actually needed.
+ */
+template<typename T>
+class ArrayView
+{
+    public:
+
+        // types for compatibility with standard containers:
+        typedef T value_type;
+        typedef const T* const_iterator;
+
+        // constructors:
+        ArrayView()
+            : begin_(nullptr)
+            , end_(nullptr)
+        {
+        }
+        ArrayView(const T *begin, const T *end)
+            : begin_(begin)
+            , end_(end)
+        {
+        }
+
+        // element access:
+        const T& operator[](size_t i) const
+        {
+            return begin_[i];
+        }
+        const T& at(size_t i) const
+        {
+            if( i >= size() )
+            {
+                throw std::out_of_range("Index out of range in ArrayView.");
+            }
+            return begin_[i];
+        }
+        const T& front() const
+        {
+            return *begin_;
+        }
+        const T& back() const
+        {
+            return *(end_ - 1);
+        }
+
+        // iterators:
+        const_iterator begin() const
+        {
+            return begin_;
+        }
+        const_iterator end() const
+        {
+            return end_;
+        }
+
+        // size:
+        size_t size() const
+        {
+            return end_ - begin_;
+        }
+        bool empty() const
+        {
+            return begin_ == end_;
+        }
+
+        // explicit copy:
+        operator std::vector<T>() const
+        {
+            return std::vector<T>(begin_, end_);
+        }
+
+    private:
+
+        const T *begin_;
+        const T *end_;
+};
+
+
+/*!
+ * \brief Immutable array with shared, reference-counted storage.
+ *
+ * Copying a SharedArray only copies a pointer to the underlying data, which is
+ * never modified after construction. This is used for the knot vectors and 
+ * control points of spline curves, so that copies of a spline curve (e.g. 
+ * of the splines held by a MolecularPath) do not allocate memory. 
+ * Modification is only possible by assigning an entirely new array.
+ */
+template<typename T>
+class SharedArray
+{
+    public:
+
+        // types for compatibility with standard containers:
+        typedef T value_type;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+
+        // constructors:
+        SharedArray()
+            : data_(std::make_shared<const std::vector<T>>())
+        {
+        }
+        SharedArray(std::vector<T> data)
+            : data_(std::make_shared<const std::vector<T>>(std::move(data)))
+        {
+        }
+
+        // element access:
+        const T& operator[](size_t i) const
+        {
+            return (*data_)[i];
+        }
+        const T& at(size_t i) const
+        {
+            return data_ -> at(i);
+        }
+        const T& front() const
+        {
+            return data_ -> front();
+        }
+        const T& back() const
+        {
+            return data_ -> back();
+        }
+
+        // iterators:
+        const_iterator begin() const
+        {
+            return data_ -> begin();
+        }
+        const_iterator end() const
+        {
+            return data_ -> end();
+        }
+
+        // size:
+        size_t size() const
+        {
+            return data_ -> size();
+        }
+        bool empty() const
+        {
+            return data_ -> empty();
+        }
+
+        // access to whole array and to subranges without copying:
+        const std::vector<T>& vector() const
+        {
+            return *data_;
+        }
+        operator const std::vector<T>&() const
+        {
+            return *data_;
+        }
+        ArrayView<T> view(size_t first, size_t last) const
+        {
+            return ArrayView<T>(data_ -> data() + first, data_ -> data() + last);
+        }
+
+    private:
+
+        std::shared_ptr<const std::vector<T>> data_;
+};
+
+#endif
@@ -45,6 +45,7 @@ class SplineCurve1D : public AbstractSplineCurve
 {
     friend class SplineCurve1DTest;
     FRIEND_TEST(SplineCurve1DTest, SplineCurve1DFindIntervalTest);
+    FRIEND_TEST(SplineCurve1DTest, SplineCurve1DUniformKnotsTest);
 
     public:
     
@@ -53,6 +54,10 @@ class SplineCurve1D : public AbstractSplineCurve
                 int degree, 
                 std::vector<real> knotVector,
                 std::vector<real> ctrlPoints); 
+        SplineCurve1D(
+                int degree, 
+                SharedArray<real> knotVector,
+                std::vector<real> ctrlPoints); 
         SplineCurve1D();
 
         // public interface for curve evaluation:
@@ -64,21 +69,35 @@ class SplineCurve1D : public AbstractSplineCurve
                 unsigned int deriv);
 
         // getter function for control points:
-        std::vector<real> ctrlPoints() const;
+        const std::vector<real>& ctrlPoints() const;
 
         // compute spline properties:
         real length() const;
         std::pair<real, real> minimum(const std::pair<real, real> &lim);
+        real integrateSquare(const std::pair<real, real> &lim);
 
     private:
 
         // internal variables:
-        std::vector<real> ctrlPoints_;
+        SharedArray<real> ctrlPoints_;
+
+        // precomputed values for constant extrapolation:
+        real extrapValueLo_;
+        real extrapValueHi_;
 
         // auxiliary functions for evaluation:
         inline real evaluateInternal(const real &eval, unsigned int deriv);
         inline real evaluateExternal(const real &eval, unsigned int deriv);
+        template<int Degree, int Deriv>
+        inline real evaluateKernel(const real &eval, int knotSpanIdx);
         inline real computeLinearCombination(const SparseBasis &basis);
+        void prepareExtrapolation();
+
+        // polynomial representation in knot spans:
+        std::vector<double> spanPolynomial(int knotSpanIdx);
+
+        // minimisation for higher degree splines:
+        std::pair<real, real> minimumBrent(const std::pair<real, real> &lim);
 };
 
 #endif
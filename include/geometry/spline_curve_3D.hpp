@@ -33,6 +33,7 @@
 #include <gromacs/math/vec.h>
 
 #include "geometry/abstract_spline_curve.hpp"
+#include "geometry/rotation_minimising_frame.hpp"
 
 
 /*!
@@ -52,6 +53,11 @@
  *
  * The method arcLengthParam() can be used to change the internal
  * representation of the curve such that it is parameterised by arc length. 
+ *
+ * A RotationMinimisingFrame is tabulated along the curve on first use. It 
+ * defines the angular coordinate returned by cartesianToCurvilinear() and can 
+ * be accessed through frameNormal() and frameBinormal(), so that surfaces 
+ * built around the curve use the same angular coordinate.
  */
 class SplineCurve3D : public AbstractSplineCurve
 {
@@ -79,19 +85,30 @@ class SplineCurve3D : public AbstractSplineCurve
         gmx::RVec normalVec(const real &eval);        
         real speed(const real &eval);
 
+        // rotation-minimising frame along curve:
+        gmx::RVec frameNormal(const real &eval);
+        gmx::RVec frameBinormal(const real &eval);
+
         // utilities for accessing arc length at the control points:
         std::vector<real> ctrlPointArcLength();
         real frstPointArcLength();
         real lastPointArcLength();
  
         // getter functions:
-        std::vector<gmx::RVec> ctrlPoints() const;
+        const std::vector<gmx::RVec>& ctrlPoints() const;
         
     private:
 
         // internal variables:
-        std::vector<gmx::RVec> ctrlPoints_;
+        SharedArray<gmx::RVec> ctrlPoints_;
         std::vector<gmx::RVec> refPoints_;
+        RotationMinimisingFrame frame_;
+
+        // precomputed coefficients for linear extrapolation:
+        gmx::RVec extrapOffsetLo_;
+        gmx::RVec extrapOffsetHi_;
+        gmx::RVec extrapSlopeLo_;
+        gmx::RVec extrapSlopeHi_;
 
         // arc length lookup table utilities:
         bool arcLengthTableAvailable_;
@@ -100,16 +117,20 @@ class SplineCurve3D : public AbstractSplineCurve
         // curve evaluation utilities:
         inline gmx::RVec evaluateInternal(const real &eval, unsigned int deriv);
         inline gmx::RVec evaluateExternal(const real &eval, unsigned int deriv);
+        template<int Degree, int Deriv>
+        inline gmx::RVec evaluateKernel(const real &eval, int knotSpanIdx);
         inline gmx::RVec computeLinearCombination(const SparseBasis &basis);
+        void prepareExtrapolation();
+
+        // rotation-minimising frame utilities:
+        void prepareFrame();
 
         // curve length utilities:
-        inline real arcLengthBoole(const real &lo, const real &hi);
+        inline real arcLengthGauss(const real &lo, const real &hi);
         void prepareArcLengthTable();
         
         // arc length re-parameterisation utilities:
         inline real arcLengthToParam(real &arcLength);
-        inline bool arcLengthToParamTerm(real lo, real hi, real tol);
-        inline real arcLengthToParamObj(real lo, real hi, real target);
 
         // spline mapping methods:
         unsigned int closestSplinePoint(const gmx::RVec &point);
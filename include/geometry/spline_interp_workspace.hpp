@@ -0,0 +1,93 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SPLINE_INTERP_WORKSPACE_HPP
+#define SPLINE_INTERP_WORKSPACE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <gromacs/utility/real.h>
+
+
+/*!
+ * \brief Reusable storage and solver for the tridiagonal linear systems 
+ * occurring in spline interpolation.
+ *
+ * The workspace holds the three diagonals of an \f$ n \times n \f$ 
+ * tridiagonal matrix and an \f$ n \times m \f$ matrix of right hand sides 
+ * stored column by column. All buffers live on the heap and only grow, so that
+ * a workspace which is reused across interpolations of similar size does not 
+ * reallocate memory. Storage is of type real, i.e. the system is solved in 
+ * double precision if Gromacs was compiled in double precision.
+ *
+ * The system is solved by Gaussian elimination with partial pivoting 
+ * specialised to tridiagonal matrices, i.e. the Thomas algorithm with 
+ * interchange of adjacent rows where necessary. Pivoting is required because 
+ * the interpolation condition at the endpoints of a clamped knot vector leads 
+ * to zero diagonal elements. All right hand sides are processed in the same 
+ * elimination sweep.
+ */
+class SplineInterpWorkspace
+{
+    public:
+
+        // constructor:
+        SplineInterpWorkspace();
+
+        // set system dimensions:
+        void resize(
+                size_t nSys, 
+                size_t nRhs);
+
+        // access to system matrix and right hand sides:
+        real* subDiag();
+        real* mainDiag();
+        real* superDiag();
+        real* rhs(size_t j = 0);
+
+        // solve system in place:
+        void solve();
+
+        // getter functions:
+        size_t size() const;
+        size_t numRhs() const;
+
+    private:
+
+        // system dimensions:
+        size_t nSys_;
+        size_t nRhs_;
+
+        // matrix diagonals, including fill-in from pivoting:
+        std::vector<real> subDiag_;
+        std::vector<real> mainDiag_;
+        std::vector<real> superDiag_;
+        std::vector<real> superDiag2_;
+
+        // right hand sides (overwritten by solution):
+        std::vector<real> rhs_;
+};
+
+#endif
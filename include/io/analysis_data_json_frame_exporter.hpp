@@ -25,13 +25,17 @@
 #ifndef ANALYSIS_DATA_JSON_FRAME_EXPORTER
 #define ANALYSIS_DATA_JSON_FRAME_EXPORTER
 
-#include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gromacs/analysisdata/datamodule.h"
 
 #include "external/rapidjson/document.h"
+#include "external/rapidjson/writer.h"
+
+#include "io/compressed_file_write_stream.hpp"
+#include "io/json_column_codec.hpp"
 
 
 /*!
@@ -63,15 +67,27 @@
  *   need to keep the entire file in memory (or implement a much more 
  *   complicated parser for extracting features of interest).
  *
- * The repeated opening and closing of files may not be very efficient, but 
- * will likely not be the bottleneck of the analysis tool.
+ * The output file is held open from dataStarted() until dataFinished() and is
+ * written through a large user-space buffer. The buffer is flushed to disk 
+ * every setFlushInterval() frames (or whenever it is full). If the file name
+ * ends in .gz, the output is gzip compressed on a background thread (see 
+ * CompressedFileWriteStream). The JSON document
+ * is created once and its column arrays are cleared rather than reallocated 
+ * for each frame, so that no per-frame memory allocation is needed once the
+ * arrays have reached their maximum size.
+ *
+ * By default each column is written as a plain array of floating point 
+ * numbers. Large data sets can be written more compactly by assigning a
+ * JsonColumnCodec with a different encoding to individual columns through
+ * setColumnCodecs(), e.g. to quantise coordinates or bit-pack boolean flags.
+ * Such columns need to be read back through JsonColumnCodec::decode().
  */
 class AnalysisDataJsonFrameExporter : public gmx::AnalysisDataModuleSerial
 {
     public:
 
         // constructor and destructor:
-        AnalysisDataJsonFrameExporter(){};
+        AnalysisDataJsonFrameExporter();
         ~AnalysisDataJsonFrameExporter(){};
 
         // interface for interacting with trajectory analysis module:
@@ -93,6 +109,17 @@ class AnalysisDataJsonFrameExporter : public gmx::AnalysisDataModuleSerial
                 const std::vector<std::string> &dataSetNames);
         void setColumnNames(
                 const std::vector<std::vector<std::string>> &columnNames);
+        void setColumnCodecs(
+                const std::vector<std::vector<JsonColumnCodec>> &columnCodecs);
+
+        // setter functions for output buffering:
+        void setFlushInterval(
+                int flushInterval);
+        void setBufferSize(
+                size_t bufferSize);
+
+        // getter functions:
+        size_t numSyncs() const;
     
 
     private:
@@ -100,11 +127,27 @@ class AnalysisDataJsonFrameExporter : public gmx::AnalysisDataModuleSerial
         // names of data sets and columns:
         std::vector<std::string> dataSetNames_;
         std::vector<std::vector<std::string>> columnNames_;
+        std::vector<std::vector<JsonColumnCodec>> columnCodecs_;
 
         // internal variables:
         rapidjson::Document json_;
         std::string fileName_ = "stream.json";
-        std::fstream file_;
+
+        // codecs attached to columns inside JSON document:
+        std::vector<std::vector<JsonColumnCodec>> columns_;
+
+        // buffered output stream:
+        size_t bufferSize_;
+        std::unique_ptr<CompressedFileWriteStream> stream_;
+        rapidjson::Writer<CompressedFileWriteStream> writer_;
+        int flushInterval_;
+        int framesSinceFlush_;
+        size_t numSyncs_;
+
+        // internal auxiliary functions:
+        void buildDocument();
+        void flush();
+        void closeFile();
 };
 
 
@@ -0,0 +1,72 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef COMPRESSED_FILE_READ_STREAM_HPP
+#define COMPRESSED_FILE_READ_STREAM_HPP
+
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+
+/*!
+ * \brief Input file stream that transparently reads both gzip compressed and
+ * uncompressed files.
+ *
+ * Whether a file is compressed is detected from its content rather than its
+ * name, so that files written by CompressedFileWriteStream can be read back 
+ * regardless of their extension. Provides line-wise reading for newline 
+ * delimited JSON files as well as reading of an entire file at once.
+ */
+class CompressedFileReadStream
+{
+    public:
+
+        // constructor and destructor:
+        CompressedFileReadStream(
+                const std::string &fileName,
+                size_t bufferSize = 1 << 17);
+        ~CompressedFileReadStream();
+
+        // reading interface:
+        bool getline(
+                std::string &line);
+        std::string readAll();
+
+    private:
+
+        // file handle and name:
+        std::string fileName_;
+        gzFile file_;
+
+        // buffer for reading chunks:
+        std::vector<char> chunk_;
+
+        // internal auxiliary functions:
+        void checkError();
+};
+
+#endif
+
@@ -0,0 +1,146 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef COMPRESSED_FILE_WRITE_STREAM_HPP
+#define COMPRESSED_FILE_WRITE_STREAM_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+
+/*!
+ * \brief Buffered output file stream with optional gzip compression.
+ *
+ * Whether the output is compressed is determined from the file name: files 
+ * ending in .gz are written in gzip format, all other files are written 
+ * uncompressed. The class implements the output part of the rapidjson stream
+ * concept, so that it can be used with rapidjson::Writer directly.
+ *
+ * Characters are collected in a user-space buffer. Once this buffer is full,
+ * it is handed over to a worker thread, which compresses it and writes it to
+ * disk while the calling thread continues filling a second buffer. The worker
+ * is started when the first buffer is handed over and then waits for further
+ * buffers until the stream is closed, so that no thread is created per 
+ * buffer. 
+ * Compression (and disk I/O) thus overlaps with the analysis and only becomes
+ * a bottleneck if it is slower than the production of output.
+ *
+ * rapidjson::Writer calls Flush() after every complete root value, i.e. for 
+ * every line of a newline delimited JSON file. Flush() therefore does 
+ * nothing, as forcing data to disk (and a sync point in the compressed 
+ * stream) for each line would defeat both buffering and compression. Data is
+ * only forced to disk by an explicit call to sync() or by close().
+ *
+ * The stream must be closed explicitly by calling close(), which reports 
+ * errors by throwing an exception. The destructor closes the file without 
+ * error checking if this has not been done.
+ */
+class CompressedFileWriteStream
+{
+    public:
+
+        // character type for rapidjson:
+        typedef char Ch;
+
+        // constructor and destructor:
+        CompressedFileWriteStream(
+                const std::string &fileName,
+                size_t bufferSize = 1 << 20,
+                int compressionLevel = Z_DEFAULT_COMPRESSION);
+        ~CompressedFileWriteStream();
+
+        // output interface required by rapidjson:
+        inline void Put(Ch c)
+        {
+            if( current_ == end_ )
+            {
+                swapBuffers();
+            }
+            *current_++ = c;
+        }
+        inline void Flush()
+        {
+            // deliberately empty, see class documentation:
+        }
+
+        // additional output interface:
+        void sync();
+        void write(
+                const char *data, 
+                size_t size);
+        void close();
+
+        // getter functions:
+        bool isCompressed() const;
+        size_t numSyncs() const;
+        static bool isCompressedFileName(
+                const std::string &fileName);
+
+    private:
+
+        // file and compression state:
+        std::string fileName_;
+        std::FILE *file_;
+        bool compressed_;
+        z_stream zStream_;
+
+        // double buffering:
+        std::vector<char> buffers_[2];
+        size_t activeBuffer_;
+        char *begin_;
+        char *current_;
+        char *end_;
+        std::vector<unsigned char> deflateBuffer_;
+        size_t numSyncs_;
+
+        // worker thread, block handed over to it, and its error state:
+        std::thread worker_;
+        std::mutex workerMutex_;
+        std::condition_variable workerCondition_;
+        const char *pendingData_;
+        size_t pendingSize_;
+        bool hasPending_;
+        bool stopWorker_;
+        bool workerFailed_;
+
+        // internal auxiliary functions:
+        void swapBuffers();
+        void waitForWorker();
+        void stopWorker();
+        void workerLoop();
+        void writeBlock(
+                const char *data, 
+                size_t size, 
+                int flushMode);
+        void release();
+};
+
+#endif
+
@@ -0,0 +1,122 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+
+#ifndef JSON_COLUMN_CODEC_HPP
+#define JSON_COLUMN_CODEC_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+#include "external/rapidjson/document.h"
+
+
+/*!
+ * Enum for the ways in which a data column can be represented in JSON.
+ */
+enum eColumnEncoding {eColumnEncodingPlain, 
+                      eColumnEncodingQuantised,
+                      eColumnEncodingDelta,
+                      eColumnEncodingBitPacked};
+
+
+/*!
+ * \brief Encodes a column of numbers into a JSON value and decodes it again.
+ *
+ * By default (eColumnEncodingPlain) a column is simply written as a JSON array
+ * of floating point numbers. The other encodings trade precision for size and
+ * write the column as an object containing the name of the encoding and a 
+ * data array of integers:
+ *
+ * - eColumnEncodingQuantised rounds each value to the nearest multiple of a
+ *   given quantum and stores the multiplier, e.g. coordinates at 0.001 nm 
+ *   resolution. The quantum is stored in the object as well.
+ * - eColumnEncodingDelta rounds each value to the nearest integer and stores
+ *   the difference to the preceding value, which is efficient for sorted 
+ *   identifiers.
+ * - eColumnEncodingBitPacked stores 32 boolean values per unsigned integer,
+ *   with any nonzero value being interpreted as true. The number of values is
+ *   stored in the object, as the last integer may be partially filled.
+ *
+ * Encoding is incremental, i.e. values are encoded as they are appended and
+ * the JSON value is always a valid representation of all values appended 
+ * since the last call to clear(). The codec does not own the JSON value, but
+ * caches pointers into it, which remain valid as long as no members are added
+ * to or removed from the enclosing object. The static decode() function 
+ * accepts columns in any encoding, including plain arrays.
+ */
+class JsonColumnCodec
+{
+    public:
+
+        // constructor:
+        JsonColumnCodec(
+                eColumnEncoding encoding = eColumnEncodingPlain,
+                real quantum = 0.001);
+
+        // setting up and filling column value:
+        rapidjson::Value makeColumn(
+                rapidjson::Document::AllocatorType &allocator) const;
+        void attach(
+                rapidjson::Value &column);
+        void clear();
+        void append(
+                double value,
+                rapidjson::Document::AllocatorType &allocator);
+
+        // decoding of column values:
+        static void decode(
+                const rapidjson::Value &column,
+                std::vector<real> &values);
+        static std::vector<real> decode(
+                const rapidjson::Value &column);
+
+        // getter functions:
+        eColumnEncoding encoding() const;
+        real quantum() const;
+        size_t size() const;
+
+    private:
+
+        // encoding parameters:
+        eColumnEncoding encoding_;
+        double quantum_;
+
+        // state of encoding:
+        size_t size_;
+        int64_t previous_;
+
+        // cached pointers into JSON value:
+        rapidjson::Value *data_;
+        rapidjson::Value *sizeValue_;
+
+        // auxiliary functions:
+        static const char* encodingName(
+                eColumnEncoding encoding);
+};
+
+#endif
+
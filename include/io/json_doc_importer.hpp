@@ -25,13 +25,32 @@
 #ifndef JSON_DOC_IMPORTER_HPP
 #define JSON_DOC_IMPORTER_HPP
 
+#include <memory>
 #include <string>
 
 #include "external/rapidjson/document.h"
 
 
+/*!
+ * \brief JSON document together with the file content it was parsed from.
+ *
+ * As the document is parsed in situ, its string values point into the file
+ * content buffer, which is therefore owned alongside the document. The buffer
+ * is held by pointer so that it stays in place when the document is moved.
+ */
+struct ImportedJsonDoc
+{
+    std::unique_ptr<std::string> buffer_;
+    rapidjson::Document doc_;
+};
+
+
 /*!
  * \brief Imports JSON files and returns them as rapidjson objects.
+ *
+ * Files are read into a single buffer and parsed in situ, so that string
+ * values in the returned document point into this buffer rather than being
+ * copied. The buffer is returned together with the document.
  */
 class JsonDocImporter
 {
@@ -42,7 +61,7 @@ class JsonDocImporter
         ~JsonDocImporter(){};
 
         // define operator for file reading:
-        rapidjson::Document operator()(std::string fileName);
+        ImportedJsonDoc operator()(std::string fileName);
 };
 
 #endif
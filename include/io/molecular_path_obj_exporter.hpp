@@ -25,10 +25,10 @@
 #ifndef MOLECULAR_PATH_OBJ_EXPORTER_HPP
 #define MOLECULAR_PATH_OBJ_EXPORTER_HPP
 
+#include <chrono>
 #include <map>
 #include <string>
-#include <tuple>
-#include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -48,6 +48,10 @@
  * to subsequently generate vertex normals. 
  *
  * This is all used by MolcularPathObjExporter.
+ *
+ * Properties are interned to consecutive integer ids in the order in which 
+ * they are first added, and all per-vertex data is stored in dense arrays 
+ * indexed as [property][i*numPhi + j].
  */
 class RegularVertexGrid
 {
@@ -60,6 +64,12 @@ class RegularVertexGrid
                 std::vector<real> s,
                 std::vector<real> phi);
 
+        // interface for registering properties:
+        size_t addProperty(
+                std::string p);
+        size_t propertyId(
+                std::string p) const;
+
         // interface for adding vertices to the grid:
         void addVertex(
                 size_t i, 
@@ -67,6 +77,12 @@ class RegularVertexGrid
                 std::string p,
                 gmx::RVec vertex, 
                 real weight);
+        void addVertex(
+                size_t i, 
+                size_t j,
+                size_t propId,
+                gmx::RVec vertex, 
+                real weight);
 
 
         void addColourScale(
@@ -100,15 +116,28 @@ class RegularVertexGrid
 
         const std::vector<real> phi_;
         const std::vector<real> s_;
-        std::unordered_set<std::string> p_;
+
+        // interned property names:
+        std::map<std::string, size_t> propIds_;
+        std::vector<std::string> propNames_;
 
         std::map<std::string, ColourScale> colourScales_;
 
-        std::map<std::tuple<size_t, size_t, std::string>, gmx::RVec> vertices_;
-        std::map<std::tuple<size_t, size_t, std::string>, real> weights_;
-        std::map<std::tuple<size_t, size_t, std::string>, gmx::RVec> normals_;
+        // dense per-property vertex data:
+        std::vector<std::vector<gmx::RVec>> vertices_;
+        std::vector<std::vector<real>> weights_;
+        std::vector<std::vector<gmx::RVec>> normals_;
+        std::vector<std::vector<bool>> hasVertex_;
+        std::vector<size_t> numVertices_;
 
+        // linear index of vertex in property array:
+        inline size_t linearIndex(size_t i, size_t j) const
+        {
+            return i*phi_.size() + j;
+        };
 
+        // check that all vertices of a property have been added:
+        void checkComplete(size_t propId) const;
 
         void addTriangleNorm(
                 const gmx::RVec &sideA, 
@@ -146,6 +175,16 @@ class MolecularPathObjExporter
         void setGridSampleDist(real gridSampleDist);
         void setCorrectionThreshold(real correctionThreshold);
         void setPermitClashes(bool permitClashes);
+        void setNumThreads(int numThreads);
+        void setWritePly(bool writePly);
+
+        // getter functions:
+        std::pair<size_t, size_t> resolution() const;
+        std::map<std::string, double> timings() const;
+
+        // interface for surface geometry only:
+        std::vector<gmx::RVec> surfaceVertices(
+                MolecularPath &molPath);
 
         // interface for exporting:
         void operator()(
@@ -161,21 +200,35 @@ class MolecularPathObjExporter
         real extrapDist_;
         real gridSampleDist_;
         real correctionThreshold_;
+        int numThreads_;
+
+        // grid resolution (number of rings and vertices per ring):
+        size_t numLen_;
+        size_t numPhi_;
+
+        // write additional binary PLY file?
+        bool writePly_;
+
+        // wall clock time per export stage:
+        std::map<std::string, double> timings_;
 
         // functions for generating the pathway surface grid:
-        std::vector<gmx::RVec> generateNormals(
-                const std::vector<gmx::RVec> &tangents);
         RegularVertexGrid generateGrid(
                 SplineCurve3D &centreLine,
                 SplineCurve1D &radius,
                 std::map<std::string, std::pair<SplineCurve1D, bool>> &properties,
                 std::pair<size_t, size_t> resolution,
                 std::pair<real, real> range);
-        void generatePropertyGrid(
+        void gridCoordinates(
+                std::pair<size_t, size_t> resolution,
+                std::pair<real, real> range,
+                std::vector<real> &s,
+                std::vector<real> &phi);
+        std::vector<gmx::RVec> generateSurface(
                 SplineCurve3D &centreLine,
                 SplineCurve1D &radius,
-                std::pair<std::string, std::pair<SplineCurve1D, bool>> property,
-                RegularVertexGrid &grid);
+                const std::vector<real> &gridS,
+                const std::vector<real> &gridPhi);
 
         // auxiliary geometric functions: 
         gmx::RVec orthogonalVector(gmx::RVec vec);
@@ -183,6 +236,13 @@ class MolecularPathObjExporter
 
         // manipulate scalar property:
         void shiftAndScale(std::vector<real> &prop, bool divergent);
+
+        // parallelisation and timing utilities:
+        template<typename Function>
+        void parallelFor(size_t n, Function func);
+        void recordTiming(
+                const std::string &stage,
+                std::chrono::steady_clock::time_point start);
 };
 
 
@@ -26,6 +26,7 @@
 #define PDB_IO_HPP
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,7 @@
 #include <gromacs/topology/topology.h>
 #include <gromacs/utility/real.h>
 
+#include "io/compressed_file_write_stream.hpp"
 #include "statistics/summary_statistics.hpp"
 
 
@@ -42,12 +44,16 @@
 class PdbStructure
 {
     friend class PdbIo;
+    friend class PdbTrajectoryWriter;
 
     public:
 
         // create PDB file from topology:
         void fromTopology(const gmx::TopologyInformation &top);
 
+        // create PDB structure from atoms only:
+        void fromAtoms(const t_atoms &atoms);
+
         // 
         void setPoreFacing(
                 const std::vector<SummaryStatistics> &poreLining,
@@ -82,5 +88,50 @@ class PdbIo
 
 };
 
+
+/*!
+ * \brief Incrementally writes a multi-model PDB file with per-frame 
+ * attributes.
+ *
+ * Each call to writeModel() appends one MODEL record containing the given 
+ * atom coordinates, with the occupancy and B-factor fields of each atom set to
+ * the pore-lining and pore-facing flags of its residue. Output goes through a
+ * buffered stream, so that frames never accumulate in memory.
+ */
+class PdbTrajectoryWriter
+{
+    public:
+
+        // constructor:
+        PdbTrajectoryWriter(
+                const std::string &fileName,
+                const PdbStructure &structure);
+
+        // public interface for PDB export:
+        void writeModel(
+                const rvec *coords,
+                int numAtoms,
+                const matrix box,
+                const std::vector<real> &poreLining,
+                const std::vector<real> &poreFacing);
+        void close();
+
+        // getter functions:
+        int numModels() const;
+
+    private:
+
+        // output stream:
+        std::unique_ptr<CompressedFileWriteStream> pdb_;
+
+        // frame independent part of each atom record and residue indices:
+        std::vector<std::string> atomRecords_;
+        std::vector<int> residueIndices_;
+        int numModels_;
+
+        // internal utilities:
+        void writeString(const std::string &str);
+};
+
 #endif
 
@@ -0,0 +1,63 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef PLY_IO_HPP
+#define PLY_IO_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gromacs/math/vec.h>
+#include <gromacs/utility/real.h>
+
+#include "io/compressed_file_write_stream.hpp"
+
+
+/*!
+ * \brief Serialiser for writing triangle meshes to binary PLY files.
+ *
+ * The mesh is written in the binary little endian variant of the Stanford 
+ * PLY format, which is considerably more compact and faster to read than a 
+ * Wavefront OBJ file. Each vertex carries its position, optionally a normal
+ * vector, and an arbitrary number of named scalar properties, so that a 
+ * single set of vertices can hold several properties mapped onto the same 
+ * surface. All floating point data is written in single precision.
+ */
+class PlyExporter
+{
+    public:
+
+        // interface for export:
+        void write(
+                const std::string &fileName,
+                const std::vector<gmx::RVec> &vertices,
+                const std::vector<gmx::RVec> &normals,
+                const std::vector<std::pair<std::string, std::vector<real>>> &properties,
+                const std::vector<uint32_t> &triangles);
+};
+
+#endif
+
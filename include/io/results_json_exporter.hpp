@@ -25,16 +25,28 @@
 #ifndef RESULTS_JSON_EXPORTER_HPP
 #define RESULTS_JSON_EXPORTER_HPP
 
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "external/rapidjson/document.h"
+#include "external/rapidjson/writer.h"
 
 #include "analysis-setup/residue_information_provider.hpp"
+#include "io/compressed_file_write_stream.hpp"
+#include "statistics/block_average.hpp"
+#include "statistics/quantile_sketch.hpp"
 #include "statistics/summary_statistics.hpp"
 
 
 /*!
  * \brief Container class for facilitating the export of results to a JSON file.
+ *
+ * By default, the entire output is assembled in memory and written to file by
+ * write(). Alternatively, beginStreaming() and finishStreaming() can be used 
+ * to write the output incrementally, so that memory usage does not scale with
+ * the length of the trajectory (see beginStreaming() for details).
  */
 class ResultsJsonExporter
 {
@@ -43,15 +55,34 @@ class ResultsJsonExporter
         // constructor:
         ResultsJsonExporter();
 
+        // interface for streaming output:
+        void beginStreaming(std::string filename);
+        void finishStreaming();
+
         // interface for adding to output:
         void addPathwaySummary(
                 std::string name,
                 const SummaryStatistics &summary);
+        void addPathwayQuantiles(
+                std::string name,
+                const QuantileSketch &sketch);
+        void addPathwayStandardError(
+                std::string name,
+                const BlockAverage &blockAvg);
         void addSupportPoints(
                 const std::vector<real> &supportPoints);
         void addPathwayProfile(
                 std::string name,
                 const std::vector<SummaryStatistics> &profile);
+        void addPathwayProfile(
+                std::string name,
+                const std::vector<real> &profile);
+        void addPathwayProfileQuantiles(
+                std::string name,
+                const std::vector<QuantileSketch> &profile);
+        void addPathwayProfileStandardError(
+                std::string name,
+                const std::vector<BlockAverage> &profile);
         void addTimeStamps(
                 const std::vector<real> &timeStamps);
         void addPathwayScalarTimeSeries(
@@ -75,6 +106,16 @@ class ResultsJsonExporter
 
     private:
 
+        // helper functions for streaming mode:
+        bool isStreaming() const;
+        void enterSection(const std::string &name);
+        void leaveSection();
+
+        // helper function for checking profile consistency:
+        void checkProfileSize(
+                const std::string &name,
+                size_t size);
+
         // helper function to convert a string to a rapidjson value:
         inline rapidjson::Value toVal(const std::string &str);
 
@@ -83,6 +124,21 @@ class ResultsJsonExporter
 
         // overall output document:
         rapidjson::Document doc_;
+
+        // quantiles reported for quantile sketches:
+        std::map<std::string, real> quantileLevels_;
+
+        // sizes of time series for consistency checks:
+        bool hasTimeStamps_;
+        size_t numTimeStamps_;
+        bool hasGridPoints_;
+        size_t numGridPoints_;
+
+        // state of streaming output:
+        std::unique_ptr<CompressedFileWriteStream> stream_;
+        std::unique_ptr<rapidjson::Writer<CompressedFileWriteStream>> writer_;
+        std::string currentSection_;
+        std::vector<std::string> pendingSections_;
 };
 
 #endif
@@ -0,0 +1,116 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef RESULTS_NPZ_EXPORTER_HPP
+#define RESULTS_NPZ_EXPORTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+#include "io/compressed_file_write_stream.hpp"
+
+
+/*!
+ * Enum for results output formats.
+ */
+enum eOutputFormat {eOutputFormatJson, 
+                    eOutputFormatNpz, 
+                    eOutputFormatAll};
+
+
+/*!
+ * \brief Exports results as a columnar binary file in NumPy's NPZ format.
+ *
+ * An NPZ file is an uncompressed ZIP archive containing one NPY file per 
+ * array, where each NPY file consists of a short header describing data type
+ * and shape followed by the raw array data. This allows loading individual 
+ * arrays (e.g. a profile time series) with a single read rather than parsing 
+ * the entire JSON output. In Python, the file can be opened with 
+ * \c numpy.load(), in R e.g. with the \c RcppCNPy package.
+ *
+ * Arrays are written to file as they are added, so that only the (small) 
+ * ZIP central directory is kept in memory. The archive is completed by 
+ * calling close(). Data is stored in the precision of the \c real type, i.e.
+ * as single precision floating point numbers unless GROMACS was compiled in 
+ * double precision. Local file headers are padded so that the data of each 
+ * array starts at a 64 byte boundary in the file, which permits memory 
+ * mapping. As ZIP64 extensions are not implemented, the file size is limited 
+ * to 4 GiB.
+ */
+class ResultsNpzExporter
+{
+    public:
+
+        // constructor:
+        ResultsNpzExporter(
+                const std::string &fileName);
+
+        // interface for adding arrays:
+        void addArray(
+                const std::string &name,
+                const std::vector<real> &data);
+        void addArray(
+                const std::string &name,
+                const std::vector<std::vector<real>> &data);
+
+        // interface for completing file:
+        void close();
+
+    private:
+
+        // directory entry for each array in archive:
+        struct Entry
+        {
+            std::string name_;
+            uint32_t crc_;
+            uint32_t size_;
+            uint32_t offset_;
+        };
+
+        // output stream and archive directory:
+        CompressedFileWriteStream stream_;
+        std::vector<Entry> entries_;
+        uint64_t offset_;
+
+        // internal auxiliary functions:
+        void addEntry(
+                const std::string &name,
+                const std::vector<size_t> &shape,
+                const std::vector<const std::vector<real>*> &rows);
+        std::string npyHeader(
+                const std::vector<size_t> &shape) const;
+        void putUint16(
+                uint16_t value);
+        void putUint32(
+                uint32_t value);
+        void putBytes(
+                const char *data,
+                size_t size);
+};
+
+#endif
+
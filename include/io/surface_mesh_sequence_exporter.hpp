@@ -0,0 +1,106 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SURFACE_MESH_SEQUENCE_EXPORTER_HPP
+#define SURFACE_MESH_SEQUENCE_EXPORTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gromacs/math/vec.h>
+#include <gromacs/utility/real.h>
+
+#include "io/compressed_file_write_stream.hpp"
+
+
+/*!
+ * \brief Writes a sequence of pathway surface meshes with shared topology to 
+ * a compact binary file.
+ *
+ * All meshes are regular grids on a tube surface with a fixed number of 
+ * vertex rings along the centre line and vertices per ring (see 
+ * RegularVertexGrid), so that the triangulation is identical for every frame.
+ * It is therefore written only once at the beginning of the file, followed by
+ * one vertex buffer per frame. This is much smaller and faster to load than 
+ * a separate OBJ file per frame.
+ *
+ * The file layout is (all values little endian):
+ *
+ *  - 8 byte magic string \c CHAPMESH 
+ *  - uint32 format version
+ *  - uint32 number of vertex rings and uint32 number of vertices per ring
+ *  - uint32 number of triangles, followed by three uint32 zero-based vertex 
+ *    indices per triangle
+ *  - for each frame: float32 time stamp, followed by three float32 
+ *    coordinates (in Angstrom) per vertex
+ *
+ * Vertices are ordered ring by ring. The number of frames follows from the 
+ * file size, so that frames can be appended incrementally and an incomplete
+ * file (e.g. from an interrupted run) remains readable.
+ */
+class SurfaceMeshSequenceExporter
+{
+    public:
+
+        // constructor:
+        SurfaceMeshSequenceExporter(
+                const std::string &fileName,
+                size_t numLen,
+                size_t numPhi);
+
+        // interface for adding frames:
+        void addFrame(
+                real time,
+                const std::vector<gmx::RVec> &vertices);
+        size_t numFrames() const;
+
+        // interface for completing file:
+        void close();
+
+        // triangulation of regular grid:
+        static std::vector<uint32_t> triangles(
+                size_t numLen,
+                size_t numPhi);
+
+    private:
+
+        // output stream:
+        CompressedFileWriteStream stream_;
+
+        // mesh dimensions:
+        size_t numLen_;
+        size_t numPhi_;
+        size_t numFrames_;
+
+        // buffer for single precision frame data:
+        std::vector<float> frameBuffer_;
+
+        // internal auxiliary functions:
+        void putUint32(
+                uint32_t value);
+};
+
+#endif
+
@@ -28,6 +28,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -35,6 +36,8 @@
 #include <gromacs/math/vec.h>
 #include <gromacs/utility/real.h>   
 
+#include "io/compressed_file_write_stream.hpp"
+
 
 /*!
  * \brief Abstract data type for faces in Wavefront OBJ objects.
@@ -153,7 +156,7 @@ class WavefrontObjExporter
                    std::vector<std::vector<int>> faces);
 
         void write(std::string fileName,
-                   WavefrontObjObject object);
+                   const WavefrontObjObject &object);
 
 
     private:
@@ -161,17 +164,22 @@ class WavefrontObjExporter
         // internal temporaries:
         std::string crntMtlName_ = "";
 
-        // file handle:
-        std::fstream obj_;
+        // buffered output stream:
+        std::unique_ptr<CompressedFileWriteStream> obj_;
 
         // utilities for writing individual lines:
-        inline void writeComment(std::string comment);
-        inline void writeMaterialLibrary(std::string mtl);
-        inline void writeGroup(std::string group);
-        inline void writeObject(std::string object);
-        inline void writeVertex(std::pair<gmx::RVec, real> vertex);
-        inline void writeVertexNormal(gmx::RVec norm);
+        inline void writeComment(const std::string &comment);
+        inline void writeMaterialLibrary(const std::string &mtl);
+        inline void writeGroup(const std::string &group);
+        inline void writeObject(const std::string &object);
+        inline void writeVertex(const std::pair<gmx::RVec, real> &vertex);
+        inline void writeVertexNormal(const gmx::RVec &norm);
         inline void writeFace(const WavefrontObjFace &face);
+
+        // utilities for formatting into the output buffer:
+        inline void writeString(const std::string &str);
+        inline void writeInt(int value);
+        inline void writeReal(real value);
 };
 
 #endif
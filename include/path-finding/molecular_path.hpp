@@ -27,6 +27,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gromacs/math/vec.h>
@@ -80,6 +81,11 @@ class PathMappingParameters
  * The class also exposes several auxiliary functions such as samplePoints() or
  * sampleRadii() to provide access to the properties of the centre line curve
  * and radius spline directly.
+ *
+ * Summary quantities such as length(), minRadius(), volume(), sLo(), and 
+ * sHi() are computed once on construction and kept up to date by shift(), so
+ * that querying them is free. Accessors for the underlying splines and 
+ * original path data return references rather than copies.
  */
 class MolecularPath
 {
@@ -120,31 +126,32 @@ class MolecularPath
                 std::string name,
                 SplineCurve1D property,
                 bool divergent);
-        std::map<std::string, std::pair<SplineCurve1D, bool>> scalarProperties() const;
+        const std::map<std::string, std::pair<SplineCurve1D, bool>>& 
+                scalarProperties() const;
 
         // access original points:
-        std::vector<gmx::RVec> pathPoints();
-        std::vector<real> pathRadii();
+        const std::vector<gmx::RVec>& pathPoints() const;
+        const std::vector<real>& pathRadii() const;
 
         // access internal spline curves:
-        SplineCurve1D pathRadius();
-        SplineCurve3D centreLine();
+        const SplineCurve1D& pathRadius() const;
+        const SplineCurve3D& centreLine() const;
 
         // access aggregate properties of path:
         real length() const;
-        std::pair<real, real> minRadius();
-        real volume();
+        std::pair<real, real> minRadius() const;
+        real volume() const;
         real radius(real);
-        real sLo();
-        real sHi();
+        real sLo() const;
+        real sHi() const;
 
         // access properties of splines
-        std::vector<real> poreRadiusKnots() const;
-        std::vector<real> poreRadiusUniqueKnots() const;
-        std::vector<real> poreRadiusCtrlPoints() const;
-        std::vector<real> centreLineKnots() const;
-        std::vector<real> centreLineUniqueKnots() const;
-        std::vector<gmx::RVec> centreLineCtrlPoints() const;
+        const std::vector<real>& poreRadiusKnots() const;
+        ArrayView<real> poreRadiusUniqueKnots() const;
+        const std::vector<real>& poreRadiusCtrlPoints() const;
+        const std::vector<real>& centreLineKnots() const;
+        ArrayView<real> centreLineUniqueKnots() const;
+        const std::vector<gmx::RVec>& centreLineCtrlPoints() const;
 
         // sample points from centreline:
         std::vector<real> sampleArcLength(
@@ -184,6 +191,9 @@ class MolecularPath
         // mathematical constants:
         const real PI_ = std::acos(-1.0);
 
+        // computation of radius-derived properties:
+        void prepareRadiusProperties();
+
         // utilities for sampling functions:
         inline real sampleArcLenStep(
                 size_t nPoints, 
@@ -212,6 +222,8 @@ class MolecularPath
         real openingLo_;
         real openingHi_;
         real length_;
+        std::pair<real, real> minRadius_;
+        real volume_;
 };
 
 #endif
@@ -0,0 +1,104 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef BLOCK_AVERAGE_HPP
+#define BLOCK_AVERAGE_HPP
+
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+#include "statistics/summary_statistics.hpp"
+
+
+/*!
+ * \brief Estimates the standard error of the mean of a time-correlated 
+ * scalar variable without having to hold the entire time series in memory.
+ *
+ * Consecutive frames of a molecular dynamics trajectory are generally 
+ * correlated, so that the naive standard error \f$ \sigma/\sqrt{N} \f$ 
+ * underestimates the uncertainty of the mean. This class implements the 
+ * blocking method of Flyvbjerg and Petersen (1989) in an online fashion: the
+ * time series is repeatedly coarse-grained by averaging pairs of consecutive 
+ * values, where level \f$ k \f$ holds the means of blocks of \f$ 2^k \f$ 
+ * values. For each level, the variance of the block means is accumulated in a
+ * SummaryStatistics object, so that only \f$ O(\log N) \f$ memory is required.
+ *
+ * The standard error estimate at level \f$ k \f$ is
+ *
+ * \f[
+ *      \epsilon_k = \sqrt{\frac{\sigma_k^2}{n_k}}
+ * \f]
+ *
+ * where \f$ n_k \f$ is the number of blocks. This estimate increases with 
+ * block size until the blocks are effectively uncorrelated, at which point it
+ * reaches a plateau. The standardError() method returns the estimate at the
+ * first level where this plateau is reached, i.e. where the next level does 
+ * not increase the estimate by more than its statistical uncertainty 
+ * \f$ \epsilon_k / \sqrt{2(n_k - 1)} \f$. If no plateau is found, the largest
+ * estimate is returned as a conservative bound. Only levels with at least 
+ * minNumBlocks() blocks are considered.
+ *
+ * As for SummaryStatistics, infinite values are skipped.
+ */
+class BlockAverage
+{
+    public:
+
+        // constructor:
+        BlockAverage();
+
+        // getter methods:
+        real mean() const;
+        real standardError() const;
+        real standardError(
+                size_t level) const;
+        size_t numLevels() const;
+        int num() const;
+        static int minNumBlocks();
+
+        // updating methods:
+        void update(
+                const real newValue);
+        static void updateMultiple(
+                std::vector<BlockAverage> &blockAvg,
+                const std::vector<real> &newValues);
+
+    private:
+
+        // statistics of block means at each level:
+        std::vector<SummaryStatistics> levels_;
+
+        // incomplete block waiting for its partner at each level:
+        std::vector<real> pending_;
+        std::vector<bool> hasPending_;
+
+        // internal auxiliary functions:
+        void addToLevel(
+                size_t level, 
+                real value);
+};
+
+#endif
+
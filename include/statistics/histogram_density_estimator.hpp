@@ -45,6 +45,14 @@
  * LinearSplineInterp1D and the result is returned as a SplineCurve1D object.
  * Linear rather than higher order interpolation is used to avoid artifacts
  * where the interpolation method introduces locally negative densities.
+ *
+ * If a fixed histogram range is specified with setRange(), the estimator 
+ * operates in streaming mode. Samples are then assigned to their bin by 
+ * direct index computation, which does not require the sample to be sorted
+ * and scales linearly with the number of samples. In this mode, samples can 
+ * also be accumulated over several calls to accumulate() (e.g. over several 
+ * trajectory frames) and the time-averaged density can be obtained from 
+ * accumulatedEstimate().
  */
 class HistogramDensityEstimator : public AbstractDensityEstimator
 {
@@ -57,6 +65,8 @@ class HistogramDensityEstimator : public AbstractDensityEstimator
                 HistogramDensityEstimatorDensityTest);
     FRIEND_TEST(HistogramDensityEstimatorTest,
                 HistogramDensityEstimatorEstimateTest);
+    FRIEND_TEST(HistogramDensityEstimatorTest,
+                HistogramDensityEstimatorFixedRangeBinningTest);
 
     public:
        
@@ -71,12 +81,28 @@ class HistogramDensityEstimator : public AbstractDensityEstimator
         virtual void setParameters(
                 const DensityEstimationParameters &params);
         void setBinWidth(real binWidth);
+        void setRange(real rangeLo, real rangeHi);
+
+        // streaming interface for accumulating samples over several calls:
+        void accumulate(const std::vector<real> &samples);
+        SplineCurve1D accumulatedEstimate() const;
+        void resetAccumulator();
+        size_t numAccumulated() const;
 
     private:
 
         // internal parameters:
         real binWidth_;
 
+        // fixed histogram range for streaming mode:
+        bool rangeIsSet_;
+        real rangeLo_;
+        real rangeHi_;
+
+        // accumulated counts in streaming mode:
+        std::vector<size_t> counts_;
+        size_t numAccumulated_;
+
         // auxiliary functions:
         std::vector<real> createBreaks(
                 const std::vector<real> &samples);
@@ -85,6 +111,13 @@ class HistogramDensityEstimator : public AbstractDensityEstimator
         std::vector<real> calculateDensity(
                 const std::vector<real> &samples,
                 const std::vector<real> &breaks);
+        size_t numFixedRangeBins() const;
+        size_t binFixedRange(
+                const std::vector<real> &samples,
+                std::vector<size_t> &counts) const;
+        SplineCurve1D fixedRangeDensity(
+                const std::vector<size_t> &counts,
+                size_t numSamples) const;
     
 };
 
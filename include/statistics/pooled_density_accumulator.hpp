@@ -0,0 +1,102 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef POOLED_DENSITY_ACCUMULATOR_HPP
+#define POOLED_DENSITY_ACCUMULATOR_HPP
+
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+
+/*!
+ * \brief Accumulates a binned density estimate by pooling samples over 
+ * several frames.
+ *
+ * This class maintains a single running histogram on a fixed grid of bins of
+ * width \f$ h \f$, where bin \f$ k \f$ covers the interval 
+ * \f$ [kh, (k+1)h) \f$. Samples from each frame are added via addFrame() and
+ * the bin range is extended automatically to cover all samples seen so far.
+ * Memory requirements therefore scale with the size of the grid rather than
+ * with the number of frames or samples.
+ *
+ * Each sample can optionally carry a weight. Two estimates can be obtained 
+ * from the accumulated bins, both of which are interpolated linearly between
+ * bin centres and are zero outside the accumulated range. The 
+ * probabilityDensity() is normalised to unit integral, while the 
+ * frameAveragedDensity() is the accumulated weight per unit length divided by
+ * the number of frames. If the weight of each sample is the inverse of the 
+ * local cross-sectional area, the latter is the time-averaged number density
+ * of the sampled particles.
+ */
+class PooledDensityAccumulator
+{
+    public:
+
+        // constructor:
+        PooledDensityAccumulator();
+
+        // setter methods:
+        void setBinWidth(real binWidth);
+
+        // accumulation of samples:
+        void addFrame(
+                const std::vector<real> &samples);
+        void addFrame(
+                const std::vector<real> &samples,
+                const std::vector<real> &weights);
+        void reset();
+
+        // getter methods:
+        size_t numFrames() const;
+        real totalWeight() const;
+
+        // density estimates:
+        std::vector<real> probabilityDensity(
+                const std::vector<real> &evalPoints) const;
+        std::vector<real> frameAveragedDensity(
+                const std::vector<real> &evalPoints) const;
+
+    private:
+
+        // internal parameters:
+        real binWidth_;
+
+        // accumulated weight per bin:
+        std::vector<real> bins_;
+        long int idxOffset_;
+        size_t numFrames_;
+        real totalWeight_;
+
+        // auxiliary functions:
+        void extendBins(
+                long int idxLo, 
+                long int idxHi);
+        std::vector<real> interpolateBins(
+                const std::vector<real> &evalPoints,
+                real norm) const;
+};
+
+#endif
+
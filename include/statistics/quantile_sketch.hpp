@@ -0,0 +1,103 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef QUANTILE_SKETCH_HPP
+#define QUANTILE_SKETCH_HPP
+
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+
+/*!
+ * \brief Estimates quantiles of a scalar variable without having to hold an 
+ * entire dataset in memory.
+ *
+ * This class implements the merging t-digest of Dunning and Ertl (2019). The 
+ * dataset is summarised by a sorted set of centroids (i.e. a mean value and a
+ * weight), where the size of each centroid is limited by the scale function
+ *
+ * \f[
+ *      k(q) = \frac{\delta}{2\pi} \arcsin(2q - 1)
+ * \f]
+ *
+ * such that centroids near the tails of the distribution are small and 
+ * quantiles close to zero or one are estimated accurately. The compression
+ * parameter \f$ \delta \f$ bounds the number of centroids and hence the 
+ * memory requirement independent of the number of samples.
+ *
+ * New values are added with update() and are collected in a buffer which is
+ * merged into the centroids once full. Quantiles are obtained by linear 
+ * interpolation between centroids using quantile(). Two sketches can be 
+ * combined with merge(). As for SummaryStatistics, infinite values (and NaN)
+ * are skipped.
+ */
+class QuantileSketch
+{
+    public:
+
+        // constructor:
+        QuantileSketch(
+                real compression = 100.0);
+
+        // getter methods:
+        real quantile(
+                real q) const;
+        int num() const;
+
+        // updating methods:
+        void update(
+                const real newValue);
+        static void updateMultiple(
+                std::vector<QuantileSketch> &sketch,
+                const std::vector<real> &newValues);
+        void merge(
+                const QuantileSketch &other);
+
+        // manipulation methods:
+        void shift(
+                const real shift);
+
+    private:
+
+        // internal parameters:
+        real compression_;
+        size_t bufferSize_;
+
+        // centroids and buffer of unmerged values:
+        std::vector<std::pair<real, real>> centroids_;
+        std::vector<std::pair<real, real>> buffer_;
+
+        // data range and total weight:
+        real min_;
+        real max_;
+        int num_;
+
+        // internal auxiliary functions:
+        void compress();
+        inline real scaleFunction(real q) const;
+};
+
+#endif
+
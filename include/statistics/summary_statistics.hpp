@@ -53,9 +53,16 @@
  * the update() method, all returned statistics are capped at the minimum and 
  * maximum real number, i.e. no infinity is ever returned to allow 
  * compatibility with JSON.
+ *
+ * Two SummaryStatistics objects accumulated over disjoint datasets can be
+ * combined using merge(), which employs the parallel algorithm due to Chan et
+ * al. (1979). This allows partial statistics to be accumulated independently
+ * (e.g. over different parts of a trajectory) and reduced afterwards.
  */
 class SummaryStatistics
 {
+    friend class SummaryStatisticsVector;
+
     public:
 
         // constructor and destructor:
@@ -75,6 +82,8 @@ class SummaryStatistics
         static void updateMultiple(
                 std::vector<SummaryStatistics> &stat,
                 const std::vector<real> &newValues);
+        void merge(
+                const SummaryStatistics &other);
 
         // manipulation methods:
         void shift(
@@ -82,6 +91,14 @@ class SummaryStatistics
 
     private:
 
+        // constructor from internal state:
+        SummaryStatistics(
+                real min,
+                real max,
+                real mean,
+                real sumSquaredMeanDiff,
+                int num);
+
         // summary statistics updated by this class:
         real min_;
         real max_;
@@ -0,0 +1,86 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef SUMMARY_STATISTICS_VECTOR_HPP
+#define SUMMARY_STATISTICS_VECTOR_HPP
+
+#include <vector>
+
+#include "gromacs/utility/real.h"
+
+#include "statistics/summary_statistics.hpp"
+
+
+/*!
+ * \brief Collects summary statistics of a vector-valued variable, such as a 
+ * profile evaluated at a fixed set of support points.
+ *
+ * This class is equivalent to a std::vector of SummaryStatistics objects, 
+ * but stores each statistic in a separate contiguous array (structure of 
+ * arrays). This allows update() to process an entire profile in a single 
+ * loop without branches, which the compiler can vectorise. As for 
+ * SummaryStatistics, infinite values are skipped for the element in question.
+ *
+ * Individual elements can be retrieved as SummaryStatistics objects via at().
+ * Two objects of equal size can be combined using merge(), which applies 
+ * SummaryStatistics::merge() elementwise.
+ */
+class SummaryStatisticsVector
+{
+    public:
+
+        // constructor:
+        SummaryStatisticsVector(
+                size_t size = 0);
+
+        // getter methods:
+        size_t size() const;
+        SummaryStatistics at(
+                size_t i) const;
+        std::vector<SummaryStatistics> summaries() const;
+        std::vector<real> mean() const;
+        std::vector<real> sd() const;
+
+        // updating methods:
+        void update(
+                const std::vector<real> &newValues);
+        void merge(
+                const SummaryStatisticsVector &other);
+
+        // manipulation methods:
+        void shift(
+                const real shift);
+
+    private:
+
+        // summary statistics updated by this class:
+        std::vector<real> min_;
+        std::vector<real> max_;
+        std::vector<real> mean_;
+        std::vector<real> sumSquaredMeanDiff_;
+        std::vector<int> num_;
+};
+
+#endif
+
@@ -26,6 +26,7 @@
 #define TRAJECTORYANALYSIS_HPP
 
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -35,12 +36,15 @@
 #include "analysis-setup/residue_information_provider.hpp"
 
 #include "io/pdb_io.hpp"
+#include "io/results_npz_exporter.hpp"
+#include "io/surface_mesh_sequence_exporter.hpp"
 
 #include "path-finding/abstract_path_finder.hpp"
 #include "path-finding/molecular_path.hpp"
 #include "path-finding/vdw_radius_provider.hpp"
 
 #include "statistics/abstract_density_estimator.hpp"
+#include "statistics/pooled_density_accumulator.hpp"
 
 using namespace gmx;
 
@@ -89,6 +93,9 @@ class ChapTrajectoryAnalysis : public TrajectoryAnalysisModule
         std::string outputBaseFileName_;
         std::string outputJsonFileName_;
         std::string outputPdbFileName_;
+        std::string outputNpzFileName_;
+        std::string outputMeshFileName_;
+        std::string outputPdbTrajectoryFileName_;
 
         
         // user specified selections:
@@ -129,6 +136,15 @@ class ChapTrajectoryAnalysis : public TrajectoryAnalysisModule
         real outputGridSampleDist_;
         real outputCorrectionThreshold_;
         bool outputDetailed_;
+        real outputDetailedPrecision_;
+        eOutputFormat outputFormat_;
+        bool outputCompress_;
+        int outputFlushInterval_;
+        int outputMeshStride_;
+        int outputPdbStride_;
+        bool outputPly_;
+        std::unique_ptr<SurfaceMeshSequenceExporter> outputMeshSequence_;
+        std::unique_ptr<PdbTrajectoryWriter> outputPdbTrajectory_;
         PdbStructure outputStructure_;
 
 
@@ -178,6 +194,7 @@ class ChapTrajectoryAnalysis : public TrajectoryAnalysisModule
         real deBandWidth_;
         real deBandWidthScale_;
         real deEvalRangeCutoff_;
+        PooledDensityAccumulator solventDensityPool_;
 
 
         // hydrophobicity profile parameters:
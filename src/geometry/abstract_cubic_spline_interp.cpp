@@ -49,6 +49,11 @@ AbstractCubicSplineInterp::~AbstractCubicSplineInterp()
  * This function assembles the nonzero entries of the system matrix occurring
  * in spline interpolation. Currently, only Hermite boundary conditions are 
  * implemented.
+ *
+ * Each row only depends on the basis functions that are nonzero at a single 
+ * support point, so these are evaluated as a sparse basis set. This avoids
+ * evaluating each matrix element by an individual Cox-de Boor recursion, 
+ * which would scale with the total number of knots.
  */
 void
 AbstractCubicSplineInterp::assembleDiagonals(std::vector<real> &knotVector,
@@ -62,9 +67,8 @@ AbstractCubicSplineInterp::assembleDiagonals(std::vector<real> &knotVector,
     int nDat = x.size();
     int nSys = nDat + 2;
 
-    // initialise basis spline (derivative) functor:
-    BasisSpline B;
-    BasisSplineDerivative D;
+    // initialise basis spline set functor:
+    BSplineBasisSet B;
 
     // handle boundary conditions:
     if( bc == eSplineInterpBoundaryHermite )
@@ -74,12 +78,14 @@ AbstractCubicSplineInterp::assembleDiagonals(std::vector<real> &knotVector,
         real xHi = x.back();
 
         // lower boundary:
-        mainDiag[0] = D(knotVector, degree_, 0, xLo, firstOrderDeriv);
-        superDiag[0] = D(knotVector, degree_, 1, xLo, firstOrderDeriv);
+        SparseBasis basis = B(xLo, knotVector, degree_, firstOrderDeriv);
+        mainDiag[0] = sparseBasisElement(basis, 0);
+        superDiag[0] = sparseBasisElement(basis, 1);
  
         // higher boundary:
-        mainDiag[nSys - 1] = D(knotVector, degree_, nSys - 1, xHi, firstOrderDeriv);
-        subDiag[nSys - 2] = D(knotVector, degree_, nSys - 2, xHi, firstOrderDeriv);
+        basis = B(xHi, knotVector, degree_, firstOrderDeriv);
+        mainDiag[nSys - 1] = sparseBasisElement(basis, nSys - 1);
+        subDiag[nSys - 2] = sparseBasisElement(basis, nSys - 2);
     }
     else if( bc == eSplineInterpBoundaryNatural )
     {
@@ -92,23 +98,32 @@ AbstractCubicSplineInterp::assembleDiagonals(std::vector<real> &knotVector,
         std::abort();
     }
 
-    // assemble subdiagonal:
+    // assemble interpolation conditions row by row:
     for(int i = 0; i < nDat; i++)
     {
-        subDiag[i] = B(knotVector, degree_, i, x.at(i));
+        SparseBasis basis = B(x[i], knotVector, degree_);
+        subDiag[i] = sparseBasisElement(basis, i);
+        mainDiag[i + 1] = sparseBasisElement(basis, i + 1);
+        superDiag[i + 1] = sparseBasisElement(basis, i + 2);
     }
+}
 
-    // assemble main diagonal:
-    for(int i = 0; i < nDat; i++)
-    {
-        mainDiag[i + 1] = B(knotVector, degree_, i+1, x.at(i));
-    }
 
-    // assemble superdiagonal:
-    for(int i = 1; i < nSys - 1; i++)
+/*!
+ * Returns the element of a sparse basis set with the given index, which is 
+ * zero if the element is not contained in the sparse basis.
+ */
+real
+AbstractCubicSplineInterp::sparseBasisElement(
+        const SparseBasis &basis, 
+        unsigned int idx)
+{
+    auto it = basis.find(idx);
+    if( it == basis.end() )
     {
-        superDiag[i] = B(knotVector, degree_, i + 1, x.at(i - 1));
+        return 0.0;
     }
+    return it -> second;
 }
 
 
@@ -24,10 +24,23 @@
 
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 #include "geometry/abstract_spline_curve.hpp"
 
 
+/*!
+ * Constructor. Only initialises the uniform knot spacing flag, all other 
+ * members are set by the derived classes.
+ */
+AbstractSplineCurve::AbstractSplineCurve()
+    : uniformKnots_(false)
+    , knotSpacingInv_(0.0)
+{
+
+}
+
+
 /*!
  * Getter method for spline curve degree.
  */
@@ -58,30 +71,36 @@ AbstractSplineCurve::nKnots() const
 }
 
 
+/*!
+ * Returns true if the unique knots of this curve are uniformly spaced, in 
+ * which case knot intervals are found by index arithmetic.
+ */
+bool
+AbstractSplineCurve::hasUniformKnots() const
+{
+    return uniformKnots_;
+}
+
+
 /*!
  * Getting method for the knot vector.
  */
-std::vector<real>
+const std::vector<real>&
 AbstractSplineCurve::knotVector() const
 {
-    return knots_;
+    return knots_.vector();
 }
 
 
 /*!
  * Getter method that returns that set of unique knots, i.e. the knot vector
- * without the repeated knots at start and end.
+ * without the repeated knots at start and end. The returned view refers to 
+ * the knot vector of this curve and does not copy any data.
  */
-std::vector<real>
+ArrayView<real>
 AbstractSplineCurve::uniqueKnots() const
 {
-    // extract unique knots from knot vector:
-    std::vector<real> uniqueKnots(
-            knots_.begin() + degree_,
-            knots_.end() - degree_);
-
-    // return unique knots:
-    return uniqueKnots;
+    return knots_.view(degree_, knots_.size() - degree_);
 }
 
 
@@ -95,10 +114,87 @@ AbstractSplineCurve::uniqueKnots() const
 void
 AbstractSplineCurve::shift(const gmx::RVec &shift)
 {
-    for(auto it = knots_.begin(); it != knots_.end(); it++)
+    // knots are shared with copies of this curve, so create new knot vector:
+    std::vector<real> shiftedKnots(knots_.begin(), knots_.end());
+    for(auto it = shiftedKnots.begin(); it != shiftedKnots.end(); it++)
     {
         *it -= shift[SS];
     }
+    setKnots(std::move(shiftedKnots));
+}
+
+
+/*!
+ * Sets the knot vector and checks whether the knots are uniformly spaced. 
+ * Derived classes should always use this method rather than assigning to 
+ * knots_ directly.
+ */
+void
+AbstractSplineCurve::setKnots(SharedArray<real> knots)
+{
+    knots_ = std::move(knots);
+    detectUniformKnots();
+}
+
+
+/*!
+ * Checks whether the knot vector is clamped (i.e. the first and last knot are
+ * repeated degree + 1 times) and whether the unique knots in between are 
+ * uniformly spaced. In this case the inverse knot spacing is stored for use 
+ * in findInterval().
+ *
+ * The tolerance on the spacing can be generous, as findInterval() corrects
+ * the computed index against the actual knots. It only needs to be tight 
+ * enough that this correction takes at most a few steps.
+ */
+void
+AbstractSplineCurve::detectUniformKnots()
+{
+    const real relTol = 1e-3;
+
+    // assume nonuniform knots until proven otherwise:
+    uniformKnots_ = false;
+    knotSpacingInv_ = 0.0;
+
+    // need at least one nonempty interval:
+    int nUnique = static_cast<int>(knots_.size()) - 2*degree_;
+    if( degree_ < 0 || nUnique < 2 )
+    {
+        return;
+    }
+
+    // knot vector must be clamped:
+    for(int i = 0; i < degree_; i++)
+    {
+        if( knots_[i] != knots_[degree_] || 
+            knots_[knots_.size() - 1 - i] != knots_[knots_.size() - 1 - degree_] )
+        {
+            return;
+        }
+    }
+
+    // spacing between unique knots:
+    real first = knots_[degree_];
+    real last = knots_[degree_ + nUnique - 1];
+    real spacing = (last - first)/(nUnique - 1);
+    if( !(spacing > 0.0) )
+    {
+        return;
+    }
+
+    // check that all unique knots are on uniform grid:
+    for(int i = 1; i < nUnique - 1; i++)
+    {
+        real dev = knots_[degree_ + i] - (first + i*spacing);
+        if( std::abs(dev) > relTol*spacing )
+        {
+            return;
+        }
+    }
+
+    // knots are uniform:
+    uniformKnots_ = true;
+    knotSpacingInv_ = 1.0/spacing;
 }
 
 
@@ -109,10 +205,42 @@ AbstractSplineCurve::shift(const gmx::RVec &shift)
  *  identical to the final knot is treated as a special case and the interval
  *  is found such that knot[idx] <= t <= knot[idx + 1], i.e. with inclusive 
  *  upper boundary.
+ *
+ *  If the knots are uniformly spaced and t lies within the knot range, the 
+ *  interval index is computed directly as floor((t - t0)/h) and then 
+ *  corrected against the actual knots to guard against rounding. The result 
+ *  is identical to the binary search used otherwise.
  */
 int
-AbstractSplineCurve::findInterval(const real &evalPoint)
+AbstractSplineCurve::findInterval(const real &evalPoint) const
 {
+    // fast path for uniform knots:
+    if( uniformKnots_ && 
+        evalPoint >= knots_.front() && 
+        evalPoint <= knots_.back() )
+    {
+        // first and last nonempty interval:
+        int idxFirst = degree_;
+        int idxLast = static_cast<int>(knots_.size()) - degree_ - 2;
+
+        // interval index from uniform spacing:
+        int idx = idxFirst + static_cast<int>(
+                (evalPoint - knots_.front())*knotSpacingInv_);
+        idx = std::max(idxFirst, std::min(idx, idxLast));
+
+        // correct for rounding errors:
+        while( idx < idxLast && knots_[idx + 1] <= evalPoint )
+        {
+            idx++;
+        }
+        while( idx > idxFirst && knots_[idx] > evalPoint )
+        {
+            idx--;
+        }
+
+        return idx;
+    }
+
     // initialise index:
     int idx = -1;
 
@@ -120,18 +248,20 @@ AbstractSplineCurve::findInterval(const real &evalPoint)
     if( evalPoint == knots_.back() )
     {
         // find iterator to interval bound:
-        std::vector<real>::iterator it_lo = std::lower_bound(knots_.begin(), 
-                                                             knots_.end(), 
-                                                             evalPoint);
+        SharedArray<real>::const_iterator it_lo = std::lower_bound(
+                knots_.begin(), 
+                knots_.end(), 
+                evalPoint);
         // calculate interval index:
         idx = it_lo - knots_.begin() - 1;
     }
     else
     {
         // find iterator to interval point:
-        std::vector<real>::iterator it_hi = std::upper_bound(knots_.begin(), 
-                                                             knots_.end(), 
-                                                             evalPoint);
+        SharedArray<real>::const_iterator it_hi = std::upper_bound(
+                knots_.begin(), 
+                knots_.end(), 
+                evalPoint);
 
         // calculate interval index:
         idx = it_hi - knots_.begin() - 1;
@@ -141,3 +271,30 @@ AbstractSplineCurve::findInterval(const real &evalPoint)
     return idx;
 }
 
+
+
+/*!
+ * Evaluates the B-spline basis (or its derivative) of this curve at the given
+ * evaluation point. For uniformly spaced knots, the knot span is found by 
+ * findInterval() and handed to the basis functor, which avoids the binary 
+ * search over the knot vector.
+ */
+SparseBasis
+AbstractSplineCurve::evaluateBasis(const real &eval, unsigned int deriv)
+{
+    // knot span known in constant time:
+    if( uniformKnots_ )
+    {
+        return B_(eval, knots_, degree_, deriv, findInterval(eval));
+    }
+
+    // general case:
+    if( deriv == 0 )
+    {
+        return B_(eval, knots_, degree_);
+    }
+    else
+    {
+        return B_(eval, knots_, degree_, deriv);
+    }
+}
@@ -85,6 +85,32 @@ BSplineBasisSet::operator()(
         const std::vector<real> &knots,
         unsigned int degree,
         unsigned int deriv)
+{
+    // find knot span for evalution point:
+    size_t knotSpanIdx = findKnotSpan(eval, knots, degree);
+
+    // evaluate basis (derivatives) in this span:
+    return this -> operator()(eval, knots, degree, deriv, knotSpanIdx);
+}
+
+
+/*!
+ * Evaluates the B-spline basis functions or their derivatives at an 
+ * evaluation point for which the knot span index is already known, so that 
+ * the binary search in findKnotSpan() can be skipped. This is used by spline
+ * curves with uniformly spaced knots, which can compute the knot span by 
+ * index arithmetic. The caller is responsible for ensuring that 
+ * \f$ t_j \leq x < t_{j+1} \f$ holds for the given knot span index 
+ * \f$ j \f$ (with the usual exception at the final knot). The return value 
+ * is the same as for the other evaluation operators.
+ */
+SparseBasis
+BSplineBasisSet::operator()(
+        real eval,
+        const std::vector<real> &knots,
+        unsigned int degree,
+        unsigned int deriv,
+        size_t knotSpanIdx)
 {
     // number of basis elements:
     unsigned int nBasis = knots.size() - degree - 1;
@@ -104,8 +130,23 @@ BSplineBasisSet::operator()(
         return basisSet;
     }
 
-    // find knot span for evalution point:
-    unsigned int knotSpanIdx = findKnotSpan(eval, knots, degree);
+    // no derivative required:
+    if( deriv == 0 )
+    {
+        // calculate the nonzero basis elements:
+        std::vector<real> nonzeroBasisElements = evaluateNonzeroBasisElements(
+                eval,
+                knots,
+                degree,
+                knotSpanIdx);
+
+        // embed in sparse basis vector with appropriate indexing:
+        for(size_t i = 0; i < nonzeroBasisElements.size(); i++)
+        {
+            basisSet[i + knotSpanIdx - degree] = nonzeroBasisElements[i];
+        }
+        return basisSet;
+    }
 
     // find nonzero basis elements and their derivatives:
     std::vector<std::vector<real>> nonzeroBasisElements;
@@ -26,8 +26,6 @@
 #include <stdexcept>
 #include <string>
 
-#include <lapacke.h>
-
 #include "geometry/basis_spline.hpp"
 #include "geometry/cubic_spline_interp_1D.hpp"
 
@@ -58,8 +56,8 @@ CubicSplineInterp1D::~CubicSplineInterp1D()
  *      s(x_i) = f(x_i)
  *
  * Currently only Hermite endpoint conditions are implemented. The relevant 
- * linear system is solved via Gaussian elimination (using LAPACKE) and the 
- * result is returned as a spline curve object.
+ * linear system is solved via Gaussian elimination in the interpolation 
+ * workspace and the result is returned as a spline curve object.
  */
 SplineCurve1D
 CubicSplineInterp1D::interpolate(std::vector<real> &x,
@@ -86,65 +84,40 @@ CubicSplineInterp1D::interpolate(std::vector<real> &x,
     size_t nDat = x.size();
     size_t nSys = nDat + 2;
 
-    // allocate memory for lhs matrix diagonal entries:
-    real subDiag[nSys - 1];
-    real mainDiag[nSys];
-    real superDiag[nSys - 1];
+    // number of right hand sides is one:
+    size_t nRhs = 1;
+
+    // allocate memory for lhs matrix and rhs in workspace:
+    workspace_.resize(nSys, nRhs);
 
     // assemble the matrix diagonals:
     assembleDiagonals(knotVector,
                       x,
-                      subDiag,
-                      mainDiag,
-                      superDiag,
+                      workspace_.subDiag(),
+                      workspace_.mainDiag(),
+                      workspace_.superDiag(),
                       bc);
 
 
     // Assemble Right Hand Side Vector
     //-------------------------------------------------------------------------
 
-    // number of right hand sides is one:
-    size_t nRhs = 1;
- 
-    // initialise right hand side:
-    real rhsVec[nSys * nRhs];
-
     // assemble the rhs vector:
-    assembleRhs(x, f, rhsVec, bc);
+    assembleRhs(x, f, workspace_.rhs(), bc);
 
     
     // Solve System
     //-------------------------------------------------------------------------
   
     // solve tridiagonal system by Gaussian elimination:
-    int status = LAPACKE_sgtsv(LAPACK_COL_MAJOR,
-                               nSys, 
-                               nRhs,
-                               subDiag, 
-                               mainDiag, 
-                               superDiag, 
-                               rhsVec,
-                               nSys);
-
-    // handle solver failure:
-    if( status != 0 )
-    {
-        throw std::runtime_error("Could not solve tridiagonal system in 1D "
-                                 "interpolation. " 
-                                 "LAPACK error code: "+std::to_string(status));
-    } 
+    workspace_.solve();
 
 
     // Prepare Output
     //-------------------------------------------------------------------------
 
     // create vector of control points:
-    std::vector<real> ctrlPoints;
-    ctrlPoints.resize(nSys);
-    for(size_t i = 0; i < nSys; i++)
-    {
-        ctrlPoints.at(i) = rhsVec[i];
-    }
+    std::vector<real> ctrlPoints(workspace_.rhs(), workspace_.rhs() + nSys);
 
     // create spline curve object:
     SplineCurve1D Spl(degree_, knotVector, ctrlPoints);
@@ -166,3 +139,88 @@ CubicSplineInterp1D::operator()(std::vector<real> &x,
     return interpolate(x, f, bc);
 }
 
+
+/*!
+ * Interpolates several functions sampled at the same points x, where each
+ * element of f holds the function values of one profile. The tridiagonal 
+ * system is assembled once and solved for all profiles simultaneously. 
+ * Returns one spline curve per profile, all of which have the same knot 
+ * vector.
+ */
+std::vector<SplineCurve1D>
+CubicSplineInterp1D::interpolate(
+        std::vector<real> &x,
+        std::vector<std::vector<real>> &f,
+        eSplineInterpBoundaryCondition bc)
+{
+    // sanity check:
+    for(auto &profile : f)
+    {
+        if( x.size() != profile.size() )
+        {
+            throw std::logic_error("Interpolation input x and f vectors must "
+                                   "be of same size!");
+        }
+    }
+
+    // set boundary condition:
+    bc_ = bc;
+
+    // generate knot vector:
+    std::vector<real> knotVector = prepareKnotVector(x);
+
+    // dimension of system and number of right hand sides:
+    size_t nDat = x.size();
+    size_t nSys = nDat + 2;
+    size_t nRhs = f.size();
+
+    // allocate memory for lhs matrix and rhs in workspace:
+    workspace_.resize(nSys, nRhs);
+
+    // assemble the matrix diagonals:
+    assembleDiagonals(knotVector,
+                      x,
+                      workspace_.subDiag(),
+                      workspace_.mainDiag(),
+                      workspace_.superDiag(),
+                      bc);
+
+    // assemble one rhs vector per profile:
+    for(size_t j = 0; j < nRhs; j++)
+    {
+        assembleRhs(x, f[j], workspace_.rhs(j), bc);
+    }
+
+    // solve tridiagonal system for all profiles at once:
+    workspace_.solve();
+
+    // create spline curve objects, all referring to the same knots:
+    SharedArray<real> sharedKnots(std::move(knotVector));
+    std::vector<SplineCurve1D> splines;
+    splines.reserve(nRhs);
+    for(size_t j = 0; j < nRhs; j++)
+    {
+        std::vector<real> ctrlPoints(
+                workspace_.rhs(j), 
+                workspace_.rhs(j) + nSys);
+        splines.push_back(
+                SplineCurve1D(degree_, sharedKnots, std::move(ctrlPoints)));
+    }
+
+    return splines;
+}
+
+
+/*!
+ * Interpolation interface for several profiles conveniently defined as 
+ * operator.
+ */
+std::vector<SplineCurve1D>
+CubicSplineInterp1D::operator()(
+        std::vector<real> &x,
+        std::vector<std::vector<real>> &f,
+        eSplineInterpBoundaryCondition bc)
+{
+    return interpolate(x, f, bc);
+}
+
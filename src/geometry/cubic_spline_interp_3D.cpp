@@ -26,8 +26,6 @@
 #include <stdexcept>
 #include <string>
 
-#include <lapacke.h>
-
 #include "geometry/basis_spline.hpp"
 #include "geometry/cubic_spline_interp_3D.hpp"
 
@@ -106,66 +104,35 @@ CubicSplineInterp3D::interpolate(std::vector<real> &param,
     size_t nDat = points.size();
     size_t nSys = nDat + 2;
 
-    // allocate system matrix:
-    real subDiag[nSys - 1];
-    real mainDiag[nSys];
-    real superDiag[nSys - 1];
+    // one right hand side per spatial dimension:
+    size_t nRhs = 3;
+
+    // allocate system matrix and right hand sides in workspace:
+    workspace_.resize(nSys, nRhs);
 
     // assemble the matrix diagonals:
     assembleDiagonals(knotVector,
                       param,
-                      subDiag,
-                      mainDiag,
-                      superDiag,
+                      workspace_.subDiag(),
+                      workspace_.mainDiag(),
+                      workspace_.superDiag(),
                       bc);
 
 
     // Assemble Right Hand Side Vector
     //-------------------------------------------------------------------------
 
-    // number of right hand sides is one:
-    size_t nRhs = 3;
-
-    // allocate right hand side:
-    real rhsMat[nSys * nRhs];
-    real rhsX[nSys];
-    real rhsY[nSys];
-    real rhsZ[nSys];
-
-    // assemble the rhs vectors:
-    assembleRhs(param, x, rhsX, bc);
-    assembleRhs(param, y, rhsY, bc);
-    assembleRhs(param, z, rhsZ, bc);
-
-    // assemble rhs vectors into matrix:
-    for(size_t i = 0; i < nSys; i++)
-    {
-        rhsMat[i] = rhsX[i];
-        rhsMat[i + nSys] = rhsY[i];
-        rhsMat[i + 2*nSys] = rhsZ[i];
-    }
+    // assemble the rhs vectors directly as columns of rhs matrix:
+    assembleRhs(param, x, workspace_.rhs(XX), bc);
+    assembleRhs(param, y, workspace_.rhs(YY), bc);
+    assembleRhs(param, z, workspace_.rhs(ZZ), bc);
 
     
     // Solve System
     //-------------------------------------------------------------------------
 
-    // solve tridiagonal system by Gaussian elimination:
-    int status = LAPACKE_sgtsv(LAPACK_COL_MAJOR,
-                               nSys, 
-                               nRhs,
-                               subDiag, 
-                               mainDiag, 
-                               superDiag, 
-                               rhsMat,
-                               nSys);
-
-    // handle solver failure:
-    if( status != 0 )
-    {
-        throw std::runtime_error("Could not solve tridiagonal system in 3D "
-                                 "interpolation. "
-                                 "LAPACK error code: "+std::to_string(status));
-    } 
+    // solve tridiagonal system for all dimensions at once:
+    workspace_.solve();
 
 
     // Prepare Output
@@ -173,11 +140,12 @@ CubicSplineInterp3D::interpolate(std::vector<real> &param,
 
     // create vectorial representation of coefficients:
     std::vector<gmx::RVec> coefs;
+    coefs.reserve(nSys);
     for(size_t i = 0; i < nSys; i++)
     {
-        coefs.push_back(gmx::RVec(rhsMat[i],
-                                  rhsMat[i + nSys],
-                                  rhsMat[i + 2*nSys]));
+        coefs.push_back(gmx::RVec(workspace_.rhs(XX)[i],
+                                  workspace_.rhs(YY)[i],
+                                  workspace_.rhs(ZZ)[i]));
     }
 
     // create spline curve object:
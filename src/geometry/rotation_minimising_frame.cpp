@@ -0,0 +1,279 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "geometry/rotation_minimising_frame.hpp"
+
+
+/*!
+ * Default constructor, creates an empty frame table.
+ */
+RotationMinimisingFrame::RotationMinimisingFrame()
+    : step_(0.0)
+{
+
+}
+
+
+/*!
+ * Constructs the frame table from points and tangents sampled along a curve
+ * at parameter values \f$ s_i = i \Delta s \f$, where \f$ \Delta s \f$ is the
+ * given step. Tangents need not be normalised.
+ *
+ * The initial normal is obtained by orthogonalising the coordinate axis least
+ * aligned with the first tangent. Each subsequent frame is obtained from its 
+ * predecessor by two reflections: the first in the plane bisecting the chord 
+ * between consecutive points, the second in the plane that maps the reflected
+ * tangent onto the next tangent.
+ */
+RotationMinimisingFrame::RotationMinimisingFrame(
+        real step,
+        const std::vector<gmx::RVec> &points,
+        const std::vector<gmx::RVec> &tangents)
+    : step_(step)
+{
+    // sanity checks:
+    if( points.size() != tangents.size() )
+    {
+        throw std::logic_error("Number of points and tangents must agree in "
+                               "rotation-minimising frame.");
+    }
+    if( points.size() < 2 || !(step > 0.0) )
+    {
+        throw std::logic_error("Rotation-minimising frame requires at least "
+                               "two points with positive spacing.");
+    }
+
+    // normalise tangents:
+    std::vector<gmx::RVec> unitTangents(tangents.size());
+    for(size_t i = 0; i < tangents.size(); i++)
+    {
+        unitv(tangents[i], unitTangents[i]);
+    }
+
+    // initial normal from coordinate axis least aligned with tangent:
+    const gmx::RVec &t0 = unitTangents.front();
+    int axis = XX;
+    for(int d = YY; d <= ZZ; d++)
+    {
+        if( std::abs(t0[d]) < std::abs(t0[axis]) )
+        {
+            axis = d;
+        }
+    }
+    gmx::RVec normal(0.0, 0.0, 0.0);
+    normal[axis] = 1.0;
+    gmx::RVec tmp;
+    svmul(iprod(normal, t0), t0, tmp);
+    rvec_dec(normal, tmp);
+    unitv(normal, normal);
+
+    // propagate frame by double reflection:
+    normals_.reserve(points.size());
+    binormals_.reserve(points.size());
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        if( i > 0 )
+        {
+            // reflection in bisecting plane of chord:
+            gmx::RVec v1;
+            rvec_sub(points[i], points[i - 1], v1);
+            real c1 = iprod(v1, v1);
+            gmx::RVec normalL = normal;
+            gmx::RVec tangentL = unitTangents[i - 1];
+            if( c1 > 0.0 )
+            {
+                svmul(2.0*iprod(v1, normal)/c1, v1, tmp);
+                rvec_dec(normalL, tmp);
+                svmul(2.0*iprod(v1, unitTangents[i - 1])/c1, v1, tmp);
+                rvec_dec(tangentL, tmp);
+            }
+
+            // reflection mapping reflected tangent onto next tangent:
+            gmx::RVec v2;
+            rvec_sub(unitTangents[i], tangentL, v2);
+            real c2 = iprod(v2, v2);
+            normal = normalL;
+            if( c2 > 0.0 )
+            {
+                svmul(2.0*iprod(v2, normalL)/c2, v2, tmp);
+                rvec_dec(normal, tmp);
+            }
+
+            // remove accumulated rounding errors:
+            svmul(iprod(normal, unitTangents[i]), unitTangents[i], tmp);
+            rvec_dec(normal, tmp);
+            unitv(normal, normal);
+        }
+
+        // binormal completes right-handed frame:
+        gmx::RVec binormal;
+        cprod(unitTangents[i], normal, binormal);
+
+        normals_.push_back(normal);
+        binormals_.push_back(binormal);
+    }
+}
+
+
+/*!
+ * Returns true if the frame table has not been computed.
+ */
+bool
+RotationMinimisingFrame::empty() const
+{
+    return normals_.empty();
+}
+
+
+/*!
+ * Returns the number of entries in the frame table.
+ */
+size_t
+RotationMinimisingFrame::size() const
+{
+    return normals_.size();
+}
+
+
+/*!
+ * Returns the (approximately unit length) normal vector of the frame at the 
+ * given parameter value, measured from the first table entry.
+ */
+gmx::RVec
+RotationMinimisingFrame::normal(real s) const
+{
+    size_t idx;
+    real weight;
+    lookup(s, idx, weight);
+    return interpolate(normals_, idx, weight);
+}
+
+
+/*!
+ * Returns the (approximately unit length) binormal vector of the frame at the
+ * given parameter value, measured from the first table entry.
+ */
+gmx::RVec
+RotationMinimisingFrame::binormal(real s) const
+{
+    size_t idx;
+    real weight;
+    lookup(s, idx, weight);
+    return interpolate(binormals_, idx, weight);
+}
+
+
+/*!
+ * Returns the angular coordinate \f$ \phi \in (-\pi, \pi] \f$ of a radial
+ * vector, i.e. a vector orthogonal to the curve at the given parameter value
+ * (e.g. the vector from the closest point on the curve to a mapped particle).
+ * This requires only a single table lookup and two dot products.
+ */
+real
+RotationMinimisingFrame::angle(real s, const gmx::RVec &radial) const
+{
+    size_t idx;
+    real weight;
+    lookup(s, idx, weight);
+    return std::atan2(iprod(radial, interpolate(binormals_, idx, weight)),
+                      iprod(radial, interpolate(normals_, idx, weight)));
+}
+
+
+/*!
+ * Returns the radial unit vector \f$ \cos(\phi) \mathbf{n} + \sin(\phi) 
+ * \mathbf{b} \f$ at the given parameter value and angular coordinate. This is
+ * the inverse of angle().
+ */
+gmx::RVec
+RotationMinimisingFrame::direction(real s, real phi) const
+{
+    size_t idx;
+    real weight;
+    lookup(s, idx, weight);
+
+    gmx::RVec dir;
+    gmx::RVec tmp;
+    svmul(std::cos(phi), interpolate(normals_, idx, weight), dir);
+    svmul(std::sin(phi), interpolate(binormals_, idx, weight), tmp);
+    rvec_inc(dir, tmp);
+    unitv(dir, dir);
+    return dir;
+}
+
+
+/*!
+ * Finds the table interval containing the given parameter value and the 
+ * linear interpolation weight of its upper end. Parameter values outside the
+ * table range are clamped to its ends.
+ */
+void
+RotationMinimisingFrame::lookup(real s, size_t &idx, real &weight) const
+{
+    if( normals_.empty() )
+    {
+        throw std::logic_error("Rotation-minimising frame table is empty.");
+    }
+
+    // position in units of table spacing:
+    real u = s/step_;
+    real uMax = normals_.size() - 1;
+    if( !(u > 0.0) )
+    {
+        idx = 0;
+        weight = 0.0;
+    }
+    else if( u >= uMax )
+    {
+        idx = normals_.size() - 2;
+        weight = 1.0;
+    }
+    else
+    {
+        idx = static_cast<size_t>(u);
+        idx = std::min(idx, normals_.size() - 2);
+        weight = u - idx;
+    }
+}
+
+
+/*!
+ * Linear interpolation between two consecutive table entries.
+ */
+gmx::RVec
+RotationMinimisingFrame::interpolate(
+        const std::vector<gmx::RVec> &table,
+        size_t idx,
+        real weight) const
+{
+    const gmx::RVec &lo = table[idx];
+    const gmx::RVec &hi = table[idx + 1];
+    return gmx::RVec((1.0 - weight)*lo[XX] + weight*hi[XX],
+                     (1.0 - weight)*lo[YY] + weight*hi[YY],
+                     (1.0 - weight)*lo[ZZ] + weight*hi[ZZ]);
+}
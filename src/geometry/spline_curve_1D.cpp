@@ -22,11 +22,15 @@
 // THE SOFTWARE.
 
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <functional>
+#include <utility>
 
 #include <boost/math/tools/minima.hpp>
 
+#include "geometry/bspline_basis_kernel.hpp"
 #include "geometry/spline_curve_1D.hpp"
 
 
@@ -37,6 +41,22 @@
 SplineCurve1D::SplineCurve1D(int degree,
                              std::vector<real> knotVector,
                              std::vector<real> ctrlPoints)
+    : SplineCurve1D(degree, 
+                    SharedArray<real>(std::move(knotVector)), 
+                    std::move(ctrlPoints))
+{
+
+}
+
+
+/*!
+ * Constructor for creating a spline curve from a knot vector that may be 
+ * shared with other spline curves, e.g. several profiles interpolated on the
+ * same support points. No copy of the knots is made.
+ */
+SplineCurve1D::SplineCurve1D(int degree,
+                             SharedArray<real> knotVector,
+                             std::vector<real> ctrlPoints)
 {
     nCtrlPoints_ = ctrlPoints.size();
     nKnots_ = knotVector.size();
@@ -64,8 +84,11 @@ SplineCurve1D::SplineCurve1D(int degree,
     }
 
     // assign knot vector and control points:
-    knots_ = knotVector;
-    ctrlPoints_ = ctrlPoints;
+    setKnots(std::move(knotVector));
+    ctrlPoints_ = std::move(ctrlPoints);
+
+    // values at endpoints are needed for extrapolation:
+    prepareExtrapolation();
 }
 
 
@@ -73,6 +96,8 @@ SplineCurve1D::SplineCurve1D(int degree,
  * Default constror for initialiser lists.
  */
 SplineCurve1D::SplineCurve1D()
+    : extrapValueLo_(0.0)
+    , extrapValueHi_(0.0)
 {
     
 }
@@ -121,67 +146,129 @@ SplineCurve1D::evaluateMultiple(
 }
 
 
+/*!
+ * Helper function for evaluating the spline curve at a point inside the knot
+ * span with the given index using the compile-time specialised basis kernel
+ * BSplineBasisKernel. The linear combination only runs over the Degree + 1
+ * control points whose basis functions are nonzero in this span.
+ */
+template<int Degree, int Deriv>
+real
+SplineCurve1D::evaluateKernel(const real &eval, int knotSpanIdx)
+{
+    // evaluate nonzero basis elements:
+    typename BSplineBasisKernel<Degree, Deriv>::Elements basis =
+            BSplineBasisKernel<Degree, Deriv>::evaluate(
+                    eval, 
+                    knots_.vector().data(), 
+                    knotSpanIdx);
+
+    // linear combination with corresponding control points (in double 
+    // precision, as terms can cancel close to a minimum):
+    double value = 0.0;
+    for(int i = 0; i <= Degree; i++)
+    {
+        value += basis[i]*ctrlPoints_[knotSpanIdx - Degree + i];
+    }
+
+    return value;
+}
+
+
 /*!
  * Helper function for evaluating the spline curve at points inside the range 
- * covered by the knot vector.
+ * covered by the knot vector. Linear and cubic splines are dispatched to the 
+ * compile-time specialised evaluateKernel(), other degrees use the generic 
+ * BSplineBasisSet.
  */
 real
 SplineCurve1D::evaluateInternal(const real &eval, unsigned int deriv)
 {
-    // container for basis functions or derivatives:
-    SparseBasis basis;
+    // find knot span of evaluation point:
+    int knotSpanIdx = findInterval(eval);
 
-    // derivative required?
-    if( deriv == 0 )
-    {
-        // evaluate B-spline basis:
-        basis = B_(eval, knots_, degree_);
-    }
-    else
+    // specialised kernels only if knot span is inside basis domain:
+    if( knotSpanIdx >= degree_ && 
+        knotSpanIdx < static_cast<int>(knots_.size()) - degree_ - 1 )
     {
-        // evaluate B-spline basis derivatives:
-        basis = B_(eval, knots_, degree_, deriv); 
+        if( degree_ == 3 )
+        {
+            switch( deriv )
+            {
+                case 0: return evaluateKernel<3, 0>(eval, knotSpanIdx);
+                case 1: return evaluateKernel<3, 1>(eval, knotSpanIdx);
+                case 2: return evaluateKernel<3, 2>(eval, knotSpanIdx);
+                case 3: return evaluateKernel<3, 3>(eval, knotSpanIdx);
+                default: return 0.0;
+            }
+        }
+        else if( degree_ == 1 )
+        {
+            switch( deriv )
+            {
+                case 0: return evaluateKernel<1, 0>(eval, knotSpanIdx);
+                case 1: return evaluateKernel<1, 1>(eval, knotSpanIdx);
+                default: return 0.0;
+            }
+        }
     }
+
+    // evaluate B-spline basis or its derivatives:
+    SparseBasis basis = evaluateBasis(eval, deriv);
     
     // return value of spline curve (derivative) at given evalaution point:
     return computeLinearCombination(basis);
- 
 }
 
 
 /*!
  * Helper function for evaluating the spline curve at points outside the range
- * covered by the knot vector. Constant extrapolation is used here!
+ * covered by the knot vector. Constant extrapolation is used here, where the
+ * values at either end of the curve are precomputed by prepareExtrapolation().
  */
 real
 SplineCurve1D::evaluateExternal(const real &eval, unsigned int deriv)
 {
-    // which boundary is extrapolation based on?
-    real boundary;
-    if( eval < knots_.front() )
-    {
-        boundary = knots_.front();
-    }
-    else
-    {
-        boundary = knots_.back();
-    }
-
     // derivative required?
     if( deriv == 0 )
     {
         // return value of curve at boundary:
-        SparseBasis basis = B_(boundary, knots_, degree_);
-        return computeLinearCombination(basis);
+        if( eval < knots_.front() )
+        {
+            return extrapValueLo_;
+        }
+        else
+        {
+            return extrapValueHi_;
+        }
     }
     else
     {
-        // for linear extrapolation, second and higher order deriv are zero:
+        // for constant extrapolation, all derivatives are zero:
         return 0.0;
     }
 }
 
 
+/*!
+ * Evaluates the curve at its first and last knot and stores the result for 
+ * use in evaluateExternal(), so that extrapolation does not require any 
+ * basis function evaluations. Needs to be called whenever the control points
+ * change. Shifting the knots does not affect these values.
+ *
+ * The curve is evaluated at the first and last unique knot, which for the 
+ * usual clamped knot vectors coincide with the first and last knot.
+ */
+void
+SplineCurve1D::prepareExtrapolation()
+{
+    extrapValueLo_ = computeLinearCombination(
+            B_(knots_[degree_], knots_, degree_));
+    extrapValueHi_ = computeLinearCombination(
+            B_(knots_[knots_.size() - degree_ - 1], knots_, degree_));
+}
+
+
 /*!
  * Auxiliary function for computing the linear combination of basis functions
  * weighted by control points.
@@ -202,10 +289,10 @@ SplineCurve1D::computeLinearCombination(const SparseBasis &basis)
 /*!
  * Getter function for access to the spline curves control points.
  */
-std::vector<real>
+const std::vector<real>&
 SplineCurve1D::ctrlPoints() const
 {
-    return ctrlPoints_;
+    return ctrlPoints_.vector();
 }
 
 
@@ -222,10 +309,227 @@ SplineCurve1D::length() const
 
 
 /*!
- * Returns a pair struct of argmin and min of function value.
+ * Returns the coefficients \f$ a_k \f$ of the polynomial representation 
+ *
+ * \f[
+ *      f(s) = \sum_{k=0}^{p} a_k (s - t_j)^k
+ * \f]
+ *
+ * of the spline curve in the knot span \f$ [t_j, t_{j+1}) \f$ with the given 
+ * index \f$ j \f$. The coefficients are obtained from the derivatives of the 
+ * curve at \f$ t_j \f$, evaluated one-sidedly within this span, i.e. as 
+ * \f$ a_k = f^{(k)}(t_j) / k! \f$.
+ */
+std::vector<double>
+SplineCurve1D::spanPolynomial(int knotSpanIdx)
+{
+    std::vector<double> coefs(degree_ + 1);
+    real t = knots_[knotSpanIdx];
+
+    // derivatives at left end of span:
+    if( degree_ == 3 )
+    {
+        coefs[0] = evaluateKernel<3, 0>(t, knotSpanIdx);
+        coefs[1] = evaluateKernel<3, 1>(t, knotSpanIdx);
+        coefs[2] = evaluateKernel<3, 2>(t, knotSpanIdx);
+        coefs[3] = evaluateKernel<3, 3>(t, knotSpanIdx);
+    }
+    else if( degree_ == 1 )
+    {
+        coefs[0] = evaluateKernel<1, 0>(t, knotSpanIdx);
+        coefs[1] = evaluateKernel<1, 1>(t, knotSpanIdx);
+    }
+    else
+    {
+        for(int k = 0; k <= degree_; k++)
+        {
+            coefs[k] = computeLinearCombination(
+                    B_(t, knots_, degree_, k, knotSpanIdx));
+        }
+    }
+
+    // divide by factorial to obtain Taylor coefficients:
+    double factorial = 1.0;
+    for(int k = 1; k <= degree_; k++)
+    {
+        factorial *= k;
+        coefs[k] /= factorial;
+    }
+
+    return coefs;
+}
+
+
+/*!
+ * Computes the integral of the squared spline curve, i.e.
+ *
+ * \f[
+ *      \int_{s_0}^{s_1} \left( f(s) \right)^2 ds
+ * \f]
+ *
+ * in closed form. Within each knot span, the curve is a polynomial of degree 
+ * \f$ p \f$ (see spanPolynomial()), so its square is a polynomial of degree
+ * \f$ 2p \f$ whose antiderivative is known exactly. Parts of the integration 
+ * range outside the knot range are handled according to the constant 
+ * extrapolation used by evaluate(). The result is accumulated in double 
+ * precision.
+ */
+real
+SplineCurve1D::integrateSquare(const std::pair<real, real> &lim)
+{
+    double lo = lim.first;
+    double hi = lim.second;
+    double integral = 0.0;
+
+    // constant extrapolation below and above knot range:
+    if( lo < knots_.front() )
+    {
+        double extrapLength = std::min<double>(hi, knots_.front()) - lo;
+        integral += extrapValueLo_*extrapValueLo_*extrapLength;
+    }
+    if( hi > knots_.back() )
+    {
+        double extrapLength = hi - std::max<double>(lo, knots_.back());
+        integral += extrapValueHi_*extrapValueHi_*extrapLength;
+    }
+
+    // loop over nonempty knot spans:
+    for(int j = degree_; j < static_cast<int>(knots_.size()) - degree_ - 1; j++)
+    {
+        // part of integration range in this span:
+        double from = std::max<double>(lo, knots_[j]);
+        double to = std::min<double>(hi, knots_[j + 1]);
+        if( !(to > from) )
+        {
+            continue;
+        }
+
+        // square of polynomial in this span:
+        std::vector<double> coefs = spanPolynomial(j);
+        std::vector<double> sqCoefs(2*degree_ + 1, 0.0);
+        for(int k = 0; k <= degree_; k++)
+        {
+            for(int l = 0; l <= degree_; l++)
+            {
+                sqCoefs[k + l] += coefs[k]*coefs[l];
+            }
+        }
+
+        // evaluate antiderivative at both ends by Horner's scheme:
+        double uFrom = from - knots_[j];
+        double uTo = to - knots_[j];
+        double antiderivFrom = 0.0;
+        double antiderivTo = 0.0;
+        for(int k = 2*degree_; k >= 0; k--)
+        {
+            antiderivFrom = antiderivFrom*uFrom + sqCoefs[k]/(k + 1);
+            antiderivTo = antiderivTo*uTo + sqCoefs[k]/(k + 1);
+        }
+        integral += antiderivTo*uTo - antiderivFrom*uFrom;
+    }
+
+    return integral;
+}
+
+
+/*!
+ * Returns a pair struct of argmin and min of function value in the given 
+ * range.
+ *
+ * For splines of degree up to three, the minimum is found exactly: within 
+ * each knot span overlapping the range, the roots of the derivative (a 
+ * polynomial of degree at most two, see spanPolynomial()) are found in closed 
+ * form and the curve is evaluated at these roots as well as at the span 
+ * boundaries. For higher degrees, minimumBrent() is used instead.
  */
 std::pair<real, real>
 SplineCurve1D::minimum(const std::pair<real, real> &lim)
+{
+    // no closed form for higher degrees:
+    if( degree_ > 3 )
+    {
+        return minimumBrent(lim);
+    }
+
+    // endpoints of range are candidates (this also covers extrapolation):
+    std::pair<real, real> best(lim.first, evaluate(lim.first, 0));
+    real valueHi = evaluate(lim.second, 0);
+    if( valueHi < best.second )
+    {
+        best = std::make_pair(lim.second, valueHi);
+    }
+
+    // loop over nonempty knot spans:
+    for(int j = degree_; j < static_cast<int>(knots_.size()) - degree_ - 1; j++)
+    {
+        // part of search range in this span:
+        double from = std::max<double>(lim.first, knots_[j]);
+        double to = std::min<double>(lim.second, knots_[j + 1]);
+        if( !(to >= from) )
+        {
+            continue;
+        }
+
+        // polynomial in this span (zero padded to cubic):
+        std::vector<double> coefs = spanPolynomial(j);
+        coefs.resize(4, 0.0);
+
+        // candidate points are span boundaries and roots of derivative:
+        std::vector<double> candidates = {from - knots_[j], to - knots_[j]};
+
+        // derivative is a*u^2 + b*u + c:
+        double a = 3.0*coefs[3];
+        double b = 2.0*coefs[2];
+        double c = coefs[1];
+        if( a == 0.0 )
+        {
+            if( b != 0.0 )
+            {
+                candidates.push_back(-c/b);
+            }
+        }
+        else
+        {
+            double disc = b*b - 4.0*a*c;
+            if( disc >= 0.0 )
+            {
+                // numerically stable quadratic formula:
+                double q = -0.5*(b + std::copysign(std::sqrt(disc), b));
+                candidates.push_back(q/a);
+                if( q != 0.0 )
+                {
+                    candidates.push_back(c/q);
+                }
+            }
+        }
+
+        // evaluate polynomial at candidates inside span:
+        for(auto u : candidates)
+        {
+            if( u < from - knots_[j] || u > to - knots_[j] )
+            {
+                continue;
+            }
+            double value = ((coefs[3]*u + coefs[2])*u + coefs[1])*u + coefs[0];
+            if( value < best.second )
+            {
+                best = std::make_pair(knots_[j] + u, value);
+            }
+        }
+    }
+
+    return best;
+}
+
+
+/*!
+ * Returns a pair struct of argmin and min of function value. This samples the
+ * curve at points no more than 0.1 apart and refines the smallest sample by 
+ * Brent's method within the bracketing interval given by its neighbouring 
+ * samples (or the sample itself at the ends of the range).
+ */
+std::pair<real, real>
+SplineCurve1D::minimumBrent(const std::pair<real, real> &lim)
 {
     // internal parameters:
     real maxSampleDist = 0.1;
@@ -237,7 +541,7 @@ SplineCurve1D::minimum(const std::pair<real, real> &lim)
     real sampleDist = length/nSamples;
     std::vector<real> par;
     std::vector<real> val;
-    for(int i = 0; i < nSamples; i++)
+    for(int i = 0; i <= nSamples; i++)
     {
         par.push_back( lim.first + i*sampleDist );
         val.push_back( evaluate(par.back(), 0) );
@@ -248,25 +552,14 @@ SplineCurve1D::minimum(const std::pair<real, real> &lim)
     int idxMin = std::distance(val.begin(), itMin);
 
     // determine bracketing interval:
-    real sMin = par[idxMin - 1];
-    real sMax = par[idxMin + 1];
-    if( itMin == val.begin() )
-    {
-        sMin = par[idxMin];
-        sMax = par[idxMin + 1];
-    }
-    else if( itMin == val.end() )
-    {
-        sMin = par[idxMin - 1];
-        sMax = par[idxMin];
-    }
+    int idxLo = std::max(idxMin - 1, 0);
+    int idxHi = std::min(idxMin + 1, static_cast<int>(par.size()) - 1);
 
     // find exact location of minimum through Brent's method:
     return boost::math::tools::brent_find_minima(
             std::bind(&SplineCurve1D::evaluate, this, std::placeholders::_1, 0),
-            sMin,
-            sMax,
+            par[idxLo],
+            par[idxHi],
             std::numeric_limits<real>::digits,
             maxIter);    
 }
-
@@ -24,12 +24,13 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/math/tools/minima.hpp>
-#include <boost/math/tools/roots.hpp>
 
+#include "geometry/bspline_basis_kernel.hpp"
 #include "geometry/spline_curve_3D.hpp"
 #include "geometry/cubic_spline_interp_3D.hpp"
 
@@ -73,8 +74,11 @@ SplineCurve3D::SplineCurve3D(
     }
 
     // assign knot vector and control points:
-    knots_ = knotVector;
-    ctrlPoints_ = ctrlPoints;
+    setKnots(std::move(knotVector));
+    ctrlPoints_ = std::move(ctrlPoints);
+
+    // slope and offset at endpoints are needed for extrapolation:
+    prepareExtrapolation();
 }
 
 
@@ -109,27 +113,77 @@ SplineCurve3D::evaluate(
 }
 
 
+/*!
+ * Auxiliary function for evaluating the spline curve at a point inside the 
+ * knot span with the given index using the compile-time specialised basis
+ * kernel BSplineBasisKernel. The linear combination only runs over the 
+ * Degree + 1 control points whose basis functions are nonzero in this span.
+ */
+template<int Degree, int Deriv>
+gmx::RVec
+SplineCurve3D::evaluateKernel(const real &eval, int knotSpanIdx)
+{
+    // evaluate nonzero basis elements:
+    typename BSplineBasisKernel<Degree, Deriv>::Elements basis =
+            BSplineBasisKernel<Degree, Deriv>::evaluate(
+                    eval, 
+                    knots_.vector().data(), 
+                    knotSpanIdx);
+
+    // linear combination with corresponding control points:
+    gmx::RVec value(0.0, 0.0, 0.0);
+    for(int i = 0; i <= Degree; i++)
+    {
+        const gmx::RVec &ctrlPoint = ctrlPoints_[knotSpanIdx - Degree + i];
+        value[XX] += basis[i]*ctrlPoint[XX];
+        value[YY] += basis[i]*ctrlPoint[YY];
+        value[ZZ] += basis[i]*ctrlPoint[ZZ];
+    }
+
+    return value;
+}
+
+
 /*!
  * Auxiliary function for evaluating the spline curve at points inside the 
- * range covered by knots.
+ * range covered by knots. Linear and cubic splines are dispatched to the 
+ * compile-time specialised evaluateKernel(), other degrees use the generic 
+ * BSplineBasisSet.
  */
 gmx::RVec 
 SplineCurve3D::evaluateInternal(const real &eval, unsigned int deriv)
 {
-    // container for basis functions or derivatives:
-    SparseBasis basis;
+    // find knot span of evaluation point:
+    int knotSpanIdx = findInterval(eval);
 
-    // derivative required?
-    if( deriv == 0 )
-    {
-        // evaluate B-spline basis:
-        basis = B_(eval, knots_, degree_);
-    }
-    else
+    // specialised kernels only if knot span is inside basis domain:
+    if( knotSpanIdx >= degree_ && 
+        knotSpanIdx < static_cast<int>(knots_.size()) - degree_ - 1 )
     {
-        // evaluate B-spline basis derivatives:
-        basis = B_(eval, knots_, degree_, deriv); 
+        if( degree_ == 3 )
+        {
+            switch( deriv )
+            {
+                case 0: return evaluateKernel<3, 0>(eval, knotSpanIdx);
+                case 1: return evaluateKernel<3, 1>(eval, knotSpanIdx);
+                case 2: return evaluateKernel<3, 2>(eval, knotSpanIdx);
+                case 3: return evaluateKernel<3, 3>(eval, knotSpanIdx);
+                default: return gmx::RVec(0.0, 0.0, 0.0);
+            }
+        }
+        else if( degree_ == 1 )
+        {
+            switch( deriv )
+            {
+                case 0: return evaluateKernel<1, 0>(eval, knotSpanIdx);
+                case 1: return evaluateKernel<1, 1>(eval, knotSpanIdx);
+                default: return gmx::RVec(0.0, 0.0, 0.0);
+            }
+        }
     }
+
+    // evaluate B-spline basis or its derivatives:
+    SparseBasis basis = evaluateBasis(eval, deriv);
     
     // return value of spline curve (derivative) at given evaluation point:
     return computeLinearCombination(basis);
@@ -138,44 +192,43 @@ SplineCurve3D::evaluateInternal(const real &eval, unsigned int deriv)
 
 /*!
  * Auxiliary function for evaluating the spline curve at points outside the 
- * range covered by knots. Linear extrapolation is used in this case.
+ * range covered by knots. Linear extrapolation is used in this case, where 
+ * the offset and slope at either end of the curve are precomputed by 
+ * prepareExtrapolation().
  */
 gmx::RVec 
 SplineCurve3D::evaluateExternal(const real &eval, unsigned int deriv)
 {   
     // which boundary is extrapolation based on?
     real boundary;
+    const gmx::RVec *offset;
+    const gmx::RVec *slope;
     if( eval < knots_.front() )
     {
         boundary = knots_.front();
+        offset = &extrapOffsetLo_;
+        slope = &extrapSlopeLo_;
     }
     else
     {
         boundary = knots_.back();
+        offset = &extrapOffsetHi_;
+        slope = &extrapSlopeHi_;
     }
 
     // derivative required?
     if( deriv == 0 )
     {
-        // compute slope and offset:
-        // TODO: this can be made more efficient by evaluating basis and derivs
-        // in one go!
-        SparseBasis basis = B_(boundary, knots_, degree_);
-        gmx::RVec offset = computeLinearCombination(basis);
-        basis = B_(boundary, knots_, degree_, 1);
-        gmx::RVec slope = computeLinearCombination(basis);
-
         // return extrapolation point:
-        svmul(eval - boundary, slope, slope);
-        rvec_add(slope, offset, slope);
-        return slope;
-
+        gmx::RVec value;
+        svmul(eval - boundary, *slope, value);
+        rvec_inc(value, *offset);
+        return value;
     }
     else if( deriv == 1 )
     {
         // simply return the slope at the endpoint:
-        SparseBasis basis = B_(boundary, knots_, degree_, 1);
-        return computeLinearCombination(basis);
+        return *slope;
     }
     else
     {
@@ -185,6 +238,26 @@ SplineCurve3D::evaluateExternal(const real &eval, unsigned int deriv)
 }
 
 
+/*!
+ * Computes the value and first derivative of the curve at its first and last
+ * unique knot and stores them for use in evaluateExternal(), so that linear 
+ * extrapolation does not require any basis function evaluations. Needs to be
+ * called whenever the control points change. Shifting the knots does not 
+ * affect these coefficients.
+ */
+void
+SplineCurve3D::prepareExtrapolation()
+{
+    real lo = knots_[degree_];
+    real hi = knots_[knots_.size() - degree_ - 1];
+
+    extrapOffsetLo_ = computeLinearCombination(B_(lo, knots_, degree_));
+    extrapOffsetHi_ = computeLinearCombination(B_(hi, knots_, degree_));
+    extrapSlopeLo_ = computeLinearCombination(B_(lo, knots_, degree_, 1));
+    extrapSlopeHi_ = computeLinearCombination(B_(hi, knots_, degree_, 1));
+}
+
+
 /*!
  * Evaluates the linear combination of basis functions weighted by control
  * points, i.e. computes
@@ -254,14 +327,16 @@ SplineCurve3D::arcLengthParam()
                                   eSplineInterpBoundaryHermite);
 
     // update own parameters:
-    this -> knots_ = newSpl.knots_;
-    this -> ctrlPoints_ = newSpl.ctrlPoints_;
     this -> nKnots_ = newSpl.nKnots_;
     this -> nCtrlPoints_ = newSpl.nCtrlPoints_;
+    this -> setKnots(newSpl.knots_);
+    this -> ctrlPoints_ = newSpl.ctrlPoints_;
+    this -> prepareExtrapolation();
     this -> arcLengthTableAvailable_ = false;
 
-    // reset reference points for mapping:
+    // reset reference points and frame for mapping:
     refPoints_.clear();
+    frame_ = RotationMinimisingFrame();
 }
 
 
@@ -288,12 +363,12 @@ SplineCurve3D::length(const real &lo, const real &hi)
     // add distance in endpoint intervals:
     if( idxHi == idxLo )
     {
-        length += arcLengthBoole(lo, hi);
+        length += arcLengthGauss(lo, hi);
     }
     else
     {
-        length += arcLengthBoole(lo, knots_[idxLo + 1]);
-        length += arcLengthBoole(knots_[idxHi], hi);
+        length += arcLengthGauss(lo, knots_[idxLo + 1]);
+        length += arcLengthGauss(knots_[idxHi], hi);
     }
 
     // if necessary, loop over intermediate spline segments and sum up lengths:
@@ -354,6 +429,70 @@ SplineCurve3D::speed(const real &eval)
 }
 
 
+/*!
+ * Returns the normal vector of the rotation-minimising frame at the given 
+ * evaluation point. Unlike normalVec(), this does not depend on the curvature
+ * and does not twist around the curve. This is the direction of zero angular
+ * coordinate.
+ */
+gmx::RVec
+SplineCurve3D::frameNormal(const real &eval)
+{
+    if( frame_.empty() )
+    {
+        prepareFrame();
+    }
+    return frame_.normal(eval - knots_.front());
+}
+
+
+/*!
+ * Returns the binormal vector of the rotation-minimising frame at the given 
+ * evaluation point. This is the direction of an angular coordinate of 
+ * \f$ \pi/2 \f$.
+ */
+gmx::RVec
+SplineCurve3D::frameBinormal(const real &eval)
+{
+    if( frame_.empty() )
+    {
+        prepareFrame();
+    }
+    return frame_.binormal(eval - knots_.front());
+}
+
+
+/*!
+ * Tabulates the rotation-minimising frame at four uniformly spaced points 
+ * per knot interval between the first and last knot. The table is indexed by
+ * the parameter distance from the first knot, so that it remains valid when
+ * the curve is shifted.
+ */
+void
+SplineCurve3D::prepareFrame()
+{
+    // uniform sampling of parameter range:
+    int numSamples = 4*(uniqueKnots().size() - 1) + 1;
+    real lo = knots_.front();
+    real step = (knots_.back() - lo)/(numSamples - 1);
+
+    // sample points and tangents along curve:
+    std::vector<gmx::RVec> points;
+    std::vector<gmx::RVec> tangents;
+    points.reserve(numSamples);
+    tangents.reserve(numSamples);
+    for(int i = 0; i < numSamples; i++)
+    {
+        real eval = lo + i*step;
+        points.push_back(evaluate(eval, 0));
+        tangents.push_back(evaluate(eval, 1));
+    }
+
+    // build frame table:
+    frame_ = RotationMinimisingFrame(step, points, tangents);
+}
+
+
 /*!
  * Takes point in Cartesian coordinates and returns that points coordinates in
  * the curvilinear system defined by the spline curve. Return value is an RVec,
@@ -361,12 +500,14 @@ SplineCurve3D::speed(const real &eval)
  *
  *      [0] - distance along the arc of the curve
  *      [1] - squared (!) distance from the curve at closest point
- *      [2] - angular coordinate; this is not yet implemented
+ *      [2] - angular coordinate in \f$ (-\pi, \pi] \f$
+ *
+ * The angular coordinate is measured in the rotation-minimising frame along
+ * the curve (see RotationMinimisingFrame), which is tabulated on the first 
+ * call to this function.
  *
  * Note that this function assumes that the curve is parameterised by arc 
  * length!
- *
- * \todo implement angular coordinate!
  */
 gmx::RVec 
 SplineCurve3D::cartesianToCurvilinear(const gmx::RVec &cartPoint)
@@ -421,8 +562,14 @@ SplineCurve3D::cartesianToCurvilinear(const gmx::RVec &cartPoint)
         proj = altProj;
     }
   
-    // TODO: calculate angular coordinate!
-    proj[PP] = 0.0;
+    // angular coordinate of vector from closest point in frame:
+    if( frame_.empty() )
+    {
+        prepareFrame();
+    }
+    gmx::RVec radial;
+    rvec_sub(cartPoint, evaluate(proj[SS], 0), radial);
+    proj[PP] = frame_.angle(proj[SS] - knots_.front(), radial);
 
     // return point in curvilinear coordinates:
     return proj;
@@ -619,36 +766,41 @@ SplineCurve3D::projectionInExtrapRange(
 /*!
  * Getter function for access to the spline curves control points.
  */
-std::vector<gmx::RVec>
+const std::vector<gmx::RVec>&
 SplineCurve3D::ctrlPoints() const
 {
-    return ctrlPoints_;
+    return ctrlPoints_.vector();
 }
 
 
 /*!
- * Uses Newton-Cotes quadrature of curve speed to determine the length of the 
- * arc between two given parameter values. The specific quadrature rule applied
- * is Boole's rule.
+ * Uses five-point Gauss-Legendre quadrature of curve speed to determine the 
+ * length of the arc between two given parameter values. This is exact for 
+ * polynomials up to degree nine and thus more accurate than Newton-Cotes rules
+ * with the same number of speed evaluations.
  */
 real
-SplineCurve3D::arcLengthBoole(const real &lo, const real &hi)
+SplineCurve3D::arcLengthGauss(const real &lo, const real &hi)
 {
-    // determine intermediate evaluation points:
-    real h = (hi - lo)/4.0;
-    real t2 = lo + 1.0*h;
-    real t3 = lo + 2.0*h;
-    real t4 = lo + 3.0*h;
-
-    // evaluate speed at support points: 
-    real s1 = speed(lo);
-    real s2 = speed(t2);
-    real s3 = speed(t3);
-    real s4 = speed(t4);
-    real s5 = speed(hi);
-
-    // evaluate Boole's law:
-    return 2.0*h/45.0*(7.0*s1 + 32.0*s2 + 12.0*s3 + 32.0*s4 + 7.0*s5);
+    // nodes and weights of five-point rule on [-1, 1]:
+    static const double nodes[5] = {
+            -0.906179845938664, -0.538469310105683, 0.0, 
+             0.538469310105683,  0.906179845938664};
+    static const double weights[5] = {
+             0.236926885056189,  0.478628670499366, 0.568888888888889, 
+             0.478628670499366,  0.236926885056189};
+
+    // map nodes onto integration interval and sum up weighted speeds (in 
+    // double precision to avoid accumulating round-off in the weights):
+    double halfWidth = 0.5*(hi - lo);
+    double centre = 0.5*(hi + lo);
+    double length = 0.0;
+    for(int i = 0; i < 5; i++)
+    {
+        length += weights[i]*speed(centre + halfWidth*nodes[i]);
+    }
+
+    return halfWidth*length;
 }
 
 
@@ -660,14 +812,15 @@ void
 SplineCurve3D::prepareArcLengthTable()
 {
     arcLengthTable_.resize(knots_.size());
-    real segmentLength;
+    arcLengthTable_[0] = 0.0;
+
+    // cumulative sum is kept in double precision to avoid drift:
+    double arcLength = 0.0;
     for(unsigned int i = 0; i < knots_.size() - 1; i++)
     {
-        // calculate length of current segment:
-        segmentLength = arcLengthBoole(knots_[i], knots_[i+1]);
-
-        // add to arc length table:
-        arcLengthTable_[i + 1] = arcLengthTable_[i] + segmentLength;
+        // add length of current segment to arc length table:
+        arcLength += arcLengthGauss(knots_[i], knots_[i+1]);
+        arcLengthTable_[i + 1] = arcLength;
     }
 
     // set flag:
@@ -730,13 +883,21 @@ SplineCurve3D::lastPointArcLength()
 
 /*!
  * Returns the parameter value (in the current parameterisation, typically 
- * chord length) that corresponds to a given value of arc length. This is done
- * via bisection.
+ * chord length) that corresponds to a given value of arc length. 
+ *
+ * The knot interval containing the target arc length is located in the arc 
+ * length lookup table and linear interpolation within this interval provides
+ * the initial guess. As the derivative of arc length with respect to the 
+ * parameter is simply the curve speed, this guess is then refined by Newton 
+ * iteration, which typically converges after one or two steps because the
+ * speed varies only little within a single knot interval. The arc length of 
+ * each iterate is obtained incrementally from that of the previous one, so 
+ * that every step only integrates over the short distance of the step.
  */
 real
 SplineCurve3D::arcLengthToParam(real &arcLength)
 {
-    boost::uintmax_t maxIter = 100;
+    const int maxIter = 20;
     real absTol = 0.01*std::sqrt(std::numeric_limits<real>::epsilon());
 
     // sanity check for arc length table:
@@ -752,79 +913,61 @@ SplineCurve3D::arcLengthToParam(real &arcLength)
     }
 
     // find appropriate interval:
-    std::pair<std::vector<real>::iterator, std::vector<real>::iterator> bounds;
-    bounds = std::equal_range(arcLengthTable_.begin(), arcLengthTable_.end(), arcLength);
-    int idxLo = bounds.second - arcLengthTable_.begin() - 1;
-    int idxHi = bounds.second - arcLengthTable_.begin();
-
+    std::vector<real>::iterator upper = std::upper_bound(
+            arcLengthTable_.begin(), 
+            arcLengthTable_.end(), 
+            arcLength);
 
     // handle query outside table range:
     // TODO: add case for query below lower bound and test!
-    if( bounds.second == arcLengthTable_.end() )
+    if( upper == arcLengthTable_.end() )
     {
         return knots_.back() + arcLength - arcLengthTable_.back();
     }
-    if( bounds.second == arcLengthTable_.begin() )
+    if( upper == arcLengthTable_.begin() )
     {
         std::cerr<<"ERROR: arc length below table value range!"<<std::endl;
         std::abort();
     }
+    int idxHi = upper - arcLengthTable_.begin();
+    int idxLo = idxHi - 1;
 
-    // initialise bisection interval and lower limit:
+    // bracketing interval (upper_bound ensures it has nonzero length):
     real tLo = knots_[idxLo];
     real tHi = knots_[idxHi];
-    real tLi = tLo;
    
     // target arc length within this interval:
-    real targetIntervalLength = arcLength - arcLengthTable_[idxLo];
+    real target = arcLength - arcLengthTable_[idxLo];
+    real intervalLength = arcLengthTable_[idxHi] - arcLengthTable_[idxLo];
 
-    // termination condition binding:
-    boost::function<bool(real, real)> termCond;
-    termCond = boost::bind(&SplineCurve3D::arcLengthToParamTerm, 
-                           this, 
-                           _1, 
-                           _2,
-                           absTol);
+    // initial guess from linear interpolation in lookup table:
+    real t = tLo + (tHi - tLo)*target/intervalLength;
 
-    // objective function binding:
-    boost::function<real(real)> objFun;
-    objFun = boost::bind(&SplineCurve3D::arcLengthToParamObj, 
-                         this, 
-                         tLi, 
-                         _1, 
-                         targetIntervalLength);
-
-        
-    std::pair<real, real> result;
-    result = boost::math::tools::toms748_solve(objFun,
-                                               tLo, 
-                                               tHi,
-                                               termCond,
-                                               maxIter);
-    
+    // arc length from start of interval to initial guess:
+    real s = arcLengthGauss(tLo, t);
 
-    // best guess if middle of bracketing interval:
-    return 0.5*(result.first + result.second);
-}
+    // Newton iteration, where speed is the derivative of arc length:
+    for(int i = 0; i < maxIter; i++)
+    {
+        real step = (s - target)/speed(t);
+        real tNew = t - step;
 
+        // safeguard against leaving the bracketing interval:
+        tNew = std::max(tLo, std::min(tHi, tNew));
+        step = t - tNew;
 
-/*!
- * Termination condition for re-parameterisation optimisation. 
- */
-bool
-SplineCurve3D::arcLengthToParamTerm(real lo, real hi, real tol)
-{
-    return std::abs(hi - lo) <= tol;
-}
+        // update arc length incrementally (quadrature is signed for tNew < t):
+        s += arcLengthGauss(t, tNew);
+        t = tNew;
 
+        // converged?
+        if( std::abs(step) <= absTol )
+        {
+            break;
+        }
+    }
 
-/*!
- * Objective function for re-parameterisation optimisation.
- */
-real
-SplineCurve3D::arcLengthToParamObj(real lo, real hi, real target)
-{
-    return arcLengthBoole(lo, hi) - target;
+    return t;
 }
 
 
@@ -0,0 +1,230 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "geometry/spline_interp_workspace.hpp"
+
+
+/*!
+ * Constructor creates an empty workspace.
+ */
+SplineInterpWorkspace::SplineInterpWorkspace()
+    : nSys_(0)
+    , nRhs_(0)
+{
+
+}
+
+
+/*!
+ * Sets the dimension of the system and the number of right hand sides. 
+ * Buffers are only reallocated if they are too small, their content is 
+ * undefined afterwards and needs to be assembled by the caller.
+ */
+void
+SplineInterpWorkspace::resize(
+        size_t nSys,
+        size_t nRhs)
+{
+    nSys_ = nSys;
+    nRhs_ = nRhs;
+
+    // resize only grows buffers, capacity is retained between calls:
+    if( subDiag_.size() < nSys_ )
+    {
+        subDiag_.resize(nSys_);
+        mainDiag_.resize(nSys_);
+        superDiag_.resize(nSys_);
+        superDiag2_.resize(nSys_);
+    }
+    if( rhs_.size() < nSys_*nRhs_ )
+    {
+        rhs_.resize(nSys_*nRhs_);
+    }
+}
+
+
+/*!
+ * Returns pointer to the subdiagonal, which has size() - 1 elements.
+ */
+real*
+SplineInterpWorkspace::subDiag()
+{
+    return subDiag_.data();
+}
+
+
+/*!
+ * Returns pointer to the main diagonal, which has size() elements.
+ */
+real*
+SplineInterpWorkspace::mainDiag()
+{
+    return mainDiag_.data();
+}
+
+
+/*!
+ * Returns pointer to the superdiagonal, which has size() - 1 elements.
+ */
+real*
+SplineInterpWorkspace::superDiag()
+{
+    return superDiag_.data();
+}
+
+
+/*!
+ * Returns pointer to the j-th right hand side vector. After solve() has been 
+ * called, this contains the corresponding solution vector.
+ */
+real*
+SplineInterpWorkspace::rhs(size_t j)
+{
+    return rhs_.data() + j*nSys_;
+}
+
+
+/*!
+ * Solves the tridiagonal system for all right hand sides simultaneously. The 
+ * diagonals are destroyed in the process and the right hand sides are 
+ * overwritten with the solution. Throws an exception if the matrix is 
+ * singular.
+ *
+ * This follows the algorithm of LAPACK's xGTSV routine: in each elimination 
+ * step, the current row is swapped with the next one if the latter has the 
+ * larger entry in the pivot column, which creates fill-in on the second 
+ * superdiagonal.
+ */
+void
+SplineInterpWorkspace::solve()
+{
+    // trivial systems:
+    if( nSys_ == 0 )
+    {
+        return;
+    }
+
+    // short hands:
+    size_t n = nSys_;
+    real *dl = subDiag_.data();
+    real *d = mainDiag_.data();
+    real *du = superDiag_.data();
+    real *du2 = superDiag2_.data();
+    real *b = rhs_.data();
+
+    // forward elimination:
+    for(size_t i = 0; i + 1 < n; i++)
+    {
+        if( std::abs(d[i]) >= std::abs(dl[i]) )
+        {
+            // no row interchange required:
+            if( d[i] == 0.0 )
+            {
+                throw std::runtime_error("Singular tridiagonal system in "
+                                         "spline interpolation, zero pivot "
+                                         "in row " + std::to_string(i) + 
+                                         ".");
+            }
+            real fact = dl[i]/d[i];
+            d[i + 1] -= fact*du[i];
+            du2[i] = 0.0;
+            for(size_t j = 0; j < nRhs_; j++)
+            {
+                b[j*n + i + 1] -= fact*b[j*n + i];
+            }
+        }
+        else
+        {
+            // interchange rows i and i + 1:
+            real fact = d[i]/dl[i];
+            d[i] = dl[i];
+            real tmp = d[i + 1];
+            d[i + 1] = du[i] - fact*tmp;
+            if( i + 2 < n )
+            {
+                du2[i] = du[i + 1];
+                du[i + 1] = -fact*du2[i];
+            }
+            else
+            {
+                du2[i] = 0.0;
+            }
+            du[i] = tmp;
+            for(size_t j = 0; j < nRhs_; j++)
+            {
+                real *bj = b + j*n;
+                tmp = bj[i];
+                bj[i] = bj[i + 1];
+                bj[i + 1] = tmp - fact*bj[i + 1];
+            }
+        }
+    }
+    if( d[n - 1] == 0.0 )
+    {
+        throw std::runtime_error("Singular tridiagonal system in spline "
+                                 "interpolation, zero pivot in row " + 
+                                 std::to_string(n - 1) + ".");
+    }
+
+    // back substitution:
+    for(size_t j = 0; j < nRhs_; j++)
+    {
+        real *bj = b + j*n;
+        bj[n - 1] /= d[n - 1];
+        if( n > 1 )
+        {
+            // remaining rows (loop would underflow for a single equation):
+            bj[n - 2] = (bj[n - 2] - du[n - 2]*bj[n - 1])/d[n - 2];
+            for(size_t i = n - 2; i-- > 0; )
+            {
+                bj[i] = (bj[i] - du[i]*bj[i + 1] - du2[i]*bj[i + 2])/d[i];
+            }
+        }
+    }
+}
+
+
+/*!
+ * Returns dimension of the linear system.
+ */
+size_t
+SplineInterpWorkspace::size() const
+{
+    return nSys_;
+}
+
+
+/*!
+ * Returns number of right hand sides.
+ */
+size_t
+SplineInterpWorkspace::numRhs() const
+{
+    return nRhs_;
+}
@@ -23,15 +23,27 @@
 
 
 #include <cmath>
+#include <stdexcept>
 
 #include "gromacs/analysisdata/dataframe.h"
 
-#include "external/rapidjson/stringbuffer.h"
-#include "external/rapidjson/writer.h"
-
 #include "io/analysis_data_json_frame_exporter.hpp"
 
 
+/*!
+ * Constructor sets default output buffer size (1 MiB) and flush interval
+ * (100 frames).
+ */
+AnalysisDataJsonFrameExporter::AnalysisDataJsonFrameExporter()
+    : bufferSize_(1 << 20)
+    , flushInterval_(100)
+    , framesSinceFlush_(0)
+    , numSyncs_(0)
+{
+
+}
+
+
 /*!
  * Returns flag indicating what types of data this module can handle.
  */
@@ -46,68 +58,47 @@ AnalysisDataJsonFrameExporter::flags() const
 
 
 /*!
- * Currently, this will open a file to which JSON data will be written. If this
- * file already exists, its content will be deleted, otherwise the file will be
- * created empty. The file stream is closed before the end of this function and
- * will be reopened for each individual frame.
+ * Opens the file to which JSON data will be written. If this file already 
+ * exists, its content will be deleted, otherwise the file will be created 
+ * empty. The file is kept open until dataFinished() is called and is gzip 
+ * compressed if its name ends in .gz. Also creates the JSON document that is
+ * reused for all frames.
  */
 void
 AnalysisDataJsonFrameExporter::dataStarted(
         gmx::AbstractAnalysisData* /* data */)
 {
-    // open file and overwrite if it already exists:
-    file_.open(fileName_.c_str(), std::fstream::out);
-
-    // TODO: header?
+    // open buffered stream and overwrite file if it already exists:
+    stream_.reset(new CompressedFileWriteStream(fileName_, bufferSize_));
+    framesSinceFlush_ = 0;
+    numSyncs_ = 0;
 
-    // close file:
-    file_.close();
+    // prepare JSON document:
+    buildDocument();
 }
 
 
 /*!
- * This function resets the internal JSON document, adds a time stamp and frame
- * number to it, and prepares the objects and arrays that will hold all data.
- * It carries out no file system operations, which are handled by 
- * frameFinished() only.
+ * This function resets the internal JSON document by setting the time stamp 
+ * and frame number and by clearing all column arrays. Clearing retains the 
+ * capacity of the arrays, so that no memory is reallocated. It carries out no
+ * file system operations, which are handled by frameFinished() only.
  */
 void
 AnalysisDataJsonFrameExporter::frameStarted(
         const gmx::AnalysisDataFrameHeader &frame)
 {   
-    // calling setObject will call destructor and deallocate data:
-    json_.SetObject();
-    rapidjson::Document::AllocatorType& allocator = json_.GetAllocator();
+    // set frame number and time stamp:
+    json_["i"].SetInt(frame.index());
+    json_["t"].SetDouble(frame.x());
 
-    // add frame number and time stamp:
-    int i = frame.index();
-    real t = frame.x();
-    json_.AddMember("i", i, allocator);
-    json_.AddMember("t", t, allocator);
-
-    // add object for each data set:
-    for(auto it = dataSetNames_.begin(); it != dataSetNames_.end(); it++)
+    // clear column arrays without releasing their memory:
+    for(auto &dataSet : columns_)
     {
-        // create an empty dataset object to be filled when points are added:
-        rapidjson::Value dataSet;
-        dataSet.SetObject();
-
-        // loop over column names and add arrays for each column:
-        int colIdx = std::distance(dataSetNames_.begin(), it);
-        for(auto colName : columnNames_[colIdx])
+        for(auto &column : dataSet)
         {
-            // prepare array for column:
-            rapidjson::Value column;
-            column.SetArray();
-
-            // add to dataset object:
-            rapidjson::Value columnName(colName, allocator);
-            dataSet.AddMember(columnName, column, allocator);
+            column.clear();
         }
-
-        // add dataset to document:
-        rapidjson::Value dataSetName(*it, allocator);
-        json_.AddMember(dataSetName, dataSet, allocator);
     }
 }
 
@@ -117,8 +108,6 @@ AnalysisDataJsonFrameExporter::frameStarted(
  * document prepared by frameStarted() and adds data to all column arrays. This
  * function does not perform any file system operations, which are handled by
  * frameFinished() only.
- *
- * \todo Handle errors where data set or column names are missing.
  */
 void
 AnalysisDataJsonFrameExporter::pointsAdded(
@@ -127,74 +116,74 @@ AnalysisDataJsonFrameExporter::pointsAdded(
     // create an allocator:
     rapidjson::Document::AllocatorType& allocator = json_.GetAllocator();
 
-    // obtain name of data set:
-    std::string dataSetName = dataSetNames_.at(points.dataSetIndex());    
+    // obtain columns of data set:
+    std::vector<JsonColumnCodec> &dataSet = columns_.at(
+            points.dataSetIndex());
+
+    // sanity check:
+    if( points.values().size() > dataSet.size() )
+    {
+        throw std::runtime_error("Data set " + 
+                                 dataSetNames_.at(points.dataSetIndex()) + 
+                                 " has more columns than column names.");
+    }
 
     // loop over all columns:
     for(size_t i = 0; i < points.values().size(); i++)
     {
-        // obtain name of column:
-        std::string columnName = columnNames_.at(points.dataSetIndex()).at(i);
-
         // sanity check:
-        if( std::isnan( points.values().at(i).value() ) )
+        if( std::isnan( points.values()[i].value() ) )
         {
-            throw std::runtime_error("Data value " + dataSetName + "/" + columnName + " is NaN and can not be "
-                                     "written to JSON file.");
+            throw std::runtime_error("Data value " + 
+                                     dataSetNames_.at(points.dataSetIndex()) + 
+                                     "/" + 
+                                     columnNames_.at(points.dataSetIndex()).at(i) + 
+                                     " is NaN and can not be written to JSON "
+                                     "file.");
         }
 
-        // add value to column array:
-        rapidjson::Value val( points.values().at(i).value() );
-        json_[dataSetName][columnName].PushBack(val, allocator);
+        // encode value into column:
+        dataSet[i].append(points.values()[i].value(), allocator);
     }   
 }
 
 
 /*!
- * Opens the file to which the JSON data will be written. The file is opened
- * in append mode after having been created/cleared by dataStarted(). The 
- * JSON document created in frameStarted() is stringified and the resulting 
- * string is streamed to the file. A new line character is also added. 
+ * Serialises the JSON document created in frameStarted() into the buffered 
+ * output stream and terminates the line. The stream is flushed to disk every
+ * flushInterval_ frames. Note that the Flush() call issued by the JSON writer
+ * at the end of each frame does not write to disk, so that this interval 
+ * check is the only place where data is forced out of the buffer.
  *
- * This function handles all file system operations (i.e. opening and closing 
- * of the file and writing a string to it) and does not manipulate the JSON
- * document prepared by startFrame() and pointsAdded(). Spliiting the 
+ * This function handles all file system operations and does not manipulate 
+ * the JSON document prepared by startFrame() and pointsAdded(). Spliiting the
  * functionality in this way should make clean error handling possible.
- *
- * \todo Check validity of JSON document before writing.
- * \todo Check that file write was successful.
  */
 void
 AnalysisDataJsonFrameExporter::frameFinished(
         const gmx::AnalysisDataFrameHeader& /*frame*/)
 {
-    // open output file separately for each frame:
-    file_.open(fileName_.c_str(), std::fstream::app);
-
-    // create buffer writer string writer:
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    json_.Accept(writer);
-
-    // stringify JSON document and add it to file as new line:
-    std::string jsonLine(buffer.GetString(), buffer.GetSize());
-    file_<<jsonLine<<std::endl;
-
-    // TODO: should probably check if write was successful
-
-    // close output file:
-    file_.close();
+    // serialise document into buffered stream as a new line:
+    writer_.Reset(*stream_);
+    json_.Accept(writer_);
+    stream_ -> Put('\n');
+
+    // flush at given frame interval:
+    framesSinceFlush_++;
+    if( flushInterval_ > 0 && framesSinceFlush_ >= flushInterval_ )
+    {
+        flush();
+    }
 }
 
 
 /*!
- * Currently this does nothing and is implemented only because this is a pure
- * virtual function of the base class.
+ * Writes all remaining data to disk and closes the output file.
  */
 void
 AnalysisDataJsonFrameExporter::dataFinished()
 {
-
+    closeFile();
 }
 
 
@@ -234,3 +223,182 @@ AnalysisDataJsonFrameExporter::setColumnNames(
     columnNames_ = columnNames;
 }
 
+
+/*!
+ * Setter function for column codecs, which determine how each column is 
+ * encoded in the JSON output. The input is structured like the column names,
+ * but may be shorter in either dimension, in which case the remaining columns
+ * are written as plain arrays. Must be called before dataStarted().
+ */
+void
+AnalysisDataJsonFrameExporter::setColumnCodecs(
+        const std::vector<std::vector<JsonColumnCodec>> &columnCodecs)
+{
+    columnCodecs_ = columnCodecs;
+}
+
+
+/*!
+ * Sets the number of frames after which the output buffer is flushed to disk.
+ * A value of zero or less means that data is only written when the buffer is 
+ * full and at the end of the trajectory.
+ */
+void
+AnalysisDataJsonFrameExporter::setFlushInterval(
+        int flushInterval)
+{
+    flushInterval_ = flushInterval;
+}
+
+
+/*!
+ * Sets the size of the user-space output buffer in bytes. Must be called 
+ * before dataStarted().
+ */
+void
+AnalysisDataJsonFrameExporter::setBufferSize(
+        size_t bufferSize)
+{
+    // sanity checks:
+    if( bufferSize == 0 )
+    {
+        throw std::logic_error("Output buffer size must be positive.");
+    }
+    if( stream_ != nullptr )
+    {
+        throw std::logic_error("Can not change output buffer size after data "
+                               "output has started.");
+    }
+
+    bufferSize_ = bufferSize;
+}
+
+
+/*!
+ * Returns the number of times buffered data has been forced to disk (not 
+ * counting closing the file) since dataStarted() was last called. As the JSON
+ * writer's own Flush() calls do not sync the stream, this is the number of 
+ * times the flush interval has been reached.
+ */
+size_t
+AnalysisDataJsonFrameExporter::numSyncs() const
+{
+    return stream_ != nullptr ? stream_ -> numSyncs() : numSyncs_;
+}
+
+
+/*!
+ * Creates the JSON document with frame number, time stamp, and an empty column
+ * for each column of each data set. A codec is attached to each column, so 
+ * that pointsAdded() does not need to look up members by name. The pointers 
+ * cached by the codecs remain valid as no further members are added to the 
+ * document.
+ */
+void
+AnalysisDataJsonFrameExporter::buildDocument()
+{
+    // sanity check:
+    if( columnNames_.size() != dataSetNames_.size() )
+    {
+        throw std::logic_error("Number of column name sets must equal number "
+                               "of data sets.");
+    }
+
+    // calling setObject will call destructor and deallocate data:
+    json_.SetObject();
+    json_.GetAllocator().Clear();
+    rapidjson::Document::AllocatorType& allocator = json_.GetAllocator();
+
+    // add frame number and time stamp:
+    json_.AddMember("i", 0, allocator);
+    json_.AddMember("t", 0.0, allocator);
+
+    // assign codec to each column, defaulting to plain arrays:
+    columns_.clear();
+    columns_.resize(dataSetNames_.size());
+    for(size_t i = 0; i < dataSetNames_.size(); i++)
+    {
+        for(size_t j = 0; j < columnNames_[i].size(); j++)
+        {
+            if( i < columnCodecs_.size() && j < columnCodecs_[i].size() )
+            {
+                columns_[i].push_back(columnCodecs_[i][j]);
+            }
+            else
+            {
+                columns_[i].push_back(JsonColumnCodec());
+            }
+        }
+    }
+
+    // add object for each data set:
+    for(size_t i = 0; i < dataSetNames_.size(); i++)
+    {
+        // create an empty dataset object to be filled when points are added:
+        rapidjson::Value dataSet;
+        dataSet.SetObject();
+
+        // loop over column names and add empty column for each:
+        for(size_t j = 0; j < columnNames_[i].size(); j++)
+        {
+            // prepare column in its encoding:
+            rapidjson::Value column = columns_[i][j].makeColumn(allocator);
+
+            // add to dataset object:
+            rapidjson::Value columnName(columnNames_[i][j], allocator);
+            dataSet.AddMember(columnName, column, allocator);
+        }
+
+        // add dataset to document:
+        rapidjson::Value dataSetName(dataSetNames_[i], allocator);
+        json_.AddMember(dataSetName, dataSet, allocator);
+    }
+
+    // attach codecs to columns in their final location:
+    for(size_t i = 0; i < dataSetNames_.size(); i++)
+    {
+        rapidjson::Value &dataSet = json_[dataSetNames_[i].c_str()];
+        size_t j = 0;
+        for(auto it = dataSet.MemberBegin(); it != dataSet.MemberEnd(); it++)
+        {
+            columns_[i].at(j++).attach(it -> value);
+        }
+    }
+}
+
+
+/*!
+ * Writes the contents of the output buffer to disk.
+ */
+void
+AnalysisDataJsonFrameExporter::flush()
+{
+    // nothing to do if file not open:
+    if( stream_ == nullptr )
+    {
+        return;
+    }
+
+    // force buffered data to disk:
+    stream_ -> sync();
+    framesSinceFlush_ = 0;
+}
+
+
+/*!
+ * Closes the output file.
+ */
+void
+AnalysisDataJsonFrameExporter::closeFile()
+{
+    // nothing to do if file not open:
+    if( stream_ == nullptr )
+    {
+        return;
+    }
+
+    // close file and release stream (keeping its number of syncs):
+    numSyncs_ = stream_ -> numSyncs();
+    stream_ -> close();
+    stream_.reset();
+}
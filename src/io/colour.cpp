@@ -297,6 +297,6 @@ ColourPaletteProvider::fromJsonFile(std::string filename)
     auto doc = import(filename);
 
     // document parsing is handles by separate function:
-    return fromJsonDoc(doc);
+    return fromJsonDoc(doc.doc_);
 }
 
@@ -0,0 +1,168 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include "io/compressed_file_read_stream.hpp"
+
+
+/*!
+ * Constructor opens the given file for reading. The given buffer size is 
+ * used both for zlib's internal buffer and for reading chunks of data.
+ */
+CompressedFileReadStream::CompressedFileReadStream(
+        const std::string &fileName,
+        size_t bufferSize)
+    : fileName_(fileName)
+    , file_(nullptr)
+    , chunk_(bufferSize)
+{
+    // open file (zlib passes uncompressed files through unchanged):
+    file_ = gzopen(fileName_.c_str(), "rb");
+    if( file_ == nullptr )
+    {
+        throw std::runtime_error("Could not open file " + fileName_ + ".");
+    }
+    gzbuffer(file_, static_cast<unsigned int>(bufferSize));
+}
+
+
+/*!
+ * Destructor closes the file.
+ */
+CompressedFileReadStream::~CompressedFileReadStream()
+{
+    if( file_ != nullptr )
+    {
+        gzclose(file_);
+    }
+}
+
+
+/*!
+ * Reads the next line from the file into the given string, in analogy to 
+ * std::getline(). The newline character is not included. Returns false if 
+ * the end of file was reached before any character could be read.
+ */
+bool
+CompressedFileReadStream::getline(
+        std::string &line)
+{
+    line.clear();
+    bool readAny = false;
+
+    // read chunks until newline or end of file is encountered:
+    while( gzgets(file_, chunk_.data(), static_cast<int>(chunk_.size())) != 
+           nullptr )
+    {
+        readAny = true;
+        size_t len = std::strlen(chunk_.data());
+        if( len > 0 && chunk_[len - 1] == '\n' )
+        {
+            line.append(chunk_.data(), len - 1);
+            return true;
+        }
+        line.append(chunk_.data(), len);
+    }
+
+    // distinguish end of file from read error:
+    checkError();
+    return readAny;
+}
+
+
+/*!
+ * Reads the remainder of the file into a single string. Data is decompressed
+ * directly into the string's storage, which is presized from the file size so
+ * that uncompressed files are read without any intermediate copy or 
+ * reallocation.
+ */
+std::string
+CompressedFileReadStream::readAll()
+{
+    // estimate final size from size on disk (compressed JSON typically 
+    // inflates by a factor of a few):
+    size_t capacity = chunk_.size();
+    struct stat fileStat;
+    if( stat(fileName_.c_str(), &fileStat) == 0 && fileStat.st_size > 0 )
+    {
+        capacity = static_cast<size_t>(fileStat.st_size);
+        if( gzdirect(file_) == 0 )
+        {
+            capacity *= 4;
+        }
+        capacity += 1;
+    }
+
+    // read into string buffer, growing it geometrically where necessary:
+    std::string content(capacity, '\0');
+    size_t size = 0;
+    int len;
+    while( true )
+    {
+        if( size == content.size() )
+        {
+            content.resize(2*content.size());
+        }
+        size_t request = std::min(
+                content.size() - size,
+                static_cast<size_t>(std::numeric_limits<int>::max()));
+        len = gzread(file_, &content[size], static_cast<unsigned int>(request));
+        if( len <= 0 )
+        {
+            break;
+        }
+        size += len;
+    }
+
+    // check for read error:
+    if( len < 0 )
+    {
+        checkError();
+    }
+    content.resize(size);
+    return content;
+}
+
+
+/*!
+ * Throws an exception if the underlying zlib stream is in an error state.
+ */
+void
+CompressedFileReadStream::checkError()
+{
+    int errnum = Z_OK;
+    const char *msg = gzerror(file_, &errnum);
+    if( errnum != Z_OK )
+    {
+        throw std::runtime_error("Could not read file " + fileName_ + ": " + 
+                                 msg);
+    }
+}
+
@@ -0,0 +1,390 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "io/compressed_file_write_stream.hpp"
+
+
+/*!
+ * Constructor opens the given file for writing (truncating it if it already
+ * exists). The file is gzip compressed with the given compression level if 
+ * its name ends in .gz.
+ */
+CompressedFileWriteStream::CompressedFileWriteStream(
+        const std::string &fileName,
+        size_t bufferSize,
+        int compressionLevel)
+    : fileName_(fileName)
+    , file_(nullptr)
+    , compressed_(isCompressedFileName(fileName))
+    , activeBuffer_(0)
+    , deflateBuffer_(1 << 17)
+    , numSyncs_(0)
+    , pendingData_(nullptr)
+    , pendingSize_(0)
+    , hasPending_(false)
+    , stopWorker_(false)
+    , workerFailed_(false)
+{
+    // sanity check:
+    if( bufferSize == 0 )
+    {
+        throw std::logic_error("Output buffer size must be positive.");
+    }
+
+    // open file in binary mode:
+    file_ = std::fopen(fileName_.c_str(), "wb");
+    if( file_ == nullptr )
+    {
+        throw std::runtime_error("Could not open file " + fileName_ + " for "
+                                 "writing.");
+    }
+
+    // initialise gzip compression (window bits offset 16 selects gzip):
+    if( compressed_ )
+    {
+        zStream_.zalloc = Z_NULL;
+        zStream_.zfree = Z_NULL;
+        zStream_.opaque = Z_NULL;
+        int status = deflateInit2(
+                &zStream_, 
+                compressionLevel, 
+                Z_DEFLATED, 
+                15 + 16, 
+                8, 
+                Z_DEFAULT_STRATEGY);
+        if( status != Z_OK )
+        {
+            std::fclose(file_);
+            file_ = nullptr;
+            throw std::runtime_error("Could not initialise compression for "
+                                     "file " + fileName_ + ".");
+        }
+    }
+
+    // prepare buffers:
+    buffers_[0].resize(bufferSize);
+    buffers_[1].resize(bufferSize);
+    begin_ = buffers_[activeBuffer_].data();
+    current_ = begin_;
+    end_ = begin_ + bufferSize;
+}
+
+
+/*!
+ * Destructor releases all resources. Any buffered data is discarded if 
+ * close() has not been called.
+ */
+CompressedFileWriteStream::~CompressedFileWriteStream()
+{
+    release();
+}
+
+
+/*!
+ * Writes all buffered data to disk. For compressed files, a sync flush is 
+ * performed, so that all data written so far can be decompressed. As each 
+ * sync point costs some compression efficiency, this should only be called 
+ * occasionally rather than after every line.
+ */
+void
+CompressedFileWriteStream::sync()
+{
+    // sanity check:
+    if( file_ == nullptr )
+    {
+        throw std::logic_error("Can not sync closed file " + fileName_ + ".");
+    }
+
+    // wait for pending block and write current buffer synchronously:
+    waitForWorker();
+    writeBlock(begin_, current_ - begin_, Z_SYNC_FLUSH);
+    current_ = begin_;
+
+    // flush C library buffer:
+    if( workerFailed_ || std::fflush(file_) != 0 )
+    {
+        throw std::runtime_error("Could not write to file " + fileName_ + ".");
+    }
+    numSyncs_++;
+}
+
+
+/*!
+ * Writes a block of characters to the stream.
+ */
+void
+CompressedFileWriteStream::write(
+        const char *data, 
+        size_t size)
+{
+    while( size > 0 )
+    {
+        // make room in buffer if necessary:
+        if( current_ == end_ )
+        {
+            swapBuffers();
+        }
+
+        // copy as many characters as fit into buffer:
+        size_t n = std::min(size, static_cast<size_t>(end_ - current_));
+        std::copy(data, data + n, current_);
+        current_ += n;
+        data += n;
+        size -= n;
+    }
+}
+
+
+/*!
+ * Writes all remaining data, finalises the compressed stream, and closes the
+ * file. Throws an exception if any write operation failed.
+ */
+void
+CompressedFileWriteStream::close()
+{
+    // nothing to do if already closed:
+    if( file_ == nullptr )
+    {
+        return;
+    }
+
+    // write remaining data and finish compressed stream:
+    stopWorker();
+    writeBlock(begin_, current_ - begin_, Z_FINISH);
+    current_ = begin_;
+
+    // release resources and check for errors:
+    bool failed = workerFailed_ || std::ferror(file_);
+    if( compressed_ )
+    {
+        deflateEnd(&zStream_);
+    }
+    failed = (std::fclose(file_) != 0) || failed;
+    file_ = nullptr;
+    if( failed )
+    {
+        throw std::runtime_error("Could not write to file " + fileName_ + ".");
+    }
+}
+
+
+/*!
+ * Returns true if the output is gzip compressed.
+ */
+bool
+CompressedFileWriteStream::isCompressed() const
+{
+    return compressed_;
+}
+
+
+/*!
+ * Returns the number of times data has been forced to disk by sync().
+ */
+size_t
+CompressedFileWriteStream::numSyncs() const
+{
+    return numSyncs_;
+}
+
+
+/*!
+ * Returns true if the given file name indicates a gzip compressed file, i.e.
+ * if it ends in .gz.
+ */
+bool
+CompressedFileWriteStream::isCompressedFileName(
+        const std::string &fileName)
+{
+    const std::string ext = ".gz";
+    return fileName.size() >= ext.size() &&
+           fileName.compare(fileName.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+
+/*!
+ * Hands the current (full) buffer over to the worker thread and continues 
+ * with the other buffer. Waits for the worker to finish the previous block 
+ * first, so that at most one block is in flight.
+ */
+void
+CompressedFileWriteStream::swapBuffers()
+{
+    // previous block must be finished before its buffer can be reused:
+    waitForWorker();
+    if( workerFailed_ )
+    {
+        throw std::runtime_error("Could not write to file " + fileName_ + ".");
+    }
+
+    // start worker on first use:
+    if( !worker_.joinable() )
+    {
+        worker_ = std::thread(&CompressedFileWriteStream::workerLoop, this);
+    }
+
+    // write current buffer in background:
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        pendingData_ = begin_;
+        pendingSize_ = current_ - begin_;
+        hasPending_ = true;
+    }
+    workerCondition_.notify_all();
+
+    // continue with other buffer:
+    activeBuffer_ = 1 - activeBuffer_;
+    begin_ = buffers_[activeBuffer_].data();
+    current_ = begin_;
+    end_ = begin_ + buffers_[activeBuffer_].size();
+}
+
+
+/*!
+ * Blocks until the worker thread has finished writing its block.
+ */
+void
+CompressedFileWriteStream::waitForWorker()
+{
+    std::unique_lock<std::mutex> lock(workerMutex_);
+    workerCondition_.wait(lock, [this]{ return !hasPending_; });
+}
+
+
+/*!
+ * Lets the worker thread finish its block and terminates it.
+ */
+void
+CompressedFileWriteStream::stopWorker()
+{
+    if( !worker_.joinable() )
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(workerMutex_);
+        stopWorker_ = true;
+    }
+    workerCondition_.notify_all();
+    worker_.join();
+}
+
+
+/*!
+ * Main function of the worker thread, which writes each block handed over by
+ * swapBuffers() until stopWorker() is called.
+ */
+void
+CompressedFileWriteStream::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(workerMutex_);
+    while( true )
+    {
+        // wait for block or termination request:
+        workerCondition_.wait(
+                lock, 
+                [this]{ return hasPending_ || stopWorker_; });
+
+        // pending block is written before terminating:
+        if( hasPending_ )
+        {
+            lock.unlock();
+            writeBlock(pendingData_, pendingSize_, Z_NO_FLUSH);
+            lock.lock();
+            hasPending_ = false;
+            workerCondition_.notify_all();
+        }
+        else
+        {
+            return;
+        }
+    }
+}
+
+
+/*!
+ * Compresses (if required) and writes a block of data to the file. Runs on 
+ * the worker thread for full buffers. Errors are recorded in workerFailed_ 
+ * rather than thrown, as exceptions can not propagate out of a thread.
+ */
+void
+CompressedFileWriteStream::writeBlock(
+        const char *data, 
+        size_t size, 
+        int flushMode)
+{
+    // uncompressed output is written directly:
+    if( !compressed_ )
+    {
+        if( std::fwrite(data, 1, size, file_) != size )
+        {
+            workerFailed_ = true;
+        }
+        return;
+    }
+
+    // compress block in chunks of deflate buffer size:
+    zStream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zStream_.avail_in = static_cast<uInt>(size);
+    do
+    {
+        zStream_.next_out = deflateBuffer_.data();
+        zStream_.avail_out = static_cast<uInt>(deflateBuffer_.size());
+        if( deflate(&zStream_, flushMode) == Z_STREAM_ERROR )
+        {
+            workerFailed_ = true;
+            return;
+        }
+        size_t numOut = deflateBuffer_.size() - zStream_.avail_out;
+        if( std::fwrite(deflateBuffer_.data(), 1, numOut, file_) != numOut )
+        {
+            workerFailed_ = true;
+            return;
+        }
+    }
+    while( zStream_.avail_out == 0 );
+}
+
+
+/*!
+ * Releases all resources without error checking.
+ */
+void
+CompressedFileWriteStream::release()
+{
+    stopWorker();
+    if( file_ != nullptr )
+    {
+        if( compressed_ )
+        {
+            deflateEnd(&zStream_);
+        }
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
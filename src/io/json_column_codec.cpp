@@ -0,0 +1,355 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "io/json_column_codec.hpp"
+
+
+/*!
+ * Constructor sets the encoding and, for eColumnEncodingQuantised, the 
+ * quantum to which values are rounded. The quantum must be positive.
+ */
+JsonColumnCodec::JsonColumnCodec(
+        eColumnEncoding encoding,
+        real quantum)
+    : encoding_(encoding)
+    , quantum_(quantum)
+    , size_(0)
+    , previous_(0)
+    , data_(nullptr)
+    , sizeValue_(nullptr)
+{
+    // sanity check:
+    if( encoding_ == eColumnEncodingQuantised && !(quantum_ > 0.0) )
+    {
+        throw std::logic_error("Quantum of quantised column encoding must be "
+                               "positive.");
+    }
+}
+
+
+/*!
+ * Creates an empty column value in this codec's encoding. For plain columns
+ * this is an empty array, for all other encodings an object holding the 
+ * name of the encoding, any encoding parameters, and an empty data array. 
+ * The returned value must be added to the JSON document and then be passed to
+ * attach() before any values can be appended.
+ */
+rapidjson::Value
+JsonColumnCodec::makeColumn(
+        rapidjson::Document::AllocatorType &allocator) const
+{
+    rapidjson::Value column;
+
+    // plain columns are simple arrays:
+    if( encoding_ == eColumnEncodingPlain )
+    {
+        column.SetArray();
+        return column;
+    }
+
+    // other encodings need an object with metadata:
+    column.SetObject();
+    column.AddMember(
+            "encoding", 
+            rapidjson::StringRef(encodingName(encoding_)), 
+            allocator);
+    if( encoding_ == eColumnEncodingQuantised )
+    {
+        column.AddMember("quantum", quantum_, allocator);
+    }
+    if( encoding_ == eColumnEncodingBitPacked )
+    {
+        column.AddMember("size", 0u, allocator);
+    }
+    rapidjson::Value data;
+    data.SetArray();
+    column.AddMember("data", data, allocator);
+
+    return column;
+}
+
+
+/*!
+ * Caches pointers to the data array (and size field) of a column value 
+ * created by makeColumn() and resets the encoding state. Must be called again
+ * whenever the column value has been moved.
+ */
+void
+JsonColumnCodec::attach(
+        rapidjson::Value &column)
+{
+    if( encoding_ == eColumnEncodingPlain )
+    {
+        data_ = &column;
+        sizeValue_ = nullptr;
+    }
+    else
+    {
+        data_ = &column["data"];
+        sizeValue_ = column.HasMember("size") ? &column["size"] : nullptr;
+    }
+
+    clear();
+}
+
+
+/*!
+ * Removes all values from the column. The capacity of the data array is 
+ * retained, so that no memory is reallocated when the column is refilled.
+ */
+void
+JsonColumnCodec::clear()
+{
+    // sanity check:
+    if( data_ == nullptr )
+    {
+        throw std::logic_error("Can not clear column that is not attached to "
+                               "a JSON value.");
+    }
+
+    // reset data and encoding state:
+    data_ -> Clear();
+    if( sizeValue_ != nullptr )
+    {
+        sizeValue_ -> SetUint(0);
+    }
+    size_ = 0;
+    previous_ = 0;
+}
+
+
+/*!
+ * Appends a value to the column, encoding it on the fly.
+ */
+void
+JsonColumnCodec::append(
+        double value,
+        rapidjson::Document::AllocatorType &allocator)
+{
+    // sanity check:
+    if( data_ == nullptr )
+    {
+        throw std::logic_error("Can not append to column that is not attached "
+                               "to a JSON value.");
+    }
+
+    switch( encoding_ )
+    {
+        case eColumnEncodingPlain:
+        {
+            rapidjson::Value val(value);
+            data_ -> PushBack(val, allocator);
+            break;
+        }
+        case eColumnEncodingQuantised:
+        {
+            rapidjson::Value val( 
+                    static_cast<int64_t>(std::llround(value/quantum_)) );
+            data_ -> PushBack(val, allocator);
+            break;
+        }
+        case eColumnEncodingDelta:
+        {
+            int64_t current = std::llround(value);
+            rapidjson::Value val(current - previous_);
+            data_ -> PushBack(val, allocator);
+            previous_ = current;
+            break;
+        }
+        case eColumnEncodingBitPacked:
+        {
+            // start new word every 32 values:
+            size_t bit = size_ % 32;
+            if( bit == 0 )
+            {
+                rapidjson::Value word(0u);
+                data_ -> PushBack(word, allocator);
+            }
+
+            // set bit in last word for true values:
+            if( value != 0.0 )
+            {
+                rapidjson::Value &word = (*data_)[data_ -> Size() - 1];
+                word.SetUint(word.GetUint() | (1u << bit));
+            }
+            sizeValue_ -> SetUint(size_ + 1);
+            break;
+        }
+    }
+
+    size_++;
+}
+
+
+/*!
+ * Decodes a column value into a vector of numbers. Plain JSON arrays are 
+ * accepted as well as objects written in any of the encodings supported by
+ * JsonColumnCodec. The output vector is overwritten, but its capacity is 
+ * retained, so that it can be reused across frames.
+ */
+void
+JsonColumnCodec::decode(
+        const rapidjson::Value &column,
+        std::vector<real> &values)
+{
+    values.clear();
+
+    // plain array:
+    if( column.IsArray() )
+    {
+        values.reserve(column.Size());
+        for(auto it = column.Begin(); it != column.End(); it++)
+        {
+            values.push_back(it -> GetDouble());
+        }
+        return;
+    }
+
+    // sanity checks:
+    if( !column.IsObject() || 
+        !column.HasMember("encoding") || 
+        !column["encoding"].IsString() ||
+        !column.HasMember("data") ||
+        !column["data"].IsArray() )
+    {
+        throw std::runtime_error("JSON column is neither an array nor an "
+                                 "encoded column object.");
+    }
+    const rapidjson::Value &data = column["data"];
+    const char *encoding = column["encoding"].GetString();
+
+    // decode according to encoding:
+    if( std::strcmp(encoding, encodingName(eColumnEncodingQuantised)) == 0 )
+    {
+        double quantum = column["quantum"].GetDouble();
+        values.reserve(data.Size());
+        for(auto it = data.Begin(); it != data.End(); it++)
+        {
+            values.push_back(quantum*it -> GetInt64());
+        }
+    }
+    else if( std::strcmp(encoding, encodingName(eColumnEncodingDelta)) == 0 )
+    {
+        int64_t current = 0;
+        values.reserve(data.Size());
+        for(auto it = data.Begin(); it != data.End(); it++)
+        {
+            current += it -> GetInt64();
+            values.push_back(current);
+        }
+    }
+    else if( std::strcmp(encoding, encodingName(eColumnEncodingBitPacked)) == 0 )
+    {
+        size_t size = column["size"].GetUint();
+        if( size > 32*data.Size() )
+        {
+            throw std::runtime_error("Bit-packed JSON column holds fewer "
+                                     "values than its size indicates.");
+        }
+        values.reserve(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            unsigned int word = data[i/32].GetUint();
+            values.push_back( (word >> (i % 32)) & 1u );
+        }
+    }
+    else
+    {
+        throw std::runtime_error("Unknown JSON column encoding '" + 
+                                 std::string(encoding) + "'.");
+    }
+}
+
+
+/*!
+ * Convenience overload of decode() that returns a new vector.
+ */
+std::vector<real>
+JsonColumnCodec::decode(
+        const rapidjson::Value &column)
+{
+    std::vector<real> values;
+    decode(column, values);
+    return values;
+}
+
+
+/*!
+ * Returns the encoding used by this codec.
+ */
+eColumnEncoding
+JsonColumnCodec::encoding() const
+{
+    return encoding_;
+}
+
+
+/*!
+ * Returns the quantum to which values are rounded in quantised encoding.
+ */
+real
+JsonColumnCodec::quantum() const
+{
+    return quantum_;
+}
+
+
+/*!
+ * Returns the number of values appended since the last call to clear().
+ */
+size_t
+JsonColumnCodec::size() const
+{
+    return size_;
+}
+
+
+/*!
+ * Returns the name under which an encoding is recorded in the JSON output.
+ */
+const char*
+JsonColumnCodec::encodingName(
+        eColumnEncoding encoding)
+{
+    switch( encoding )
+    {
+        case eColumnEncodingPlain:
+            return "plain";
+        case eColumnEncodingQuantised:
+            return "quantised";
+        case eColumnEncodingDelta:
+            return "delta";
+        case eColumnEncodingBitPacked:
+            return "bits";
+    }
+
+    return "plain";
+}
+
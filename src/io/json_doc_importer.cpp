@@ -22,42 +22,31 @@
 // THE SOFTWARE.
 
 
-#include <fstream>
 #include <exception>
 #include <stdexcept>
-#include <sstream>
-#include <iostream>
 
+#include "io/compressed_file_read_stream.hpp"
 #include "io/json_doc_importer.hpp"
 
 
 /*!
- * Returns a JSON document corresponding to the given JSON file.
+ * Returns a JSON document corresponding to the given JSON file. The file may
+ * be gzip compressed. The document is returned together with the file content
+ * buffer it references.
  */
-rapidjson::Document
+ImportedJsonDoc
 JsonDocImporter::operator()(std::string fileName)
 {
-    // read entire file into memory:
-    std::stringstream ss;
-    std::ifstream file;
-    file.open(fileName.c_str());
+    // read entire file into memory (throws if file can not be opened):
+    ImportedJsonDoc json;
+    json.buffer_.reset(
+            new std::string(CompressedFileReadStream(fileName).readAll()));
 
-    // make sure file could be opened:
-    if( !file.is_open() )
-    {
-        throw std::runtime_error("ERROR: Could not open file " + fileName + ".");
-    }
-
-    // read file into string stream:
-    ss << file.rdbuf();
-    file.close();
-
-    // create JSON document from file:
-    rapidjson::Document json;
-    json.Parse<0>(ss.str().c_str());
+    // create JSON document from file, parsing in place to avoid copying:
+    json.doc_.ParseInsitu(&(*json.buffer_)[0]);
 
     // check validity of JSON object:
-    if( json.IsObject() == false )
+    if( json.doc_.IsObject() == false )
     {
         throw std::invalid_argument("Invalid JSON object.");
     }
@@ -65,4 +54,3 @@ JsonDocImporter::operator()(std::string fileName)
     // return JSON document:
     return json;
 }
-
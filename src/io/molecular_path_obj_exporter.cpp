@@ -23,9 +23,13 @@
 
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <exception>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #include <gromacs/math/vec.h>
@@ -35,6 +39,9 @@
 
 #include "geometry/cubic_spline_interp_3D.hpp"
 
+#include "io/ply_io.hpp"
+#include "io/surface_mesh_sequence_exporter.hpp"
+
 
 /*!
  * Constructor initialises the \f$ s \f$ and \f$ \phi \f$ coordinates of the 
@@ -50,6 +57,53 @@ RegularVertexGrid::RegularVertexGrid(
 }
 
 
+/*!
+ * Registers a property with the grid and returns its integer id. If the 
+ * property is already known, its existing id is returned. Storage for all
+ * vertices of a new property is allocated at once.
+ */
+size_t
+RegularVertexGrid::addProperty(
+        std::string p)
+{
+    // property already interned?
+    auto it = propIds_.find(p);
+    if( it != propIds_.end() )
+    {
+        return it -> second;
+    }
+
+    // assign next id and allocate dense storage:
+    size_t propId = propNames_.size();
+    size_t numVert = s_.size()*phi_.size();
+    propIds_[p] = propId;
+    propNames_.push_back(p);
+    vertices_.push_back(std::vector<gmx::RVec>(numVert));
+    weights_.push_back(std::vector<real>(numVert));
+    hasVertex_.push_back(std::vector<bool>(numVert, false));
+    numVertices_.push_back(0);
+
+    return propId;
+}
+
+
+/*!
+ * Returns the integer id of a previously added property.
+ */
+size_t
+RegularVertexGrid::propertyId(
+        std::string p) const
+{
+    auto it = propIds_.find(p);
+    if( it == propIds_.end() )
+    {
+        throw std::logic_error("Unknown property " + p + " in "
+                               "RegularVertexGrid.");
+    }
+    return it -> second;
+}
+
+
 /*!
  * Adds a vertex at the given coordinates for the given property.
  */
@@ -60,6 +114,21 @@ RegularVertexGrid::addVertex(
         std::string p,
         gmx::RVec vertex, 
         real weight)
+{
+    addVertex(i, j, addProperty(p), vertex, weight);
+}
+
+
+/*!
+ * Adds a vertex at the given coordinates for the property with the given id.
+ */
+void
+RegularVertexGrid::addVertex(
+        size_t i, 
+        size_t j,
+        size_t propId,
+        gmx::RVec vertex, 
+        real weight)
 {
     // TODO: this situation should really be handled by a NaN colour
     if( std::isnan(weight) )
@@ -67,10 +136,29 @@ RegularVertexGrid::addVertex(
         weight = 0.5;
     }
 
-    p_.insert(p);
-    std::tuple<size_t, size_t, std::string> key(i, j, p);
-    vertices_[key] = vertex;
-    weights_[key] = weight;
+    size_t idx = linearIndex(i, j);
+    vertices_.at(propId).at(idx) = vertex;
+    weights_[propId][idx] = weight;
+    if( !hasVertex_[propId][idx] )
+    {
+        hasVertex_[propId][idx] = true;
+        numVertices_[propId]++;
+    }
+}
+
+
+/*!
+ * Throws an exception if not all vertices of the given property have been 
+ * added to the grid.
+ */
+void
+RegularVertexGrid::checkComplete(
+        size_t propId) const
+{
+    if( numVertices_.at(propId) != s_.size()*phi_.size() )
+    {
+        throw std::logic_error("Invalid vertex reference encountered.");
+    }
 }
 
 
@@ -81,26 +169,9 @@ std::vector<gmx::RVec>
 RegularVertexGrid::vertices(
         std::string p)
 {
-    // build linearly indexed vector from dual indexed map:
-    std::vector<gmx::RVec> vert;
-    vert.reserve(vertices_.size());
-    for(size_t i = 0; i < s_.size(); i++)
-    {
-        for(size_t j = 0; j < phi_.size(); j++)
-        {
-            std::tuple<size_t, size_t, std::string> key(i, j, p);
-            if( vertices_.find(key) != vertices_.end() )
-            {
-                vert.push_back(vertices_[key]); 
-            }
-            else
-            {
-                throw std::logic_error("Invalid vertex reference encountered.");
-            }
-        }
-    }
-
-    return vert;
+    size_t propId = propertyId(p);
+    checkComplete(propId);
+    return vertices_[propId];
 }
 
 
@@ -111,26 +182,13 @@ std::vector<gmx::RVec>
 RegularVertexGrid::normals(
         std::string p)
 {
-    std::vector<gmx::RVec> norm;
-    norm.reserve(normals_.size());
-    for(size_t i = 0; i < s_.size(); i++)
+    size_t propId = propertyId(p);
+    if( propId >= normals_.size() )
     {
-        for(size_t j = 0; j < phi_.size(); j++)
-        {
-            std::tuple<size_t, size_t, std::string> key(i, j, p);
-            if( normals_.find(key) != normals_.end() )
-            {
-                norm.push_back(normals_[key]); 
-            }
-            else
-            {
-                throw std::logic_error("Invalid vertex normal reference "
-                                       "encountered.");
-            }
-        }
+        throw std::logic_error("Invalid vertex normal reference "
+                               "encountered.");
     }
-
-    return norm;
+    return normals_[propId];
 }
 
 
@@ -144,62 +202,38 @@ RegularVertexGrid::normalsFromFaces()
     int mI = s_.size();
     int mJ = phi_.size();
 
-    for(auto p : p_)
+    normals_.resize(propNames_.size());
+    for(size_t propId = 0; propId < propNames_.size(); propId++)
     {
-        for(int i = 0; i < s_.size(); i++)
+        checkComplete(propId);
+        const std::vector<gmx::RVec> &vert = vertices_[propId];
+        std::vector<gmx::RVec> &norms = normals_[propId];
+        norms.resize(vert.size());
+
+        for(int i = 0; i < mI; i++)
         {
-            for(int j = 0; j < phi_.size(); j++)
+            // neighbouring rings (endpoints along spline map onto themselves):
+            int iUppr = (i == mI - 1) ? i : i + 1;
+            int iLowr = (i == 0) ? i : i - 1;
+
+            for(int j = 0; j < mJ; j++)
             {
-                // index pairs for neighbouring vertices:
-                std::tuple<size_t, size_t, std::string> crntKey(
-                        i, 
-                        j,
-                        p);
-                std::tuple<size_t, size_t, std::string> leftKey(
-                        i, 
-                        (j - 1 + mJ) % mJ,
-                        p);
-                std::tuple<size_t, size_t, std::string> rghtKey(
-                        i, 
-                        (j + 1 + mJ) % mJ,
-                        p);
-                std::tuple<size_t, size_t, std::string> upprKey(
-                        (i + 1 + mI) % mI, 
-                        j,
-                        p);
-                std::tuple<size_t, size_t, std::string> lowrKey((
-                        i - 1 + mI) % mI, 
-                        j,
-                        p);
-                std::tuple<size_t, size_t, std::string> dglrKey(
-                        (i - 1 + mI) % mI, 
-                        (j + 1 + mJ) % mJ,
-                        p);
-                std::tuple<size_t, size_t, std::string> dgulKey(
-                        (i + 1 + mI) % mI, 
-                        (j - 1 + mJ) % mJ,
-                        p);
-
-                // handle endpoints in direction along spline:
-                if( i == 0 )
-                {
-                    lowrKey = crntKey; 
-                    dglrKey = crntKey;
-                }
-                if( i == s_.size() - 1 )
-                {
-                    upprKey = crntKey;
-                    dgulKey = crntKey;
-                }
+                // neighbouring indices in direction of angle:
+                int jLeft = (j - 1 + mJ) % mJ;
+                int jRght = (j + 1) % mJ;
 
                 // neighbouring vertices:
-                gmx::RVec crntVert = vertices_.at(crntKey);
-                gmx::RVec leftVert = vertices_.at(leftKey);
-                gmx::RVec rghtVert = vertices_.at(rghtKey);
-                gmx::RVec upprVert = vertices_.at(upprKey);
-                gmx::RVec lowrVert = vertices_.at(lowrKey);
-                gmx::RVec dglrVert = vertices_.at(dglrKey);
-                gmx::RVec dgulVert = vertices_.at(dgulKey);
+                const gmx::RVec &crntVert = vert[linearIndex(i, j)];
+                const gmx::RVec &leftVert = vert[linearIndex(i, jLeft)];
+                const gmx::RVec &rghtVert = vert[linearIndex(i, jRght)];
+                const gmx::RVec &upprVert = vert[linearIndex(iUppr, j)];
+                const gmx::RVec &lowrVert = vert[linearIndex(iLowr, j)];
+                const gmx::RVec &dglrVert = (i == 0) 
+                                          ? crntVert 
+                                          : vert[linearIndex(iLowr, jRght)];
+                const gmx::RVec &dgulVert = (i == mI - 1) 
+                                          ? crntVert 
+                                          : vert[linearIndex(iUppr, jLeft)];
 
                 // initialise normal as null vector:
                 gmx::RVec norm(0.0, 0.0, 0.0);
@@ -240,7 +274,7 @@ RegularVertexGrid::normalsFromFaces()
                 unitv(norm, norm);
                 
                 // add to container of normals:
-                normals_[crntKey] = norm;
+                norms[linearIndex(i, j)] = norm;
             }
         }
     }
@@ -254,28 +288,20 @@ std::vector<std::pair<gmx::RVec, real>>
 RegularVertexGrid::weightedVertices(
         std::string p)
 {
-    // build linearly indexed vector from dual indexed map:
-    std::vector<std::pair<gmx::RVec, real>> vert;
-    vert.reserve(vertices_.size());
-    for(size_t i = 0; i < s_.size(); i++)
+    size_t propId = propertyId(p);
+    checkComplete(propId);
+
+    // combine vertex and weight arrays:
+    const std::vector<gmx::RVec> &vert = vertices_[propId];
+    const std::vector<real> &wght = weights_[propId];
+    std::vector<std::pair<gmx::RVec, real>> weighted;
+    weighted.reserve(vert.size());
+    for(size_t k = 0; k < vert.size(); k++)
     {
-        for(size_t j = 0; j < phi_.size(); j++)
-        {
-            std::tuple<size_t, size_t, std::string> key(i, j, p);
-            if( vertices_.find(key) != vertices_.end() && 
-                weights_.find(key) != weights_.end() )
-            {
-                std::pair<gmx::RVec, real> vertex(vertices_[key], weights_[key]);
-                vert.push_back(vertex); 
-            }
-            else
-            {
-                throw std::logic_error("Invalid vertex reference encountered.");
-            }
-        }
+        weighted.push_back(std::pair<gmx::RVec, real>(vert[k], wght[k])); 
     }
 
-    return vert;
+    return weighted;
 }
 
 
@@ -313,10 +339,13 @@ RegularVertexGrid::faces(
         std::string p)
 {
     // sanity checks:
-    if( phi_.size() * s_.size() * p_.size() != vertices_.size() )
+    for(size_t propId = 0; propId < propNames_.size(); propId++)
     {
-        throw std::logic_error("RegularVertexGrid cannot generate faces "
-                               "on incomplete grid.");
+        if( numVertices_[propId] != s_.size()*phi_.size() )
+        {
+            throw std::logic_error("RegularVertexGrid cannot generate faces "
+                                   "on incomplete grid.");
+        }
     }
 
     if( !normals_.empty() && normals_.size() != vertices_.size() )
@@ -328,15 +357,18 @@ RegularVertexGrid::faces(
     // find scalar property data range:
     real minRange = std::numeric_limits<real>::max();
     real maxRange = std::numeric_limits<real>::min();
-    for(auto it = weights_.begin(); it != weights_.end(); it++)
+    for(auto &propWeights : weights_)
     {
-        if( it -> second < minRange )
-        {
-            minRange = it -> second;
-        }
-        if( it -> second > maxRange )
+        for(auto w : propWeights)
         {
-            maxRange = it -> second;
+            if( w < minRange )
+            {
+                minRange = w;
+            }
+            if( w > maxRange )
+            {
+                maxRange = w;
+            }
         }
     }
 
@@ -347,86 +379,35 @@ RegularVertexGrid::faces(
     colourScales_.insert(std::pair<std::string, ColourScale>(p, colScale));
 
     // number of vertices per property grid:
-    size_t propIdx = std::distance(p_.begin(), find(p_.begin(), p_.end(), p));
+    size_t propIdx = propertyId(p);
     size_t vertOffset = s_.size() * phi_.size() * propIdx;
+    const std::vector<real> &weights = weights_[propIdx];
 
     // preallocate face vector:
     std::vector<WavefrontObjFace> faces;
-    faces.reserve(phi_.size()*s_.size());
+    faces.reserve(2*phi_.size()*s_.size());
 
-    // loop over grid:
-    for(size_t i = 0; i < s_.size() - 1; i++)
+    // adds the two triangular faces of the grid square with lower left 
+    // corner (i, j), with the neighbour in angular direction wrapping around:
+    auto addSquare = [&](size_t i, size_t j)
     {
-        for(size_t j = 0; j < phi_.size() - 1; j++)
-        {
-            // calculate linear indices:
-            int kbl = vertOffset + i * phi_.size() + j; 
-            int kbr = kbl + 1;
-            int ktl = kbl + phi_.size();
-            int ktr = kbr + phi_.size();
-
-            // vertex keys:
-            std::tuple<size_t, size_t, std::string> keyBl(i,     j,     p);
-            std::tuple<size_t, size_t, std::string> keyBr(i,     j + 1, p);
-            std::tuple<size_t, size_t, std::string> keyTl(i + 1, j,     p);
-            std::tuple<size_t, size_t, std::string> keyTr(i + 1, j + 1, p);
-
-            // face weight is average of vertex weights:
-            real scalarA = weights_.at(keyBl) 
-                         + weights_.at(keyTr) 
-                         + weights_.at(keyTl);
-            real scalarB = weights_.at(keyBl) 
-                         + weights_.at(keyBr) 
-                         + weights_.at(keyTr);
-            scalarA /= 3.0;
-            scalarB /= 3.0;
-
-            // name of material from colour scale:
-            std::string mtlNameA = colScale.scalarToColourName(scalarA); 
-            std::string mtlNameB = colScale.scalarToColourName(scalarB); 
-
-            // two faces per square:
-            if( normals_.empty() )
-            {
-                faces.push_back( WavefrontObjFace(
-                        {kbl + 1, ktr + 1, ktl + 1},
-                        mtlNameA) );
-                faces.push_back( WavefrontObjFace(
-                        {kbl + 1, kbr + 1, ktr + 1},
-                        mtlNameB) );
-            }
-            else
-            {
-                faces.push_back( WavefrontObjFace(
-                        {kbl + 1, ktr + 1, ktl + 1},
-                        {kbl + 1, ktr + 1, ktl + 1},
-                        mtlNameA) );
-                faces.push_back( WavefrontObjFace(
-                        {kbl + 1, kbr + 1, ktr + 1},
-                        {kbl + 1, kbr + 1, ktr + 1},
-                        mtlNameB) );
-            }
-        }
-    }
+        size_t jNext = (j + 1) % phi_.size();
 
-    // wrap around:
-    for(size_t i = 0; i < s_.size() - 1; i++)
-    {
-        // calculate linear indices:
-        int kbl = vertOffset + i*phi_.size() + phi_.size() - 1; 
-        int kbr = vertOffset + i*phi_.size();
-        int ktl = kbl + phi_.size();
-        int ktr = kbr + phi_.size();
+        // indices within property grid:
+        size_t bl = linearIndex(i,     j);
+        size_t br = linearIndex(i,     jNext);
+        size_t tl = linearIndex(i + 1, j);
+        size_t tr = linearIndex(i + 1, jNext);
 
-        // vertex keys:
-        std::tuple<size_t, size_t, std::string> keyBl(i, phi_.size() - 1, p);
-        std::tuple<size_t, size_t, std::string> keyBr(i, 0, p);
-        std::tuple<size_t, size_t, std::string> keyTl(i + 1, phi_.size() - 1, p);
-        std::tuple<size_t, size_t, std::string> keyTr(i + 1, 0, p);
+        // calculate linear indices:
+        int kbl = vertOffset + bl; 
+        int kbr = vertOffset + br;
+        int ktl = vertOffset + tl;
+        int ktr = vertOffset + tr;
 
         // face weight is average of vertex weights:
-        real scalarA = weights_[keyBl] + weights_[keyTr] + weights_[keyTl];
-        real scalarB = weights_[keyBl] + weights_[keyBr] + weights_[keyTr];
+        real scalarA = weights[bl] + weights[tr] + weights[tl];
+        real scalarB = weights[bl] + weights[br] + weights[tr];
         scalarA /= 3.0;
         scalarB /= 3.0;
 
@@ -446,7 +427,6 @@ RegularVertexGrid::faces(
         }
         else
         {
-
             faces.push_back( WavefrontObjFace(
                     {kbl + 1, ktr + 1, ktl + 1},
                     {kbl + 1, ktr + 1, ktl + 1},
@@ -456,6 +436,21 @@ RegularVertexGrid::faces(
                     {kbl + 1, kbr + 1, ktr + 1},
                     mtlNameB) );
         }
+    };
+
+    // loop over grid:
+    for(size_t i = 0; i < s_.size() - 1; i++)
+    {
+        for(size_t j = 0; j < phi_.size() - 1; j++)
+        {
+            addSquare(i, j);
+        }
+    }
+
+    // wrap around:
+    for(size_t i = 0; i < s_.size() - 1; i++)
+    {
+        addSquare(i, phi_.size() - 1);
     }
 
     // return face vector:
@@ -471,6 +466,10 @@ MolecularPathObjExporter::MolecularPathObjExporter()
     : extrapDist_(0.0)
     , gridSampleDist_(-1.0)
     , correctionThreshold_(0.1)
+    , numThreads_(std::max(std::thread::hardware_concurrency(), 1u))
+    , numLen_(std::pow(2, 8) + 1)
+    , numPhi_(50)
+    , writePly_(false)
 {
     
 }
@@ -520,6 +519,88 @@ MolecularPathObjExporter::setCorrectionThreshold(real correctionThreshold)
 }
 
 
+/*!
+ * Sets whether the surface is in addition written to a binary PLY file, in
+ * which all scalar properties are attached to a single set of vertices.
+ */
+void
+MolecularPathObjExporter::setWritePly(bool writePly)
+{
+    writePly_ = writePly;
+}
+
+
+/*!
+ * Sets the number of threads used for generating the surface mesh. A value
+ * of zero selects the number of hardware threads.
+ */
+void
+MolecularPathObjExporter::setNumThreads(int numThreads)
+{
+    if( numThreads < 0 )
+    {
+        throw std::runtime_error("Number of threads for "
+                                 "MolecularPathObjExporter must not be "
+                                 "negative!");
+    }
+    else if( numThreads == 0 )
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    numThreads_ = numThreads;
+}
+
+
+/*!
+ * Returns the wall clock time in seconds spent in each stage of the last 
+ * export, i.e. in generating vertex rings, interpolating the surface, 
+ * sampling the properties, building the mesh, and writing the output files.
+ */
+std::map<std::string, double>
+MolecularPathObjExporter::timings() const
+{
+    return timings_;
+}
+
+
+/*!
+ * Returns the surface grid resolution as the number of vertex rings along 
+ * the pathway and the number of vertices per ring.
+ */
+std::pair<size_t, size_t>
+MolecularPathObjExporter::resolution() const
+{
+    return std::pair<size_t, size_t>(numLen_, numPhi_);
+}
+
+
+/*!
+ * Returns the vertices of the pathway surface without any scalar properties
+ * attached, in nm and ordered ring by ring. The grid is the same as the one 
+ * written to the OBJ file, so that this can be used for exporting the 
+ * surface of individual frames with a shared triangulation.
+ */
+std::vector<gmx::RVec>
+MolecularPathObjExporter::surfaceVertices(
+        MolecularPath &molPath)
+{
+    timings_.clear();
+
+    // define evaluation range:   
+    std::pair<real, real> range(molPath.sLo() - extrapDist_,
+                                molPath.sHi() + extrapDist_);
+
+    // generate grid coordinates and surface:
+    std::vector<real> s;
+    std::vector<real> phi;
+    gridCoordinates(resolution(), range, s, phi);
+    auto centreLine = molPath.centreLine();
+    auto pathRadius = molPath.pathRadius();
+    return generateSurface(centreLine, pathRadius, s, phi);
+}
+
+
 /*!
  * High level driver for exporting a MolecularPath object to an OBJ and MTL
  * file.
@@ -536,10 +617,7 @@ MolecularPathObjExporter::operator()(
                                 molPath.sHi() + extrapDist_);
 
     // define resolution:
-    // TODO: make this a parameter?
-    int numPhi = 50;
-    int numLen = std::pow(2, 8) + 1;
-    std::pair<size_t, size_t> resolution(numLen, numPhi);
+    std::pair<size_t, size_t> resolution = this -> resolution();
     
     // pathway geometry:
     auto centreLine = molPath.centreLine();
@@ -554,6 +632,9 @@ MolecularPathObjExporter::operator()(
     // Build OBJ & MTL Objects of Coloured Pore Surface
     //-------------------------------------------------------------------------
 
+    // reset timing information:
+    timings_.clear();
+
     // prepare objects:
     WavefrontObjObject obj(objectName);
     WavefrontMtlObject mtl;
@@ -566,11 +647,14 @@ MolecularPathObjExporter::operator()(
             resolution,
             range);
 
+    // vertex normals for all properties:
+    auto start = std::chrono::steady_clock::now();
+    grid.normalsFromFaces();
+
     // loop over properties:
     for(auto prop : properties)
     {
         // obtain vertices, normals, and faces from grid:
-        grid.normalsFromFaces();
         auto vertices = grid.weightedVertices(prop.first);
         auto vertexNormals = grid.normals(prop.first);
         auto faces = grid.faces(prop.first);
@@ -624,8 +708,13 @@ MolecularPathObjExporter::operator()(
     }
 
 
+    recordTiming("mesh", start);
+
+
     // Serialise OBJ & MTL Objects
     //-------------------------------------------------------------------------
+
+    start = std::chrono::steady_clock::now();
     
     // add file extensions to base name:
     std::string objFileName = fileName + ".obj";
@@ -645,13 +734,125 @@ MolecularPathObjExporter::operator()(
     // create an MTL exporter and write to file:
     WavefrontMtlExporter mtlExp;
     mtlExp.write(mtlFileName, mtl);
+
+    // optionally write same mesh to binary PLY file:
+    if( writePly_ )
+    {
+        // geometry is shared by all properties, take it from first group:
+        size_t numVert = numLen_*numPhi_;
+        std::vector<gmx::RVec> vertices;
+        vertices.reserve(numVert);
+        std::vector<gmx::RVec> normals;
+        if( obj.normals_.size() >= numVert )
+        {
+            normals.assign(
+                    obj.normals_.begin(), 
+                    obj.normals_.begin() + numVert);
+        }
+        for(size_t k = 0; k < numVert; k++)
+        {
+            vertices.push_back(obj.vertices_[k].first);
+        }
+
+        // one vertex property per group:
+        std::vector<std::pair<std::string, std::vector<real>>> props;
+        for(size_t p = 0; p < obj.groups_.size(); p++)
+        {
+            std::vector<real> weights;
+            weights.reserve(numVert);
+            for(size_t k = 0; k < numVert; k++)
+            {
+                weights.push_back(obj.vertices_[p*numVert + k].second);
+            }
+            props.push_back(std::make_pair(obj.groups_[p].groupname_, weights));
+        }
+
+        PlyExporter plyExp;
+        plyExp.write(
+                fileName + ".ply",
+                vertices,
+                normals,
+                props,
+                SurfaceMeshSequenceExporter::triangles(numLen_, numPhi_));
+    }
+    recordTiming("output", start);
+}
+
+
+/*!
+ * Auxiliary function that calls the given function for all indices in 
+ * \f$ [0, n) \f$, distributing the indices over numThreads_ threads in a 
+ * strided fashion. The calling thread processes the first stride itself, so
+ * that only numThreads_ - 1 threads are launched. The function must only 
+ * write to memory associated with its index. The first exception thrown in 
+ * any thread is rethrown after all threads have finished.
+ */
+template<typename Function>
+void
+MolecularPathObjExporter::parallelFor(
+        size_t n,
+        Function func)
+{
+    // serial execution for small problems or single thread:
+    size_t numThreads = std::min(static_cast<size_t>(numThreads_), n);
+    if( numThreads <= 1 )
+    {
+        for(size_t i = 0; i < n; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    // processes one stride of indices and records errors:
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto stride = [&](size_t t)
+    {
+        try
+        {
+            for(size_t i = t; i < n; i += numThreads)
+            {
+                func(i);
+            }
+        }
+        catch(...)
+        {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    // launch worker threads for all but the first stride:
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for(size_t t = 1; t < numThreads; t++)
+    {
+        threads.push_back(std::thread(stride, t));
+    }
+
+    // first stride is processed on calling thread:
+    stride(0);
+
+    // wait for completion and forward errors:
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+    for(auto &error : errors)
+    {
+        if( error )
+        {
+            std::rethrow_exception(error);
+        }
+    }
 }
 
 
 /*!
  * Creates a regular vertex grid from a given centre line and radius spline.
- * This function loops over all given properties and for each property calls
- * generatePropertyGrid().
+ * The surface geometry depends only on centre line and radius and is hence
+ * generated only once by generateSurface(). Each property then only needs to
+ * be sampled along the grid coordinate, which is done in parallel over all
+ * properties.
  */
 RegularVertexGrid
 MolecularPathObjExporter::generateGrid(
@@ -660,6 +861,76 @@ MolecularPathObjExporter::generateGrid(
         std::map<std::string, std::pair<SplineCurve1D, bool>> &properties,
         std::pair<size_t, size_t> resolution,
         std::pair<real, real> range)
+{
+    // generate grid coordinates:
+    std::vector<real> s;
+    std::vector<real> phi;
+    gridCoordinates(resolution, range, s, phi);
+
+    // generate grid from coordinates:
+    RegularVertexGrid grid(s, phi);
+
+    // generate surface vertices shared by all properties:
+    std::vector<gmx::RVec> surface = generateSurface(
+            centreLine,
+            radius,
+            s,
+            phi);
+
+    // sample each property along the path and rescale to unit interval:
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<const std::string, std::pair<SplineCurve1D, bool>>*> 
+            props;
+    for(auto &prop : properties)
+    {
+        props.push_back(&prop);
+    }
+    std::vector<std::vector<real>> propValues(props.size());
+    parallelFor(props.size(), [&](size_t p)
+    {
+        SplineCurve1D &spl = props[p] -> second.first;
+        propValues[p].reserve(s.size());
+        for(size_t i = 0; i < s.size(); i++)
+        {
+            propValues[p].push_back( spl.evaluate(s[i], 0) );
+        }
+        shiftAndScale(propValues[p], props[p] -> second.second);
+    });
+
+    // add vertices for each property:
+    for(size_t p = 0; p < props.size(); p++)
+    {
+        size_t propId = grid.addProperty(props[p] -> first);
+        for(size_t i = 0; i < s.size(); i++)
+        {
+            for(size_t k = 0; k < phi.size(); k++)
+            {
+                grid.addVertex(
+                        i, 
+                        k, 
+                        propId, 
+                        surface[i*phi.size() + k],
+                        propValues[p][i]);
+            }
+        }
+    }
+    recordTiming("properties", start);
+
+    // return the overall grid:
+    return grid;
+}
+
+
+/*!
+ * Creates the coordinates along the pathway and in angular direction of a 
+ * grid with the given resolution over the given range.
+ */
+void
+MolecularPathObjExporter::gridCoordinates(
+        std::pair<size_t, size_t> resolution,
+        std::pair<real, real> range,
+        std::vector<real> &s,
+        std::vector<real> &phi)
 {
     // extract resolution:
     size_t numLen = resolution.first;
@@ -674,65 +945,64 @@ MolecularPathObjExporter::generateGrid(
     }
 
     // generate grid coordinates:
-    std::vector<real> s;
+    s.clear();
     s.reserve(numLen);
     for(int i = 0; i < numLen; i++)
     {
         s.push_back(i*(range.second - range.first)/numLen + range.first);
     }
-    std::vector<real> phi;
+    phi.clear();
     phi.reserve(numPhi);
     for(size_t i = 0; i < numPhi; i++)
     {
         phi.push_back(i*2.0*M_PI/numPhi);
     }
-
-    // generate grid from coordinates:
-    RegularVertexGrid grid(s, phi);
-
-    // loop over properties and add vertices:
-    for(auto &prop : properties)
-    {
-        generatePropertyGrid(
-                centreLine,
-                radius,
-                prop,
-                grid);
-    }
-
-    // return the overall grid:
-    return grid;
 }
 
 
 /*!
- * This function creates the actual vertices used in the RegularVertexGrid and
- * calculates the colour property by sampling the given spline curve at the
- * appropriate location.
+ * This function creates the actual vertices used in the RegularVertexGrid at
+ * the given grid coordinates. Returned vertices are linearly indexed with the
+ * angular index running fastest.
+ *
+ * Rings of vertices are created at sample points along the centre line, 
+ * discarding rings that clash with their neighbours at the level of interval
+ * bisection at which they are first created. Rings are independent of one
+ * another and are generated in parallel. The remaining rings are then 
+ * interpolated along lines of equal angle, which is again done in parallel.
  */
-void
-MolecularPathObjExporter::generatePropertyGrid(
+std::vector<gmx::RVec>
+MolecularPathObjExporter::generateSurface(
         SplineCurve3D &centreLine,
         SplineCurve1D &radius,
-        std::pair<std::string, std::pair<SplineCurve1D, bool>> property,
-        RegularVertexGrid &grid)
+        const std::vector<real> &gridS,
+        const std::vector<real> &gridPhi)
 {   
+    auto start = std::chrono::steady_clock::now();
+
     // extract grid coordinates:
     std::vector<real> s;
-    int num = std::floor((grid.s_.back() - grid.s_.front()) / gridSampleDist_);
-    real ds = (grid.s_.back() - grid.s_.front())/(num - 1);
+    int num = std::floor((gridS.back() - gridS.front()) / gridSampleDist_);
+    real ds = (gridS.back() - gridS.front())/(num - 1);
     for(size_t i = 0; i < num; i++)
     {
-        s.push_back(grid.s_.front() + i*ds);
+        s.push_back(gridS.front() + i*ds);
     }
-    std::vector<real> phi = grid.phi_;
+    const std::vector<real> &phi = gridPhi;
     size_t numLen = s.size();
 
-    // sample points, radii, and tangents along molecular path:
+    // sample points, radii, tangents, and frame vectors along molecular path:
+    // (the rotation-minimising frame of the centre line prevents "twisting" 
+    // the surface around the curve and is the same frame that defines the 
+    // angular coordinate of mapped particles)
     std::vector<gmx::RVec> centres;
     centres.reserve(s.size());
     std::vector<gmx::RVec> tangents;
     tangents.reserve(s.size());
+    std::vector<gmx::RVec> normals;
+    normals.reserve(s.size());
+    std::vector<gmx::RVec> binormals;
+    binormals.reserve(s.size());
     std::vector<real> radii;
     radii.reserve(s.size());
     for(auto eval : s)
@@ -741,92 +1011,71 @@ MolecularPathObjExporter::generatePropertyGrid(
         gmx::RVec tv = centreLine.tangentVec(eval);
         unitv(tv, tv);
         tangents.push_back(tv);
+        normals.push_back( centreLine.frameNormal(eval) );
+        binormals.push_back( centreLine.frameBinormal(eval) );
         radii.push_back( radius.evaluate(eval, 0) );
     }
 
-    // sample normals along molecular path:
-    // (this is better then using the standard normal vector of the centre line
-    // curve as it prevents "twisting" the normal vector around the curve)
-    auto normals = generateNormals(tangents);
+    // trigonometric functions of angular grid coordinates:
+    std::vector<real> cosPhi;
+    std::vector<real> sinPhi;
+    cosPhi.reserve(phi.size());
+    sinPhi.reserve(phi.size());
+    for(auto p : phi)
+    {
+        cosPhi.push_back(std::cos(p));
+        sinPhi.push_back(std::sin(p));
+    }
     
 
     // calculate sample points on pathway:
     // ------------------------------------------------------------------------
 
-    // ring of vertices for each pathway coordinate:
-    std::vector<gmx::RVec> vertRing(phi.size());
-    std::map<int, std::vector<gmx::RVec>> vertexRings;
-    
-    // first vertex ring:
-    int idxLen = 0;
-    for(size_t k = 0; k < phi.size(); k++)
+    // candidate rings as triplets of ring index and neighbour indices used for
+    // the clash check (endpoint rings are never checked for clashes):
+    std::vector<std::tuple<int, int, int>> candidates;
+    candidates.push_back(std::make_tuple(0, -1, -1));
+    candidates.push_back(std::make_tuple(numLen - 1, -1, -1));
+    for(int i = 1; i <= numLen; i *= 2)
     {
-        // rotate normal vector:
-        gmx::RVec rotNormal = rotateAboutAxis(
-                normals[idxLen], 
-                tangents[idxLen],
-                phi[k]);
-
-        // generate vertex:
-        gmx::RVec vertex = centres[idxLen];
-        vertex[XX] += radii[idxLen]*rotNormal[XX];
-        vertex[YY] += radii[idxLen]*rotNormal[YY];
-        vertex[ZZ] += radii[idxLen]*rotNormal[ZZ];
-
-        // add to vertex ring:
-        vertRing[k] = vertex;
+        for(int j = 1; j < i; j += 2)
+        {
+            candidates.push_back(std::make_tuple(
+                    j*(numLen - 1)/i,
+                    (j - 1)*(numLen - 1)/i,
+                    (j + 1)*(numLen - 1)/i));
+        }
     }
-    vertexRings[idxLen] = vertRing;
 
-    // last vertex ring:
-    idxLen = s.size() - 1;
-    for(size_t k = 0; k < phi.size(); k++)
+    // create ring of vertices for each candidate:
+    std::vector<std::vector<gmx::RVec>> candidateRings(candidates.size());
+    std::vector<char> hasClashes(candidates.size(), false);
+    parallelFor(candidates.size(), [&](size_t c)
     {
-        // rotate normal vector:
-        gmx::RVec rotNormal = rotateAboutAxis(
-                normals[idxLen], 
-                tangents[idxLen],
-                phi[k]);
-
-        // generate vertex:
-        gmx::RVec vertex = centres[idxLen];
-        vertex[XX] += radii[idxLen]*rotNormal[XX];
-        vertex[YY] += radii[idxLen]*rotNormal[YY];
-        vertex[ZZ] += radii[idxLen]*rotNormal[ZZ];
-
-        // add to vertex ring:
-        vertRing[k] = vertex;
-    }
-    vertexRings[idxLen] = vertRing;
-
+        int idxLen = std::get<0>(candidates[c]);
+        int idxLower = std::get<1>(candidates[c]);
+        int idxUpper = std::get<2>(candidates[c]);
 
-    // build intermediate vertex rings:    
-    for(int i = 1; i <= numLen; i *= 2)
-    {
-        for(int j = 1; j < i; j += 2)
+        std::vector<gmx::RVec> &vertRing = candidateRings[c];
+        vertRing.resize(phi.size());
+        for(size_t k = 0; k < phi.size(); k ++)
         {
-            idxLen = j*(numLen - 1)/i;
-            int idxLower = (j - 1)*(numLen - 1)/i;
-            int idxUpper = (j + 1)*(numLen - 1)/i;
-
-            // create ring of vertices:
-            bool hasClashes = false;
-            for(size_t k = 0; k < phi.size(); k ++)
+            // radial direction at this angle:
+            const gmx::RVec &n = normals[idxLen];
+            const gmx::RVec &b = binormals[idxLen];
+            gmx::RVec radialDir(cosPhi[k]*n[XX] + sinPhi[k]*b[XX],
+                                cosPhi[k]*n[YY] + sinPhi[k]*b[YY],
+                                cosPhi[k]*n[ZZ] + sinPhi[k]*b[ZZ]);
+
+            // generate vertex:
+            gmx::RVec vertex = centres[idxLen];
+            vertex[XX] += radii[idxLen]*radialDir[XX];
+            vertex[YY] += radii[idxLen]*radialDir[YY];
+            vertex[ZZ] += radii[idxLen]*radialDir[ZZ];
+
+            // check overlap with neighbouring discs:
+            if( idxLower >= 0 )
             {
-                // rotate normal vector:
-                gmx::RVec rotNormal = rotateAboutAxis(
-                        normals[idxLen], 
-                        tangents[idxLen],
-                        phi[k]);
-
-                // generate vertex:
-                gmx::RVec vertex = centres[idxLen];
-                vertex[XX] += radii[idxLen]*rotNormal[XX];
-                vertex[YY] += radii[idxLen]*rotNormal[YY];
-                vertex[ZZ] += radii[idxLen]*rotNormal[ZZ];
-
-                // TODO: the below goes in separate function?
-
                 // difference vectors in neighbouring discs:
                 gmx::RVec a;
                 rvec_sub(vertex, centres[idxLower], a);
@@ -844,114 +1093,70 @@ MolecularPathObjExporter::generatePropertyGrid(
                     cosB > -correctionThreshold_ )
                 {
                     // set crash flag to true and terminate loop:
-                    hasClashes = true;
+                    hasClashes[c] = true;
                     break;
                 }
-
-                // add to vertex ring:
-                vertRing[k] = vertex;
-            }
-   
-            // will ignore all vertex rings with clashes:
-            if( !hasClashes )
-            {
-                vertexRings[idxLen] = vertRing;
             }
-            hasClashes = false;
+
+            // add to vertex ring:
+            vertRing[k] = vertex;
+        }
+    });
+
+    // will ignore all vertex rings with clashes:
+    std::map<int, std::vector<gmx::RVec>*> vertexRings;
+    for(size_t c = 0; c < candidates.size(); c++)
+    {
+        if( !hasClashes[c] )
+        {
+            vertexRings[std::get<0>(candidates[c])] = &candidateRings[c];
         }
     }
+    recordTiming("rings", start);
 
 
     // interpolate 
     // ------------------------------------------------------------------------
+    
+    start = std::chrono::steady_clock::now();
 
-    // interpolate support points on each equal-phi line:
-    std::vector<SplineCurve3D> curves;
-    for(size_t k = 0; k < phi.size(); k++)
+    // pathway coordinate as curve parameter:
+    std::vector<real> param;
+    param.reserve(vertexRings.size());
+    for(auto vr = vertexRings.begin(); vr != vertexRings.end(); vr++)
     {
-        // extract support points and parameterisation for interpolation:
-        std::vector<real> param;
+        param.push_back( s[vr -> first] );
+    }
+
+    // interpolate support points on each equal-phi line and evaluate the 
+    // resulting curve at the target grid coordinates:
+    std::vector<gmx::RVec> surface(gridS.size()*phi.size());
+    parallelFor(phi.size(), [&](size_t k)
+    {
+        // extract sample points to interpolate:
         std::vector<gmx::RVec> points;
+        points.reserve(vertexRings.size());
         for(auto vr = vertexRings.begin(); vr != vertexRings.end(); vr++)
         {
-            // pathway coordinate as curve parameter:
-            param.push_back( s[vr -> first] );
-
-            // sample points to interpolate:
-            points.push_back( vr -> second[k] );
+            points.push_back( (*vr -> second)[k] );
         }       
 
         // interpolate these points:
         CubicSplineInterp3D interp;
-        curves.push_back( interp(param, points, eSplineInterpBoundaryHermite) );
-    }
-
-
-    // build mesh
-    // ------------------------------------------------------------------------
-
-    // sample scalar property along the path and rescale to unit interval:
-    std::vector<real> prop;
-    prop.reserve(grid.s_.size());
-    for(size_t i = 0; i < grid.s_.size(); i++)
-    {
-        prop.push_back( property.second.first.evaluate(grid.s_[i], 0) );
-    }
-    shiftAndScale(prop, property.second.second);
+        SplineCurve3D curve = interp(
+                param, 
+                points, 
+                eSplineInterpBoundaryHermite);
 
-    // loop over target grid coordinates and add vertices:
-    for(size_t i = 0; i < grid.s_.size(); i++)
-    {
-        for(size_t k = 0; k < grid.phi_.size(); k++)
+        // evaluate at target grid coordinates:
+        for(size_t i = 0; i < gridS.size(); i++)
         {
-            grid.addVertex(
-                    i, 
-                    k, 
-                    property.first, 
-                    curves[k].evaluate(grid.s_[i], 0),
-                    prop[i]);
+            surface[i*phi.size() + k] = curve.evaluate(gridS[i], 0);
         }
-    }
-}
-
+    });
+    recordTiming("interpolation", start);
 
-/*!
- * generates a set of normal vectors by determining a normal vector at one end
- * of the surface tube and moving it along the spline curve.
- */
-std::vector<gmx::RVec>
-MolecularPathObjExporter::generateNormals(
-        const std::vector<gmx::RVec> &tangents)
-{
-    // preallocate container for normal vectors:
-    std::vector<gmx::RVec> normals;
-    normals.reserve(tangents.size());
-
-    // generate initial normal:
-    gmx::RVec normal = orthogonalVector(tangents[0]);
-    unitv(normal, normal);
-    normals.push_back(normal);
- 
-    // loop over tangent vectors and update normals:
-    for(unsigned int i = 1; i < tangents.size(); i++)
-    {
-        // find axis of tangent rotation:
-        gmx::RVec tangentRotAxis;
-        cprod(tangents[i - 1], tangents[i], tangentRotAxis);
-
-        // find tangent angle of rotation:
-        real tangentRotCos = iprod(tangents[i], tangents[i - 1]);
-        real tangentRotAxisLen = norm(tangentRotAxis);
-        real tangentRotAngle = std::atan2(tangentRotAxisLen, tangentRotCos);
-
-        // update normal by rotating it like the tangent:
-        normal = rotateAboutAxis(normal, tangentRotAxis, tangentRotAngle);
-        unitv(normal, normal);
-        normals.push_back(normal);
-    }
-
-    // return normal vectors:
-    return normals;
+    return surface;
 }
 
 
@@ -1083,3 +1288,17 @@ MolecularPathObjExporter::shiftAndScale(
     }
 }
 
+
+/*!
+ * Auxiliary function that adds the wall clock time elapsed since the given
+ * starting point to the timing record of the given stage.
+ */
+void
+MolecularPathObjExporter::recordTiming(
+        const std::string &stage,
+        std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> elapsed = 
+            std::chrono::steady_clock::now() - start;
+    timings_[stage] += elapsed.count();
+}
@@ -22,10 +22,14 @@
 // THE SOFTWARE.
 
 
+#include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <iomanip>
+#include <stdexcept>
 
 #include <gromacs/fileio/confio.h>
+#include <gromacs/math/vec.h>
 #include <gromacs/topology/atoms.h>
 
 #include "io/pdb_io.hpp"
@@ -51,6 +55,23 @@ PdbStructure::fromTopology(
 }
 
 
+/*!
+ * Creates a PdbStructure from the given atoms without coordinates or unit 
+ * cell, as needed by PdbTrajectoryWriter, which takes these for each frame. 
+ * As in fromTopology(), the atoms are not copied deeply, so that the names 
+ * they refer to must outlive the structure.
+ */
+void
+PdbStructure::fromAtoms(
+        const t_atoms &atoms)
+{
+    atoms_ = atoms;
+    coords_ = nullptr;
+    ePBC_ = -1;
+    clear_mat(box_);
+}
+
+
 /*!
  * Sets the occupancy and bfac fields of the PDB file to the time averaged 
  * pore-lining and pore-facing attributes.
@@ -128,3 +149,178 @@ PdbIo::write(
             structure.box_);        // box matrix
 }
 
+
+
+/*!
+ * Constructor opens the output file and prepares the part of each atom record
+ * that does not change between frames (i.e. everything up to the 
+ * coordinates).
+ */
+PdbTrajectoryWriter::PdbTrajectoryWriter(
+        const std::string &fileName,
+        const PdbStructure &structure)
+    : pdb_(new CompressedFileWriteStream(fileName))
+    , numModels_(0)
+{
+    const t_atoms &atoms = structure.atoms_;
+    atomRecords_.reserve(atoms.nr);
+    residueIndices_.reserve(atoms.nr);
+
+    char record[64];
+    for(int i = 0; i < atoms.nr; i++)
+    {
+        const t_resinfo &resinfo = atoms.resinfo[atoms.atom[i].resind];
+
+        // names shorter than four characters start in the second column:
+        std::string atomName(*(atoms.atomname[i]));
+        if( atomName.size() < 4 )
+        {
+            atomName = " " + atomName;
+        }
+
+        // chain identifier and insertion code may be unset in topology:
+        char chainId = resinfo.chainid == '\0' ? ' ' : resinfo.chainid;
+        char insCode = resinfo.ic == '\0' ? ' ' : resinfo.ic;
+
+        // record name, serial, atom name, residue name, chain, and residue 
+        // number, followed by padding up to the coordinate columns:
+        std::snprintf(
+                record, 
+                sizeof(record),
+                "ATOM  %5d %-4.4s %-4.4s%c%4d%c   ",
+                (i + 1) % 100000,
+                atomName.c_str(),
+                *(resinfo.name),
+                chainId,
+                resinfo.nr % 10000,
+                insCode);
+        atomRecords_.push_back(record);
+        residueIndices_.push_back(atoms.atom[i].resind);
+    }
+
+    // title to identify origin of file:
+    writeString("TITLE     created by CHAP\n");
+}
+
+
+/*!
+ * Appends one model to the PDB file. Coordinates and box are expected in 
+ * nanometres as used internally by Gromacs. The pore-lining and pore-facing
+ * vectors are indexed by residue and written into the occupancy and B-factor
+ * fields, residues not contained in these vectors are assigned zero.
+ */
+void
+PdbTrajectoryWriter::writeModel(
+        const rvec *coords,
+        int numAtoms,
+        const matrix box,
+        const std::vector<real> &poreLining,
+        const std::vector<real> &poreFacing)
+{
+    // sanity checks:
+    if( pdb_ == nullptr )
+    {
+        throw std::logic_error("Can not write model to closed PDB file.");
+    }
+    if( numAtoms < static_cast<int>(atomRecords_.size()) )
+    {
+        throw std::runtime_error("Number of atoms in frame is smaller than "
+                                 "number of atoms in topology.");
+    }
+    if( poreLining.size() != poreFacing.size() )
+    {
+        throw std::logic_error("Pore-lining and pore-facing vectors must "
+                               "have same length.");
+    }
+
+    char line[96];
+
+    // unit cell is only written if box is defined:
+    real a = 10.0*std::sqrt(iprod(box[XX], box[XX]));
+    real b = 10.0*std::sqrt(iprod(box[YY], box[YY]));
+    real c = 10.0*std::sqrt(iprod(box[ZZ], box[ZZ]));
+    if( a > 0.0 && b > 0.0 && c > 0.0 )
+    {
+        real toDeg = 180.0/std::acos(-1.0);
+        real alpha = toDeg*std::acos(100.0*iprod(box[YY], box[ZZ])/(b*c));
+        real beta = toDeg*std::acos(100.0*iprod(box[XX], box[ZZ])/(a*c));
+        real gamma = toDeg*std::acos(100.0*iprod(box[XX], box[YY])/(a*b));
+        std::snprintf(
+                line, 
+                sizeof(line),
+                "CRYST1%9.3f%9.3f%9.3f%7.2f%7.2f%7.2f P 1           1\n",
+                a, b, c, alpha, beta, gamma);
+        writeString(line);
+    }
+
+    // models are numbered from one:
+    numModels_++;
+    std::snprintf(line, sizeof(line), "MODEL %8d\n", numModels_);
+    writeString(line);
+
+    // write atom records:
+    for(size_t i = 0; i < atomRecords_.size(); i++)
+    {
+        // per-frame attributes of this atom's residue:
+        size_t resind = residueIndices_[i];
+        real occup = 0.0;
+        real bfac = 0.0;
+        if( resind < poreLining.size() )
+        {
+            occup = poreLining[resind];
+            bfac = poreFacing[resind];
+        }
+
+        writeString(atomRecords_[i]);
+        int len = std::snprintf(
+                line,
+                sizeof(line),
+                "%8.3f%8.3f%8.3f%6.2f%6.2f\n",
+                10.0*coords[i][XX],
+                10.0*coords[i][YY],
+                10.0*coords[i][ZZ],
+                occup,
+                bfac);
+        pdb_ -> write(line, len);
+    }
+
+    // terminate model:
+    writeString("TER\nENDMDL\n");
+}
+
+
+/*!
+ * Writes the end record and closes the underlying file. Errors are reported 
+ * by throwing an exception.
+ */
+void
+PdbTrajectoryWriter::close()
+{
+    if( pdb_ == nullptr )
+    {
+        return;
+    }
+    writeString("END\n");
+    pdb_ -> close();
+    pdb_.reset();
+}
+
+
+/*!
+ * Returns the number of models written so far.
+ */
+int
+PdbTrajectoryWriter::numModels() const
+{
+    return numModels_;
+}
+
+
+/*!
+ * Auxiliary function for writing a string to the output stream.
+ */
+void
+PdbTrajectoryWriter::writeString(const std::string &str)
+{
+    pdb_ -> write(str.data(), str.size());
+}
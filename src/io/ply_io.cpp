@@ -0,0 +1,131 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <stdexcept>
+
+#include "io/ply_io.hpp"
+
+
+/*!
+ * Writes a triangle mesh to a binary PLY file of the given name. The normals
+ * may be empty, otherwise there must be one normal per vertex. Likewise, 
+ * each property must have one value per vertex. Triangles are given as 
+ * consecutive triplets of zero-based vertex indices.
+ */
+void
+PlyExporter::write(
+        const std::string &fileName,
+        const std::vector<gmx::RVec> &vertices,
+        const std::vector<gmx::RVec> &normals,
+        const std::vector<std::pair<std::string, std::vector<real>>> &properties,
+        const std::vector<uint32_t> &triangles)
+{
+    // sanity checks:
+    bool hasNormals = !normals.empty();
+    if( hasNormals && normals.size() != vertices.size() )
+    {
+        throw std::logic_error("Number of vertex normals must equal number "
+                               "of vertices.");
+    }
+    for(auto &prop : properties)
+    {
+        if( prop.second.size() != vertices.size() )
+        {
+            throw std::logic_error("Property " + prop.first + " does not "
+                                   "have one value per vertex.");
+        }
+    }
+    if( triangles.size() % 3 != 0 )
+    {
+        throw std::logic_error("Number of triangle vertex indices must be "
+                               "a multiple of three.");
+    }
+    for(auto idx : triangles)
+    {
+        if( idx >= vertices.size() )
+        {
+            throw std::logic_error("Invalid vertex reference encountered.");
+        }
+    }
+
+    // build header:
+    std::string header = "ply\n"
+                         "format binary_little_endian 1.0\n"
+                         "comment produced by CHAP\n";
+    header += "element vertex " + std::to_string(vertices.size()) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    if( hasNormals )
+    {
+        header += "property float nx\nproperty float ny\nproperty float nz\n";
+    }
+    for(auto &prop : properties)
+    {
+        header += "property float " + prop.first + "\n";
+    }
+    header += "element face " + std::to_string(triangles.size()/3) + "\n";
+    header += "property list uchar uint vertex_indices\n";
+    header += "end_header\n";
+
+    // open file and write header:
+    CompressedFileWriteStream ply(fileName);
+    ply.write(header.data(), header.size());
+
+    // write vertices with normals and properties interleaved:
+    // (assumes little endian host)
+    std::vector<float> vertex;
+    vertex.reserve(6 + properties.size());
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        vertex.clear();
+        vertex.push_back(vertices[i][XX]);
+        vertex.push_back(vertices[i][YY]);
+        vertex.push_back(vertices[i][ZZ]);
+        if( hasNormals )
+        {
+            vertex.push_back(normals[i][XX]);
+            vertex.push_back(normals[i][YY]);
+            vertex.push_back(normals[i][ZZ]);
+        }
+        for(auto &prop : properties)
+        {
+            vertex.push_back(prop.second[i]);
+        }
+        ply.write(
+                reinterpret_cast<const char*>(vertex.data()), 
+                vertex.size()*sizeof(float));
+    }
+
+    // write faces:
+    for(size_t i = 0; i < triangles.size(); i += 3)
+    {
+        ply.Put(3);
+        ply.write(
+                reinterpret_cast<const char*>(&triangles[i]), 
+                3*sizeof(uint32_t));
+    }
+
+    // close file stream:
+    ply.close();
+}
+
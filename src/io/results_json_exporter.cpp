@@ -22,10 +22,9 @@
 // THE SOFTWARE.
 
 
-#include <fstream>
+#include <algorithm>
 #include <exception>
 
-#include "external/rapidjson/stringbuffer.h"
 #include "external/rapidjson/writer.h"
 
 #include "config/config.hpp"
@@ -43,6 +42,15 @@
  */
 ResultsJsonExporter::ResultsJsonExporter()
     : doc_()
+    , quantileLevels_({{"q05", 0.05}, 
+                       {"q25", 0.25}, 
+                       {"q50", 0.50}, 
+                       {"q75", 0.75}, 
+                       {"q95", 0.95}})
+    , hasTimeStamps_(false)
+    , numTimeStamps_(0)
+    , hasGridPoints_(false)
+    , numGridPoints_(0)
 {
     // overall document will be an object:
     doc_.SetObject();
@@ -81,6 +89,107 @@ ResultsJsonExporter::ResultsJsonExporter()
 }
 
 
+/*!
+ * Switches the exporter into streaming mode, in which the output is written to
+ * the given file as it is added rather than being held in memory until 
+ * write() is called. Must be called before any data is added.
+ *
+ * In streaming mode, each top level section (pathwaySummary, pathwayProfile,
+ * etc.) is held in memory only until data is added to a different section, 
+ * at which point it is written to file and its memory is released. A section
+ * can therefore not be revisited once another section has been started. 
+ * Time series data, which scale with the trajectory length, bypass the 
+ * document entirely and are written to file immediately. The output must be
+ * completed by calling finishStreaming().
+ *
+ * The output is gzip compressed if the file name ends in .gz.
+ */
+void
+ResultsJsonExporter::beginStreaming(std::string filename)
+{
+    // sanity checks:
+    if( isStreaming() )
+    {
+        throw std::logic_error("Streaming of results has already been "
+                               "started.");
+    }
+    for(auto it = doc_.MemberBegin(); it != doc_.MemberEnd(); it++)
+    {
+        if( it -> value.IsObject() && 
+            it -> value.MemberCount() > 0 &&
+            std::string(it -> name.GetString()) != "reproducibilityInformation" )
+        {
+            throw std::logic_error("Streaming of results must be started "
+                                   "before any data is added.");
+        }
+    }
+
+    // open buffered output stream and create writer:
+    stream_.reset(new CompressedFileWriteStream(filename));
+    writer_.reset(
+            new rapidjson::Writer<CompressedFileWriteStream>(*stream_));
+
+    // all sections except reproducibility information remain to be written:
+    pendingSections_.clear();
+    for(auto it = doc_.MemberBegin(); it != doc_.MemberEnd(); it++)
+    {
+        std::string name(it -> name.GetString(), it -> name.GetStringLength());
+        if( name != "reproducibilityInformation" )
+        {
+            pendingSections_.push_back(name);
+        }
+    }
+
+    // reproducibility information is complete and can be written right away:
+    writer_ -> StartObject();
+    writer_ -> Key("reproducibilityInformation");
+    doc_["reproducibilityInformation"].Accept(*writer_);
+
+    // release document memory:
+    doc_.SetObject();
+    doc_.GetAllocator().Clear();
+    currentSection_.clear();
+}
+
+
+/*!
+ * Completes a streamed output file by writing the current section, any 
+ * sections to which no data has been added (as empty objects), and the 
+ * closing bracket of the document. The file is closed afterwards.
+ */
+void
+ResultsJsonExporter::finishStreaming()
+{
+    // sanity check:
+    if( !isStreaming() )
+    {
+        throw std::logic_error("Can not finish streaming of results before "
+                               "it has been started.");
+    }
+
+    // write current section:
+    leaveSection();
+
+    // write remaining sections as empty objects:
+    for(auto &name : pendingSections_)
+    {
+        writer_ -> Key(name.c_str());
+        writer_ -> StartObject();
+        writer_ -> EndObject();
+    }
+    pendingSections_.clear();
+
+    // close document and terminate line:
+    writer_ -> EndObject();
+    stream_ -> Put('\n');
+
+    // close file and release stream:
+    writer_.reset();
+    stream_ -> close();
+    stream_.reset();
+}
+
+
 /*!
  * Adds summary statistics of a named variable to the output document.
  */
@@ -89,6 +198,9 @@ ResultsJsonExporter::addPathwaySummary(
         std::string name,
         const SummaryStatistics &summary)
 {
+    // make sure pathway summary is the section being written:
+    enterSection("pathwaySummary");
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -100,6 +212,72 @@ ResultsJsonExporter::addPathwaySummary(
 }
 
 
+/*!
+ * Adds quantiles of a named variable to the output document. The quantiles 
+ * are added as additional members (q05, q25, q50, q75, and q95) of the object
+ * created by addPathwaySummary(), which must therefore be called first.
+ */
+void
+ResultsJsonExporter::addPathwayQuantiles(
+        std::string name,
+        const QuantileSketch &sketch)
+{
+    // make sure pathway summary is the section being written:
+    enterSection("pathwaySummary");
+
+    // sanity checks:
+    if( !doc_["pathwaySummary"].HasMember(name.c_str()) )
+    {
+        throw std::logic_error("Can not add quantiles of " + name + " before "
+                               "its summary statistics have been added.");
+    }
+
+    // obtain an allocator:
+    rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
+
+    // add quantiles to existing summary object:
+    for(auto level : quantileLevels_)
+    {
+        rapidjson::Value quant(sketch.quantile(level.second));
+        doc_["pathwaySummary"][name.c_str()].AddMember(
+                toVal(level.first), 
+                quant, 
+                alloc);
+    }
+}
+
+
+/*!
+ * Adds the standard error of the mean of a named variable as obtained from 
+ * block averaging to the output document. The standard error is added as an 
+ * additional member (se) of the object created by addPathwaySummary(), which
+ * must therefore be called first.
+ */
+void
+ResultsJsonExporter::addPathwayStandardError(
+        std::string name,
+        const BlockAverage &blockAvg)
+{
+    // make sure pathway summary is the section being written:
+    enterSection("pathwaySummary");
+
+    // sanity checks:
+    if( !doc_["pathwaySummary"].HasMember(name.c_str()) )
+    {
+        throw std::logic_error("Can not add standard error of " + name + " "
+                               "before its summary statistics have been "
+                               "added.");
+    }
+
+    // obtain an allocator:
+    rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
+
+    // add standard error to existing summary object:
+    rapidjson::Value se(blockAvg.standardError());
+    doc_["pathwaySummary"][name.c_str()].AddMember(toVal("se"), se, alloc);
+}
+
+
 /*!
  * Adds a set of support points to the output document. May only be called 
  * once.
@@ -107,6 +285,9 @@ ResultsJsonExporter::addPathwaySummary(
 void
 ResultsJsonExporter::addSupportPoints(const std::vector<real> &supportPoints)
 {
+    // make sure pathway profile is the section being written:
+    enterSection("pathwayProfile");
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -138,17 +319,11 @@ ResultsJsonExporter::addPathwayProfile(
         std::string name,
         const std::vector<SummaryStatistics> &profile)
 {
+    // make sure pathway profile is the section being written:
+    enterSection("pathwayProfile");
+
     // sanity checks:
-    if( !doc_["pathwayProfile"].HasMember("s") )
-    {
-        throw std::logic_error("Can not add profile to JSON document before "
-                               "support points have been added.");
-    }
-    if( profile.size() != doc_["pathwayProfile"]["s"].Size() )
-    {
-        throw std::logic_error("Number of data points in profile must equal "
-                               "number of suppoert points.");
-    }
+    checkProfileSize(name, profile.size());
 
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
@@ -176,6 +351,116 @@ ResultsJsonExporter::addPathwayProfile(
 }
 
 
+/*!
+ * Adds a profile without summary statistics (e.g. an estimate pooled over all
+ * frames) to the output document. The profile is added as a single column
+ * under the given name.
+ *
+ * As for the summary statistics overload, this requires that 
+ * addSupportPoints() has already been called and that the number of data 
+ * points in the profile is equal to the number of support points.
+ */
+void
+ResultsJsonExporter::addPathwayProfile(
+        std::string name,
+        const std::vector<real> &profile)
+{
+    // make sure pathway profile is the section being written:
+    enterSection("pathwayProfile");
+
+    // sanity checks:
+    checkProfileSize(name, profile.size());
+
+    // obtain an allocator:
+    rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
+
+    // create JSON array for profile:
+    rapidjson::Value prof(rapidjson::kArrayType);
+    for(auto p : profile)
+    {
+        prof.PushBack(p, alloc);
+    }
+
+    // add to table as individual column:
+    doc_["pathwayProfile"].AddMember(toVal(name), prof, alloc);
+}
+
+
+/*!
+ * Adds quantiles of a profile to the output document. Each quantile is added
+ * as an individual column, where the column name is composed of the profile 
+ * name and the quantile (e.g. radiusQ05 for the 5% quantile of the radius). 
+ *
+ * As for addPathwayProfile(), this requires that addSupportPoints() has 
+ * already been called and that the number of data points in the profile is
+ * equal to the number of support points.
+ */
+void
+ResultsJsonExporter::addPathwayProfileQuantiles(
+        std::string name,
+        const std::vector<QuantileSketch> &profile)
+{
+    // make sure pathway profile is the section being written:
+    enterSection("pathwayProfile");
+
+    // sanity checks:
+    checkProfileSize(name, profile.size());
+
+    // obtain an allocator:
+    rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
+
+    // loop over quantiles:
+    for(auto level : quantileLevels_)
+    {
+        // evaluate quantile at each support point:
+        rapidjson::Value quant(rapidjson::kArrayType);
+        for(auto &p : profile)
+        {
+            quant.PushBack(p.quantile(level.second), alloc);
+        }
+
+        // column name with capitalised quantile label:
+        std::string colName = name + "Q" + level.first.substr(1);
+        doc_["pathwayProfile"].AddMember(toVal(colName), quant, alloc);
+    }
+}
+
+
+/*!
+ * Adds the block averaging standard error of the mean of a profile to the 
+ * output document. The standard error is added as an individual column, where
+ * the column name is the profile name with the suffix Se (e.g. radiusSe).
+ *
+ * As for addPathwayProfile(), this requires that addSupportPoints() has 
+ * already been called and that the number of data points in the profile is
+ * equal to the number of support points.
+ */
+void
+ResultsJsonExporter::addPathwayProfileStandardError(
+        std::string name,
+        const std::vector<BlockAverage> &profile)
+{
+    // make sure pathway profile is the section being written:
+    enterSection("pathwayProfile");
+
+    // sanity checks:
+    checkProfileSize(name, profile.size());
+
+    // obtain an allocator:
+    rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
+
+    // evaluate standard error at each support point:
+    rapidjson::Value se(rapidjson::kArrayType);
+    for(auto &p : profile)
+    {
+        se.PushBack(p.standardError(), alloc);
+    }
+
+    // add to table as individual column:
+    doc_["pathwayProfile"].AddMember(toVal(name + "Se"), se, alloc);
+}
+
+
 /*!
  * Adds common time stamps for all scalar time series to output document.
  */
@@ -183,6 +468,26 @@ void
 ResultsJsonExporter::addTimeStamps(
         const std::vector<real> &timeStamps)
 {
+    // make sure scalar time series is the section being written:
+    enterSection("pathwayScalarTimeSeries");
+
+    // keep track of number of time stamps:
+    hasTimeStamps_ = true;
+    numTimeStamps_ = timeStamps.size();
+
+    // in streaming mode write directly to file:
+    if( isStreaming() )
+    {
+        writer_ -> Key("t");
+        writer_ -> StartArray();
+        for(auto t : timeStamps)
+        {
+            writer_ -> Double(t);
+        }
+        writer_ -> EndArray();
+        return;
+    }
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -208,18 +513,34 @@ ResultsJsonExporter::addPathwayScalarTimeSeries(
         std::string name,
         const std::vector<real> &timeSeries)
 {
+    // make sure scalar time series is the section being written:
+    enterSection("pathwayScalarTimeSeries");
+
     // sanity checks:
-    if( !doc_["pathwayScalarTimeSeries"].HasMember("t") )
+    if( !hasTimeStamps_ )
     {
         throw std::logic_error("Can not add time series data before adding "
                                "time stamps.");
     }
-    if( timeSeries.size() != doc_["pathwayScalarTimeSeries"]["t"].Size() )
+    if( timeSeries.size() != numTimeStamps_ )
     {
         throw std::logic_error("Time series must have as many data points "
                                "as there are time stamp values.");
     }
 
+    // in streaming mode write directly to file:
+    if( isStreaming() )
+    {
+        writer_ -> Key(name.c_str());
+        writer_ -> StartArray();
+        for(auto val : timeSeries)
+        {
+            writer_ -> Double(val);
+        }
+        writer_ -> EndArray();
+        return;
+    }
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -247,6 +568,40 @@ ResultsJsonExporter::addPathwayGridPoints(
         const std::vector<real> &timeStamps,
         const std::vector<real> &supportPoints)
 {
+    // make sure profile time series is the section being written:
+    enterSection("pathwayProfileTimeSeries");
+
+    // keep track of number of grid points:
+    hasGridPoints_ = true;
+    numGridPoints_ = timeStamps.size() * supportPoints.size();
+
+    // in streaming mode write directly to file:
+    if( isStreaming() )
+    {
+        writer_ -> Key("t");
+        writer_ -> StartArray();
+        for(auto t : timeStamps)
+        {
+            for(size_t i = 0; i < supportPoints.size(); i++)
+            {
+                writer_ -> Double(t);
+            }
+        }
+        writer_ -> EndArray();
+
+        writer_ -> Key("s");
+        writer_ -> StartArray();
+        for(size_t i = 0; i < timeStamps.size(); i++)
+        {
+            for(auto s : supportPoints)
+            {
+                writer_ -> Double(s);
+            }
+        }
+        writer_ -> EndArray();
+        return;
+    }
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -279,20 +634,42 @@ ResultsJsonExporter::addPathwayProfileTimeSeries(
         std::string name,
         const std::vector<std::vector<real>> &timeSeries)
 {
+    // make sure profile time series is the section being written:
+    enterSection("pathwayProfileTimeSeries");
+
     // sanity checks:
-    if( !doc_["pathwayProfileTimeSeries"].HasMember("t") ||
-        !doc_["pathwayProfileTimeSeries"].HasMember("s") )
+    if( !hasGridPoints_ )
     {
         throw std::logic_error("Can not at profile time series data before "
                                "setting space time grid.");
     }
-    size_t numDataPoints = timeSeries.size() * timeSeries.back().size();
-    if( numDataPoints != doc_["pathwayProfileTimeSeries"]["t"].Size() )
+    size_t numDataPoints = 0;
+    for(auto &p : timeSeries)
+    {
+        numDataPoints += p.size();
+    }
+    if( numDataPoints != numGridPoints_ )
     {
         throw std::logic_error("Time series must have as many data points "
                                "as grid points.");
     }
 
+    // in streaming mode write directly to file:
+    if( isStreaming() )
+    {
+        writer_ -> Key(name.c_str());
+        writer_ -> StartArray();
+        for(auto &p : timeSeries)
+        {
+            for(auto val : p)
+            {
+                writer_ -> Double(val);
+            }
+        }
+        writer_ -> EndArray();
+        return;
+    }
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -300,7 +677,7 @@ ResultsJsonExporter::addPathwayProfileTimeSeries(
     rapidjson::Value ts(rapidjson::kArrayType);
 
     // lop over time points:
-    for(auto p : timeSeries)
+    for(auto &p : timeSeries)
     {
         // loop over spatial support points:
         for(auto val : p)
@@ -323,6 +700,9 @@ ResultsJsonExporter::addResidueInformation(
         const std::vector<int> &resId,
         const ResidueInformationProvider &resInf)
 {
+    // make sure residue summary is the section being written:
+    enterSection("residueSummary");
+
     // obtain an allocator:
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
 
@@ -360,6 +740,9 @@ ResultsJsonExporter::addResidueSummary(
         std::string name,
         const std::vector<SummaryStatistics> &resSummary)
 {
+    // make sure residue summary is the section being written:
+    enterSection("residueSummary");
+
     // sanity checks:
     if( !doc_["residueSummary"].HasMember("id") )
     {
@@ -385,26 +768,125 @@ ResultsJsonExporter::addResidueSummary(
 
 
 /*!
- * Writes the JSON document to a file of the given name.
+ * Writes the JSON document to a file of the given name. The output is gzip 
+ * compressed if the file name ends in .gz. Can not be used in streaming mode,
+ * where finishStreaming() completes the output file instead.
  */
 void
 ResultsJsonExporter::write(std::string filename)
 {
-    // stringify output document:
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    // sanity check:
+    if( isStreaming() )
+    {
+        throw std::logic_error("Can not write results document in streaming "
+                               "mode.");
+    }
+
+    // serialise document directly into buffered file stream:
+    CompressedFileWriteStream stream(filename);
+    rapidjson::Writer<CompressedFileWriteStream> writer(stream);
     doc_.Accept(writer);
-    std::string outLine(buffer.GetString(), buffer.GetSize());
-    
-    // open outgoing file stream:
-    std::fstream file;
-    file.open(filename.c_str(), std::fstream::out);
+    stream.Put('\n');
+    stream.close();
+}
+
+
+/*!
+ * Returns true if the exporter is in streaming mode.
+ */
+bool
+ResultsJsonExporter::isStreaming() const
+{
+    return writer_ != nullptr;
+}
+
+
+/*!
+ * In streaming mode, makes the given section the one currently being written.
+ * If a different section is currently open, it is written to file and its 
+ * memory is released first. Throws an exception if the requested section has
+ * already been written. Does nothing outside streaming mode, where all 
+ * sections are always available.
+ */
+void
+ResultsJsonExporter::enterSection(const std::string &name)
+{
+    // nothing to do if not streaming or section already open:
+    if( !isStreaming() || name == currentSection_ )
+    {
+        return;
+    }
+
+    // section must not have been written yet:
+    auto it = std::find(pendingSections_.begin(), pendingSections_.end(), name);
+    if( it == pendingSections_.end() )
+    {
+        throw std::logic_error("Can not add data to section " + name + " "
+                               "after it has been written to file.");
+    }
+    pendingSections_.erase(it);
 
-    // write JSON output to file:
-    file<<outLine<<std::endl;
+    // write previous section:
+    leaveSection();
 
-    // close out file stream:
-    file.close();
+    // open new section in both file and document:
+    writer_ -> Key(name.c_str());
+    writer_ -> StartObject();
+    rapidjson::Value sec(rapidjson::kObjectType);
+    doc_.AddMember(toVal(name), sec, doc_.GetAllocator());
+    currentSection_ = name;
+}
+
+
+/*!
+ * In streaming mode, writes all members of the currently open section to file,
+ * closes the section, and releases the memory held by the document.
+ */
+void
+ResultsJsonExporter::leaveSection()
+{
+    // nothing to do if no section is open:
+    if( currentSection_.empty() )
+    {
+        return;
+    }
+
+    // write members accumulated in document:
+    rapidjson::Value &sec = doc_[currentSection_.c_str()];
+    for(auto it = sec.MemberBegin(); it != sec.MemberEnd(); it++)
+    {
+        writer_ -> Key(it -> name.GetString(), it -> name.GetStringLength());
+        it -> value.Accept(*writer_);
+    }
+    writer_ -> EndObject();
+
+    // release document memory:
+    doc_.SetObject();
+    doc_.GetAllocator().Clear();
+    currentSection_.clear();
+}
+
+
+/*!
+ * Checks that support points have been added to the pathway profile and that
+ * a profile of the given size matches them, throws otherwise.
+ */
+void
+ResultsJsonExporter::checkProfileSize(
+        const std::string &name,
+        size_t size)
+{
+    if( !doc_["pathwayProfile"].HasMember("s") )
+    {
+        throw std::logic_error("Can not add profile " + name + " to JSON "
+                               "document before support points have been "
+                               "added.");
+    }
+    if( size != doc_["pathwayProfile"]["s"].Size() )
+    {
+        throw std::logic_error("Number of data points in profile " + name + 
+                               " must equal number of support points.");
+    }
 }
 
 
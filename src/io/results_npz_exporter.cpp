@@ -0,0 +1,337 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <limits>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "io/results_npz_exporter.hpp"
+
+
+/*!
+ * Constructor opens the output file. Existing files will be overwritten.
+ */
+ResultsNpzExporter::ResultsNpzExporter(
+        const std::string &fileName)
+    : stream_(fileName)
+    , offset_(0)
+{
+
+}
+
+
+/*!
+ * Adds a one-dimensional array under the given name. The name may contain 
+ * slashes to mirror the hierarchy of the JSON output (e.g. 
+ * pathwayScalarTimeSeries/minRadius).
+ */
+void
+ResultsNpzExporter::addArray(
+        const std::string &name,
+        const std::vector<real> &data)
+{
+    addEntry(name, {data.size()}, {&data});
+}
+
+
+/*!
+ * Adds a two-dimensional array under the given name, where each element of 
+ * the outer vector is a row (e.g. the profile at one time step). All rows 
+ * must have the same length.
+ */
+void
+ResultsNpzExporter::addArray(
+        const std::string &name,
+        const std::vector<std::vector<real>> &data)
+{
+    // collect rows and check that array is rectangular:
+    std::vector<const std::vector<real>*> rows;
+    rows.reserve(data.size());
+    for(auto &row : data)
+    {
+        if( row.size() != data.front().size() )
+        {
+            throw std::logic_error("All rows of array " + name + " must have "
+                                   "the same length.");
+        }
+        rows.push_back(&row);
+    }
+
+    // number of columns:
+    size_t numCols = data.empty() ? 0 : data.front().size();
+
+    addEntry(name, {data.size(), numCols}, rows);
+}
+
+
+/*!
+ * Writes the central directory of the archive and closes the file.
+ */
+void
+ResultsNpzExporter::close()
+{
+    // sanity check:
+    if( entries_.size() > std::numeric_limits<uint16_t>::max() )
+    {
+        throw std::runtime_error("Too many arrays for NPZ file.");
+    }
+
+    // write central directory:
+    uint64_t dirOffset = offset_;
+    for(auto &entry : entries_)
+    {
+        putUint32(0x02014b50);
+        putUint16(20);
+        putUint16(20);
+        putUint16(0);
+        putUint16(0);
+        putUint16(0);
+        putUint16(0x21);
+        putUint32(entry.crc_);
+        putUint32(entry.size_);
+        putUint32(entry.size_);
+        putUint16(static_cast<uint16_t>(entry.name_.size()));
+        putUint16(0);
+        putUint16(0);
+        putUint16(0);
+        putUint16(0);
+        putUint32(0);
+        putUint32(entry.offset_);
+        putBytes(entry.name_.c_str(), entry.name_.size());
+    }
+    uint64_t dirSize = offset_ - dirOffset;
+
+    // check size limit of archive without ZIP64 extension:
+    if( offset_ > std::numeric_limits<uint32_t>::max() )
+    {
+        throw std::runtime_error("NPZ file exceeds maximum size of 4 GiB.");
+    }
+
+    // write end of central directory record:
+    putUint32(0x06054b50);
+    putUint16(0);
+    putUint16(0);
+    putUint16(static_cast<uint16_t>(entries_.size()));
+    putUint16(static_cast<uint16_t>(entries_.size()));
+    putUint32(static_cast<uint32_t>(dirSize));
+    putUint32(static_cast<uint32_t>(dirOffset));
+    putUint16(0);
+
+    // close file:
+    stream_.close();
+}
+
+
+/*!
+ * Writes a single NPY file containing the given rows as an uncompressed 
+ * member of the ZIP archive.
+ */
+void
+ResultsNpzExporter::addEntry(
+        const std::string &name,
+        const std::vector<size_t> &shape,
+        const std::vector<const std::vector<real>*> &rows)
+{
+    // create NPY header and determine size of NPY file:
+    std::string header = npyHeader(shape);
+    uint64_t size = header.size();
+    for(auto row : rows)
+    {
+        size += row -> size() * sizeof(real);
+    }
+
+    // pad local header with an extra field so that NPY file (and hence array
+    // data) starts at a 64 byte boundary in the archive, an extra field 
+    // needs at least four bytes for its ID and length:
+    std::string fileName = name + ".npy";
+    size_t extraSize = (64 - (offset_ + 30 + fileName.size()) % 64) % 64;
+    if( extraSize > 0 && extraSize < 4 )
+    {
+        extraSize += 64;
+    }
+
+    // check size limit of archive without ZIP64 extension:
+    if( offset_ + 30 + fileName.size() + extraSize + size > 
+        std::numeric_limits<uint32_t>::max() )
+    {
+        throw std::runtime_error("NPZ file exceeds maximum size of 4 GiB.");
+    }
+
+    // checksum over entire NPY file:
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(
+            crc, 
+            reinterpret_cast<const Bytef*>(header.data()), 
+            header.size());
+    for(auto row : rows)
+    {
+        // zlib resets the checksum for null pointers, so skip empty rows:
+        if( row -> empty() )
+        {
+            continue;
+        }
+        crc = crc32(
+                crc, 
+                reinterpret_cast<const Bytef*>(row -> data()), 
+                row -> size() * sizeof(real));
+    }
+
+    // add entry to directory:
+    Entry entry;
+    entry.name_ = fileName;
+    entry.crc_ = static_cast<uint32_t>(crc);
+    entry.size_ = static_cast<uint32_t>(size);
+    entry.offset_ = static_cast<uint32_t>(offset_);
+    entries_.push_back(entry);
+
+    // write local file header (stored without compression):
+    putUint32(0x04034b50);
+    putUint16(20);
+    putUint16(0);
+    putUint16(0);
+    putUint16(0);
+    putUint16(0x21);
+    putUint32(entry.crc_);
+    putUint32(entry.size_);
+    putUint32(entry.size_);
+    putUint16(static_cast<uint16_t>(fileName.size()));
+    putUint16(static_cast<uint16_t>(extraSize));
+    putBytes(fileName.c_str(), fileName.size());
+
+    // alignment padding as extra field (ID as used by zipalign):
+    if( extraSize > 0 )
+    {
+        putUint16(0xd935);
+        putUint16(static_cast<uint16_t>(extraSize - 4));
+        std::string padding(extraSize - 4, '\0');
+        putBytes(padding.data(), padding.size());
+    }
+
+    // write NPY file:
+    putBytes(header.data(), header.size());
+    for(auto row : rows)
+    {
+        putBytes(
+                reinterpret_cast<const char*>(row -> data()), 
+                row -> size() * sizeof(real));
+    }
+}
+
+
+/*!
+ * Creates an NPY (version 1.0) header for an array of the given shape. The 
+ * header is padded to a multiple of 64 bytes so that, together with the 
+ * padding of the local file header in addEntry(), the array data is 64 byte 
+ * aligned within the archive.
+ */
+std::string
+ResultsNpzExporter::npyHeader(
+        const std::vector<size_t> &shape) const
+{
+    // determine byte order of this machine:
+    const uint16_t one = 1;
+    char byteOrder = (*reinterpret_cast<const char*>(&one) == 1) ? '<' : '>';
+
+    // shape as Python tuple (with trailing comma for one element):
+    std::string shapeStr = "(";
+    for(size_t i = 0; i < shape.size(); i++)
+    {
+        shapeStr += std::to_string(shape[i]);
+        if( i + 1 < shape.size() )
+        {
+            shapeStr += ", ";
+        }
+        else if( shape.size() == 1 )
+        {
+            shapeStr += ",";
+        }
+    }
+    shapeStr += ")";
+
+    // header dictionary:
+    std::string dict = "{'descr': '" + std::string(1, byteOrder) + "f" + 
+                       std::to_string(sizeof(real)) + "', 'fortran_order': "
+                       "False, 'shape': " + shapeStr + ", }";
+
+    // pad with spaces so that magic string, version, length, and dictionary
+    // add up to a multiple of 64 bytes (including terminating newline):
+    size_t prefixSize = 10;
+    size_t padding = 64 - (prefixSize + dict.size() + 1) % 64;
+    if( padding == 64 )
+    {
+        padding = 0;
+    }
+    dict += std::string(padding, ' ') + "\n";
+
+    // assemble header:
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header.push_back(static_cast<char>(dict.size() & 0xff));
+    header.push_back(static_cast<char>((dict.size() >> 8) & 0xff));
+    header += dict;
+
+    return header;
+}
+
+
+/*!
+ * Writes a 16 bit unsigned integer in little endian byte order.
+ */
+void
+ResultsNpzExporter::putUint16(
+        uint16_t value)
+{
+    char bytes[2] = {static_cast<char>(value & 0xff), 
+                     static_cast<char>((value >> 8) & 0xff)};
+    putBytes(bytes, 2);
+}
+
+
+/*!
+ * Writes a 32 bit unsigned integer in little endian byte order.
+ */
+void
+ResultsNpzExporter::putUint32(
+        uint32_t value)
+{
+    char bytes[4] = {static_cast<char>(value & 0xff), 
+                     static_cast<char>((value >> 8) & 0xff),
+                     static_cast<char>((value >> 16) & 0xff),
+                     static_cast<char>((value >> 24) & 0xff)};
+    putBytes(bytes, 4);
+}
+
+
+/*!
+ * Writes raw bytes to file and keeps track of the current file offset.
+ */
+void
+ResultsNpzExporter::putBytes(
+        const char *data,
+        size_t size)
+{
+    stream_.write(data, size);
+    offset_ += size;
+}
+
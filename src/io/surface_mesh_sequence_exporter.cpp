@@ -0,0 +1,180 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <limits>
+#include <stdexcept>
+
+#include "io/surface_mesh_sequence_exporter.hpp"
+
+
+/*!
+ * Constructor opens the output file and writes header and triangulation. 
+ * Existing files will be overwritten.
+ */
+SurfaceMeshSequenceExporter::SurfaceMeshSequenceExporter(
+        const std::string &fileName,
+        size_t numLen,
+        size_t numPhi)
+    : stream_(fileName)
+    , numLen_(numLen)
+    , numPhi_(numPhi)
+    , numFrames_(0)
+    , frameBuffer_(1 + 3*numLen*numPhi)
+{
+    // sanity checks:
+    if( numLen < 2 || numPhi < 3 )
+    {
+        throw std::logic_error("Surface mesh needs at least two vertex rings "
+                               "of three vertices each.");
+    }
+    if( numLen*numPhi > std::numeric_limits<uint32_t>::max() )
+    {
+        throw std::logic_error("Too many vertices in surface mesh.");
+    }
+
+    // write header:
+    stream_.write("CHAPMESH", 8);
+    putUint32(1);
+    putUint32(static_cast<uint32_t>(numLen_));
+    putUint32(static_cast<uint32_t>(numPhi_));
+
+    // write shared topology:
+    std::vector<uint32_t> tri = triangles(numLen_, numPhi_);
+    putUint32(static_cast<uint32_t>(tri.size()/3));
+    for(auto idx : tri)
+    {
+        putUint32(idx);
+    }
+}
+
+
+/*!
+ * Appends the vertices of one frame to the file. Vertices must be given in
+ * nm and ordered ring by ring, they are written in Angstrom for consistency
+ * with the OBJ output.
+ */
+void
+SurfaceMeshSequenceExporter::addFrame(
+        real time,
+        const std::vector<gmx::RVec> &vertices)
+{
+    // sanity check:
+    if( vertices.size() != numLen_*numPhi_ )
+    {
+        throw std::logic_error("Number of vertices does not match surface "
+                               "mesh topology.");
+    }
+
+    // convert frame to single precision in Angstrom:
+    frameBuffer_[0] = static_cast<float>(time);
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        frameBuffer_[1 + 3*i + XX] = static_cast<float>(10.0*vertices[i][XX]);
+        frameBuffer_[1 + 3*i + YY] = static_cast<float>(10.0*vertices[i][YY]);
+        frameBuffer_[1 + 3*i + ZZ] = static_cast<float>(10.0*vertices[i][ZZ]);
+    }
+
+    // write entire frame at once (assumes little endian host):
+    stream_.write(
+            reinterpret_cast<const char*>(frameBuffer_.data()),
+            frameBuffer_.size()*sizeof(float));
+    numFrames_++;
+}
+
+
+/*!
+ * Returns the number of frames written so far.
+ */
+size_t
+SurfaceMeshSequenceExporter::numFrames() const
+{
+    return numFrames_;
+}
+
+
+/*!
+ * Flushes all buffered frames and closes the file.
+ */
+void
+SurfaceMeshSequenceExporter::close()
+{
+    stream_.close();
+}
+
+
+/*!
+ * Returns the zero-based vertex indices of the triangles on a regular tube 
+ * grid with the given number of vertex rings and vertices per ring. Each 
+ * square of the grid is split into two triangles in the same way as in 
+ * RegularVertexGrid::faces(), including the squares closing each ring.
+ */
+std::vector<uint32_t>
+SurfaceMeshSequenceExporter::triangles(
+        size_t numLen,
+        size_t numPhi)
+{
+    std::vector<uint32_t> tri;
+    tri.reserve(6*(numLen - 1)*numPhi);
+
+    // adds both triangles of square with lower left corner (i, j):
+    auto addSquare = [&](size_t i, size_t j)
+    {
+        uint32_t bl = i*numPhi + j;
+        uint32_t br = i*numPhi + (j + 1) % numPhi;
+        uint32_t tl = bl + numPhi;
+        uint32_t tr = br + numPhi;
+        tri.insert(tri.end(), {bl, tr, tl, bl, br, tr});
+    };
+
+    // interior squares first, then wrap around:
+    for(size_t i = 0; i < numLen - 1; i++)
+    {
+        for(size_t j = 0; j < numPhi - 1; j++)
+        {
+            addSquare(i, j);
+        }
+    }
+    for(size_t i = 0; i < numLen - 1; i++)
+    {
+        addSquare(i, numPhi - 1);
+    }
+
+    return tri;
+}
+
+
+/*!
+ * Writes a 32 bit unsigned integer in little endian byte order.
+ */
+void
+SurfaceMeshSequenceExporter::putUint32(
+        uint32_t value)
+{
+    char bytes[4] = {static_cast<char>(value & 0xff), 
+                     static_cast<char>((value >> 8) & 0xff),
+                     static_cast<char>((value >> 16) & 0xff),
+                     static_cast<char>((value >> 24) & 0xff)};
+    stream_.write(bytes, 4);
+}
+
@@ -23,6 +23,10 @@
 
 
 #include <algorithm>
+#include <cmath>
+
+#include "external/rapidjson/internal/dtoa.h"
+#include "external/rapidjson/internal/itoa.h"
 
 #include "io/wavefront_obj_io.hpp"
 
@@ -234,35 +238,21 @@ WavefrontObjObject::setMaterialLibrary(std::string mtl)
 
 
 /*!
- * Scales the shape by a given factor. To this end, all vertex positions are 
- * shifted so that the centre of geometry is the origin. Then all position 
- * vectors are multiplied by a given factor before finally the positions are
- * shifted back again with the scaling factor also applied to the the shift
- * vector.
+ * Scales the shape by a given factor. Conceptually, all vertex positions are 
+ * shifted so that the centre of geometry is the origin, then multiplied by 
+ * the given factor, and finally shifted back with the scaling factor also 
+ * applied to the shift vector. As the shifts cancel, this is done as a single
+ * multiplication of all vertex positions.
  */
 void
 WavefrontObjObject::scale(real fac)
 {
-    // shift vertices to be centred around origin:
-    gmx::RVec shift = calculateCog();
-    shift[XX] = -shift[XX];
-    shift[YY] = -shift[YY];
-    shift[ZZ] = -shift[ZZ];
-    this -> shift(shift);
-
-    // scale all position vectors:
-    for(auto it = vertices_.begin(); it != vertices_.end(); it++)
+    for(auto &vertex : vertices_)
     {
-        (*it).first[XX] *= fac;
-        (*it).first[YY] *= fac;
-        (*it).first[ZZ] *= fac;
+        vertex.first[XX] *= fac;
+        vertex.first[YY] *= fac;
+        vertex.first[ZZ] *= fac;
     }
-
-    // shift vertices back to original centre of geometry:
-    shift[XX] *= -fac;
-    shift[YY] *= -fac;
-    shift[ZZ] *= -fac;
-    this -> shift(shift);
 }
 
 
@@ -271,11 +261,11 @@ WavefrontObjObject::scale(real fac)
  */
 void WavefrontObjObject::shift(gmx::RVec shift)
 {
-    for(auto it = vertices_.begin(); it != vertices_.end(); it++)
+    for(auto &vertex : vertices_)
     {
-        (*it).first[XX] += shift[XX];
-        (*it).first[YY] += shift[YY];
-        (*it).first[ZZ] += shift[ZZ];
+        vertex.first[XX] += shift[XX];
+        vertex.first[YY] += shift[YY];
+        vertex.first[ZZ] += shift[ZZ];
     }    
 }
 
@@ -288,11 +278,11 @@ WavefrontObjObject::calculateCog()
 {
     gmx::RVec cog(0.0, 0.0, 0.0);
 
-    for(auto it = vertices_.begin(); it != vertices_.end(); it++)
+    for(const auto &vertex : vertices_)
     {
-        cog[XX] += (*it).first[XX];
-        cog[YY] += (*it).first[YY];
-        cog[ZZ] += (*it).first[ZZ];
+        cog[XX] += vertex.first[XX];
+        cog[YY] += vertex.first[YY];
+        cog[ZZ] += vertex.first[ZZ];
     }
 
     cog[XX] /= vertices_.size();
@@ -347,10 +337,16 @@ WavefrontObjObject::valid() const
 
 /*!
  * Writes an OBJ object to a file of the given name. 
+ *
+ * Output is formatted directly into a large buffer, which is written to disk
+ * in chunks (see CompressedFileWriteStream). Floating point numbers are 
+ * converted using the Grisu2 algorithm and written with at most five decimal
+ * places, which avoids the comparatively slow iostream formatting. If the
+ * file name ends in .gz, the file is gzip compressed.
  */
 void
 WavefrontObjExporter::write(std::string fileName,
-                            WavefrontObjObject object)
+                            const WavefrontObjObject &object)
 {
     // sanity checks:
     if( !object.valid() )
@@ -360,7 +356,7 @@ WavefrontObjExporter::write(std::string fileName,
     }
 
     // open file stream:
-    obj_.open(fileName.c_str(), std::fstream::out);
+    obj_.reset(new CompressedFileWriteStream(fileName));
 
     // writer header comment:
     writeComment("produced by CHAP");
@@ -372,22 +368,21 @@ WavefrontObjExporter::write(std::string fileName,
     writeObject(object.name_);
 
     // write vertices:
-    obj_<<std::endl;
+    obj_ -> Put('\n');
     for(unsigned int i = 0; i < object.vertices_.size(); i++)
     {
         writeVertex(object.vertices_[i]);
     }
 
     // write vertex normals:
-    obj_<<std::endl;
+    obj_ -> Put('\n');
     for(unsigned int i = 0; i < object.normals_.size(); i++)
     {
         writeVertexNormal(object.normals_[i]);
     }
 
     // write groups:
-    std::vector<WavefrontObjGroup>::iterator it;
-    for(it = object.groups_.begin(); it != object.groups_.end(); it++)
+    for(auto it = object.groups_.begin(); it != object.groups_.end(); it++)
     {
         // write group name:
         writeGroup(it -> groupname_);
@@ -400,7 +395,8 @@ WavefrontObjExporter::write(std::string fileName,
     }
 
     // close file stream:
-    obj_.close();
+    obj_ -> close();
+    obj_.reset();
 }
 
 
@@ -408,9 +404,11 @@ WavefrontObjExporter::write(std::string fileName,
  * Writes a comment line to an OBJ file.
  */
 void
-WavefrontObjExporter::writeComment(std::string comment)
+WavefrontObjExporter::writeComment(const std::string &comment)
 {
-    obj_ <<"# "<<comment<<std::endl;
+    writeString("# ");
+    writeString(comment);
+    obj_ -> Put('\n');
 }
 
 
@@ -418,12 +416,14 @@ WavefrontObjExporter::writeComment(std::string comment)
  * Writes material library referenct to an OBJ file.
  */
 void
-WavefrontObjExporter::writeMaterialLibrary(std::string mtl)
+WavefrontObjExporter::writeMaterialLibrary(const std::string &mtl)
 {
     // library set?
     if( mtl != "" )
     {
-        obj_<<"mtllib "<<mtl<<std::endl;
+        writeString("mtllib ");
+        writeString(mtl);
+        obj_ -> Put('\n');
     }
 }
 
@@ -432,10 +432,11 @@ WavefrontObjExporter::writeMaterialLibrary(std::string mtl)
  * Writes a group line to an OBJ file.
  */
 void
-WavefrontObjExporter::writeGroup(std::string group)
+WavefrontObjExporter::writeGroup(const std::string &group)
 {
-    obj_ <<std::endl;
-    obj_ <<"g "<<group<<std::endl;
+    writeString("\ng ");
+    writeString(group);
+    obj_ -> Put('\n');
 }
 
 
@@ -443,10 +444,11 @@ WavefrontObjExporter::writeGroup(std::string group)
  * Writes an object line to an OBJ file.
  */
 void
-WavefrontObjExporter::writeObject(std::string object)
+WavefrontObjExporter::writeObject(const std::string &object)
 {
-    obj_ <<std::endl;
-    obj_ <<"o "<<object<<std::endl;
+    writeString("\no ");
+    writeString(object);
+    obj_ -> Put('\n');
 }
 
 
@@ -454,12 +456,17 @@ WavefrontObjExporter::writeObject(std::string object)
  * Writes a vertex entry to an OBJ file.
  */
 void
-WavefrontObjExporter::writeVertex(std::pair<gmx::RVec, real> vertex)
+WavefrontObjExporter::writeVertex(const std::pair<gmx::RVec, real> &vertex)
 {
-    obj_<<"v "<<vertex.first[XX]<<" "
-              <<vertex.first[YY]<<" "
-              <<vertex.first[ZZ]<<" "
-              <<vertex.second<<std::endl;
+    writeString("v ");
+    writeReal(vertex.first[XX]);
+    obj_ -> Put(' ');
+    writeReal(vertex.first[YY]);
+    obj_ -> Put(' ');
+    writeReal(vertex.first[ZZ]);
+    obj_ -> Put(' ');
+    writeReal(vertex.second);
+    obj_ -> Put('\n');
 }
 
 
@@ -467,16 +474,21 @@ WavefrontObjExporter::writeVertex(std::pair<gmx::RVec, real> vertex)
  * Writes a vertex normal to an OBJ file.
  */
 void
-WavefrontObjExporter::writeVertexNormal(gmx::RVec norm)
+WavefrontObjExporter::writeVertexNormal(const gmx::RVec &norm)
 {
-    obj_<<"vn "<<norm[XX]<<" "
-               <<norm[YY]<<" "
-               <<norm[ZZ]<<std::endl;
+    writeString("vn ");
+    writeReal(norm[XX]);
+    obj_ -> Put(' ');
+    writeReal(norm[YY]);
+    obj_ -> Put(' ');
+    writeReal(norm[ZZ]);
+    obj_ -> Put('\n');
 }
 
 
-/*
- *
+/*!
+ * Writes a face to an OBJ file, preceded by a material line if the material
+ * differs from the one of the previous face.
  */
 void
 WavefrontObjExporter::writeFace(const WavefrontObjFace &face)
@@ -488,25 +500,73 @@ WavefrontObjExporter::writeFace(const WavefrontObjFace &face)
         if( face.mtlName_ != crntMtlName_ )
         {
             crntMtlName_ = face.mtlName_;
-            obj_<<"usemtl "<<face.mtlName_<<std::endl;
+            writeString("usemtl ");
+            writeString(face.mtlName_);
+            obj_ -> Put('\n');
         }
     }
 
     // write actual face entry:
-    obj_<<"f ";
+    writeString("f ");
 
     for(size_t i = 0; i < face.numVertices(); i++)
     {
-        obj_<<face.vertexIdx(i);
+        writeInt(face.vertexIdx(i));
 
         if( face.hasNormals() )
         {
-            obj_<<"//"<<face.normalIdx(i);
+            writeString("//");
+            writeInt(face.normalIdx(i));
         }
 
-        obj_<<" ";
+        obj_ -> Put(' ');
     }
 
-    obj_<<std::endl;
+    obj_ -> Put('\n');
+}
+
+
+/*!
+ * Writes a string to the output buffer.
+ */
+void
+WavefrontObjExporter::writeString(const std::string &str)
+{
+    obj_ -> write(str.data(), str.size());
+}
+
+
+/*!
+ * Formats an integer into the output buffer.
+ */
+void
+WavefrontObjExporter::writeInt(int value)
+{
+    char buffer[16];
+    char *end = rapidjson::internal::i32toa(value, buffer);
+    obj_ -> write(buffer, end - buffer);
 }
 
+
+/*!
+ * Formats a floating point number into the output buffer. Non-finite values
+ * are written in the same way as by iostreams.
+ */
+void
+WavefrontObjExporter::writeReal(real value)
+{
+    if( std::isnan(value) )
+    {
+        writeString("nan");
+    }
+    else if( std::isinf(value) )
+    {
+        writeString(value > 0 ? "inf" : "-inf");
+    }
+    else
+    {
+        char buffer[32];
+        char *end = rapidjson::internal::dtoa(value, buffer, 5);
+        obj_ -> write(buffer, end - buffer);
+    }
+}
@@ -28,8 +28,6 @@
 #include <limits>
 #include <ctime>
 
-#include <boost/math/tools/minima.hpp>
-
 #include <gromacs/pbcutil/pbc.h>
 #include <gromacs/selection/nbsearch.h>
 #include <gromacs/selection/selection.h>
@@ -83,6 +81,9 @@ MolecularPath::MolecularPath(std::vector<gmx::RVec> &pathPoints,
 
     // re-parameterise centre line spline by arc length:
     centreLine_.arcLengthParam();
+
+    // minimum radius and volume are only computed once:
+    prepareRadiusProperties();
 }
 
 
@@ -240,6 +241,9 @@ MolecularPath::MolecularPath(
     {
         throw std::logic_error("Pore opening coordinates out of order.");
     }
+
+    // minimum radius and volume are only computed once:
+    prepareRadiusProperties();
 }
 
 
@@ -398,7 +402,7 @@ MolecularPath::addScalarProperty(
 /*!
  * Returns map of scalar properties associated with the MolecularPath.
  */
-std::map<std::string, std::pair<SplineCurve1D, bool>>
+const std::map<std::string, std::pair<SplineCurve1D, bool>>&
 MolecularPath::scalarProperties() const
 {
     return properties_;
@@ -409,8 +413,8 @@ MolecularPath::scalarProperties() const
  * Simple getter function for access to original path points used to construct
  * the path.
  */
-std::vector<gmx::RVec>
-MolecularPath::pathPoints()
+const std::vector<gmx::RVec>&
+MolecularPath::pathPoints() const
 {
     return pathPoints_;
 }
@@ -420,28 +424,32 @@ MolecularPath::pathPoints()
  * Simple getter function for access to original radii used to construct the 
  * path.
  */
-std::vector<real>
-MolecularPath::pathRadii()
+const std::vector<real>&
+MolecularPath::pathRadii() const
 {
     return pathRadii_;
 }
 
 
 /*!
- * Returns a copy of the internal pore radius spline.
+ * Returns a reference to the internal pore radius spline. Callers that need to
+ * evaluate the spline can copy it cheaply, as knots and control points are 
+ * shared between copies.
  */
-SplineCurve1D
-MolecularPath::pathRadius()
+const SplineCurve1D&
+MolecularPath::pathRadius() const
 {
     return poreRadius_;
 }
 
 
 /*!
- * Returns a copy of the internal centre line spline.
+ * Returns a reference to the internal centre line spline. Callers that need 
+ * to evaluate the spline can copy it cheaply, as knots and control points are
+ * shared between copies.
  */
-SplineCurve3D
-MolecularPath::centreLine()
+const SplineCurve3D&
+MolecularPath::centreLine() const
 {
     return centreLine_;
 }
@@ -473,7 +481,7 @@ MolecularPath::radius(real s)
  * Returns coordinates of the lower opening of the pore.
  */
 real
-MolecularPath::sLo()
+MolecularPath::sLo() const
 {
     return openingLo_;
 }
@@ -483,7 +491,7 @@ MolecularPath::sLo()
  * Returns the coordinates of the upper opening of the pore.
  */
 real
-MolecularPath::sHi()
+MolecularPath::sHi() const
 {
     return openingHi_;
 }
@@ -493,7 +501,7 @@ MolecularPath::sHi()
  * Getter method for access to the radius spline's knot vector. This returns 
  * the complete knot vector including duplicate points at the ends.
  */
-std::vector<real>
+const std::vector<real>&
 MolecularPath::poreRadiusKnots() const
 {
     return poreRadius_.knotVector();
@@ -503,23 +511,24 @@ MolecularPath::poreRadiusKnots() const
 /*!
  * Getter method for access to the radius spline's knot vector. This does strip
  * the knot vector of repeated knots at end points so that the resulting vector 
- * has as many elements as the vector of control points.
+ * has as many elements as the vector of control points. The returned view
+ * refers to the knot vector of the radius spline and is invalidated when the
+ * path is modified.
  */
-std::vector<real>
+ArrayView<real>
 MolecularPath::poreRadiusUniqueKnots() const
 {           
-    std::vector<real> allKnots = poreRadius_.knotVector();
-    std::vector<real> uniqueKnots(
-        allKnots.begin() + poreRadius_.degree() - 1, 
-        allKnots.end() - poreRadius_.degree() + 1);
-    return uniqueKnots;
+    const std::vector<real> &allKnots = poreRadius_.knotVector();
+    return ArrayView<real>(
+            allKnots.data() + poreRadius_.degree() - 1, 
+            allKnots.data() + allKnots.size() - poreRadius_.degree() + 1);
 }
 
 
 /*!
  * Getter method for access to the radius spline's control points.
  */
-std::vector<real>
+const std::vector<real>&
 MolecularPath::poreRadiusCtrlPoints() const
 {
     return poreRadius_.ctrlPoints();
@@ -531,7 +540,7 @@ MolecularPath::poreRadiusCtrlPoints() const
  * This returns  the complete knot vector including duplicate points at the 
  * ends.
  */
-std::vector<real>
+const std::vector<real>&
 MolecularPath::centreLineKnots() const
 {
     return centreLine_.knotVector();
@@ -541,23 +550,24 @@ MolecularPath::centreLineKnots() const
 /*!
  * Getter method for access to the centre line spline's knot vector. This does 
  * strip the knot vector of repeated knots at end points so that the resulting 
- * vector has as many elements as the vector of control points.
+ * vector has as many elements as the vector of control points. The returned 
+ * view refers to the knot vector of the centre line spline and is invalidated
+ * when the path is modified.
  */
-std::vector<real>
+ArrayView<real>
 MolecularPath::centreLineUniqueKnots() const
 {
-    std::vector<real> allKnots = centreLine_.knotVector();
-    std::vector<real> uniqueKnots(
-            allKnots.begin() + centreLine_.degree() - 1,
-            allKnots.end() - centreLine_.degree() + 1);
-    return uniqueKnots;
+    const std::vector<real> &allKnots = centreLine_.knotVector();
+    return ArrayView<real>(
+            allKnots.data() + centreLine_.degree() - 1,
+            allKnots.data() + allKnots.size() - centreLine_.degree() + 1);
 }
 
 
 /*!
  * Getter method for access to the centre line spline's control points.
  */
-std::vector<gmx::RVec>
+const std::vector<gmx::RVec>&
 MolecularPath::centreLineCtrlPoints() const
 {
     return centreLine_.ctrlPoints();
@@ -566,59 +576,15 @@ MolecularPath::centreLineCtrlPoints() const
 
 
 /*!
- * Finds the minimum radius of the path and the location along the centre line
- * (in the current parameterisation) of this minimum. 
- *
- * This is achieved by first sampling a set of trial points no more than 0.1
- * nm apart along the centreline and evaluating the path radius at all of these
- * points. The position of the minimum radius sample point is then used to 
- * create input to Brent's minimisation algorithm. The initial bracketing 
- * interval for Brent's algorithm is taken as one sampling point above and 
- * below the minimum radius sampling point, if this point lies somewhere in 
- * between the the centre line's endpoints. If the minimum radius sampling
- * point falls on either endpoint of the centeline, this point itself is taken
- * as one of the bracketing interval's limits.
- *
- * Note that Brent's algorithm is currently limited to a hardcoded limit of
- * 100 iterations.
+ * Returns the minimum radius of the path and the location along the centre 
+ * line (in the current parameterisation) of this minimum as a pair of arg min
+ * and min. This is computed once on construction, see 
+ * prepareRadiusProperties().
  */
 std::pair<real, real>
-MolecularPath::minRadius()
-{
-    // internal parameters:
-    real maxSampleDist = 0.1;
-    boost::uintmax_t maxIter = 100;
-
-    // draw radius samples along path:
-    int nSamples = std::ceil(length_/maxSampleDist);
-    std::vector<real> s = sampleArcLength(nSamples, 0.0);
-    std::vector<real> r = sampleRadii(s);
-   
-    // find smallest sample radius:
-    auto itMin = std::min_element(r.begin(), r.end());
-    int idxMin = std::distance(r.begin(), itMin);
-
-    // determine bracketing interval:
-    real sMin = s[idxMin - 1];
-    real sMax = s[idxMin + 1];
-    if( itMin == r.begin() )
-    {
-        sMin = s[idxMin];
-        sMax = s[idxMin + 1];
-    }
-    else if( itMin == r.end() )
-    {
-        sMin = s[idxMin - 1];
-        sMax = s[idxMin];
-    }
-
-    // return minimum and arg min:    
-    return boost::math::tools::brent_find_minima(
-            std::bind(&MolecularPath::radius, this, std::placeholders::_1), 
-            sMin, 
-            sMax, 
-            std::numeric_limits<real>::digits,
-            maxIter);
+MolecularPath::minRadius() const
+{
+    return minRadius_;
 }
 
 
@@ -633,65 +599,37 @@ MolecularPath::minRadius()
  *  \f]
  *
  *  where \f$ R(s) \f$ denotes the radius at a given point along the spline.
+ *  This is computed once on construction, see prepareRadiusProperties().
  *
- *  This integral is solved numerically by applying a sixth order Newton-Cotes
- *  scheme (Weddle's rule) in each interval between two subsequent knots. Since
- *  the path radius is \f$ \mathcal{O}(s^3) \f$ by construction, the integrand 
- *  is guaranteed to be of order \f$ \mathcal{O}(s^6) \f$ so the integration
- *  is exact.
- *
- *  The volume is nonetheless an estimate due to (i) the cross-sectional area
- *  of a path not being truly circular and (ii) the dependency of radius on
- *  centre line parameter not being \f$ \mathcal{O}(s^3) \f$ necessarily. The 
- *  former effect is likely stronger so that the volume estimate should be 
- *  viewed as a lower bound.
+ *  The volume is an estimate due to (i) the cross-sectional area of a path 
+ *  not being truly circular and (ii) the dependency of radius on centre line
+ *  parameter not being \f$ \mathcal{O}(s^3) \f$ necessarily. The former 
+ *  effect is likely stronger so that the volume estimate should be viewed as
+ *  a lower bound.
  */
 real
-MolecularPath::volume()
-{
-    // initialise number of intervals larger than number of spline intervals:
-    // (this ensures that function is polynomial on each interval)
-    size_t numIntervals = (poreRadius_.nKnots()) - 2*poreRadius_.degree() - 1;
-
-    // integration interval:
-    real h = length_/numIntervals;
-
-    // sample path radii:
-    int numPoints = 6*numIntervals + 1;
-    std::vector<real> radii = sampleRadii(numPoints, 0.0);
-    std::vector<real> s = sampleArcLength(numPoints, 0.0);
-  
-    // calculate squared radii:
-    std::vector<real> sqRadii;
-    sqRadii.reserve(radii.size());
-    for(size_t i = 0; i < radii.size(); i++)
-    {
-        sqRadii.push_back(radii[i]*radii[i]);
-    }
-
-    // evaluate integral using fine grained support points:
-    real integral = 0.0;
-    for(size_t i = 0; i < numIntervals; i++)
-    {
-        // index to vector of radii:
-        int idx = 6*i;
-
-        // integrate this interval using Weddle's Rule:
-        integral +=  41.0*sqRadii[idx] + 
-                    216.0*sqRadii[idx+1] +
-                     27.0*sqRadii[idx+2] +
-                    272.0*sqRadii[idx+3] + 
-                     27.0*sqRadii[idx+4] +
-                    216.0*sqRadii[idx+5] +
-                     41.0*sqRadii[idx+6];
-    }
-    integral *= h/840.0;
+MolecularPath::volume() const
+{
+    return volume_;
+}
 
-    // multiply in constant factor:
-    integral *= PI_;
 
-    // return value of integral:
-    return integral;
+/*!
+ * Computes the minimum radius and the volume of the path, which are then 
+ * available through minRadius() and volume() without further computation.
+ *
+ * As the radius spline is a piecewise cubic polynomial, both quantities are
+ * obtained exactly: the minimum from the roots of the derivative in each 
+ * knot interval (see SplineCurve1D::minimum()) and the volume integral from 
+ * the closed-form integral of \f$ R(s)^2 \f$ in each knot interval (see 
+ * SplineCurve1D::integrateSquare()). No sampling of the radius is required.
+ */
+void
+MolecularPath::prepareRadiusProperties()
+{
+    std::pair<real, real> lim(openingLo_, openingHi_);
+    minRadius_ = poreRadius_.minimum(lim);
+    volume_ = PI_*poreRadius_.integrateSquare(lim);
 }
 
 
@@ -923,7 +861,9 @@ MolecularPath::sampleRadii(std::vector<real> arcLengthSample)
 
 
 /*!
- * Shift the s-coordinate by the given number.
+ * Shift the s-coordinate by the given number. Cached summary quantities are
+ * updated accordingly, where only the location of the minimum radius depends
+ * on the parameterisation.
  */
 void
 MolecularPath::shift(const gmx::RVec &shift)
@@ -935,6 +875,7 @@ MolecularPath::shift(const gmx::RVec &shift)
     // adjust convenience variables defined in MolecularPath itself:
     openingLo_ -= shift[SS];
     openingHi_ -= shift[SS];
+    minRadius_.first -= shift[SS];
 }
 
 
@@ -0,0 +1,235 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <stdexcept>
+
+#include "statistics/block_average.hpp"
+
+
+/*!
+ * Constructor creates an empty block average with a single level.
+ */
+BlockAverage::BlockAverage()
+    : levels_(1)
+    , pending_(1, 0.0)
+    , hasPending_(1, false)
+{
+
+}
+
+
+/*!
+ * Returns the mean of all values added so far.
+ */
+real
+BlockAverage::mean() const
+{
+    return levels_.front().mean();
+}
+
+
+/*!
+ * Returns the estimate of the standard error of the mean. See class 
+ * documentation for details of the plateau criterion. Zero is returned if
+ * less than two values have been added, in analogy to 
+ * SummaryStatistics::sd().
+ */
+real
+BlockAverage::standardError() const
+{
+    // handle case of insufficient data:
+    if( levels_.front().num() < 2 )
+    {
+        return 0.0;
+    }
+
+    // naive estimate is used if there are too few blocks for coarse graining:
+    real maxErr = standardError(0);
+
+    // loop over levels with sufficient number of blocks:
+    for(size_t k = 0; k + 1 < levels_.size(); k++)
+    {
+        // next level must have sufficient number of blocks:
+        if( levels_[k + 1].num() < minNumBlocks() )
+        {
+            break;
+        }
+
+        // error estimate on this and next level:
+        real err = standardError(k);
+        real errNext = standardError(k + 1);
+        maxErr = std::max(maxErr, errNext);
+
+        // uncertainty of error estimate on this level:
+        real errErr = err/std::sqrt(2.0*(levels_[k].num() - 1.0));
+
+        // plateau reached?
+        if( errNext - err < errErr )
+        {
+            return std::max(err, errNext);
+        }
+    }
+
+    // no plateau found, return largest estimate:
+    return maxErr;
+}
+
+
+/*!
+ * Returns the standard error estimate at the given blocking level, i.e. for
+ * blocks of size \f$ 2^k \f$. Returns zero if there are fewer than two blocks
+ * at this level.
+ */
+real
+BlockAverage::standardError(
+        size_t level) const
+{
+    // sanity check:
+    if( level >= levels_.size() )
+    {
+        throw std::out_of_range("Requested blocking level does not exist.");
+    }
+
+    // handle case of insufficient data:
+    if( levels_[level].num() < 2 )
+    {
+        return 0.0;
+    }
+
+    return std::sqrt(levels_[level].var()/levels_[level].num());
+}
+
+
+/*!
+ * Returns the number of blocking levels.
+ */
+size_t
+BlockAverage::numLevels() const
+{
+    return levels_.size();
+}
+
+
+/*!
+ * Returns the number of values added so far.
+ */
+int
+BlockAverage::num() const
+{
+    return levels_.front().num();
+}
+
+
+/*!
+ * Minimum number of blocks required at a level for it to be considered in 
+ * the standard error estimate.
+ */
+int
+BlockAverage::minNumBlocks()
+{
+    return 16;
+}
+
+
+/*!
+ * Adds a new value to the time series. Infinite values are skipped.
+ */
+void
+BlockAverage::update(
+        const real newValue)
+{
+    // handle infinities:
+    if( std::isinf(newValue) )
+    {
+        return;
+    }
+
+    addToLevel(0, newValue);
+}
+
+
+/*!
+ * Convenience function to update a vector of BlockAverage objects with a 
+ * vector of new values.
+ */
+void
+BlockAverage::updateMultiple(
+        std::vector<BlockAverage> &blockAvg,
+        const std::vector<real> &newValues)
+{
+    // sanity check:
+    if( blockAvg.size() != newValues.size() )
+    {
+        throw std::logic_error("Can not update block average vector with "
+                               "data vector of different size.");
+    }
+
+    // update each value individually:
+    for(size_t i = 0; i < blockAvg.size(); i++)
+    {
+        blockAvg[i].update(newValues[i]);
+    }
+}
+
+
+/*!
+ * Auxiliary function that adds a value to the given level. If a value is 
+ * already pending at this level, the mean of both values is passed on to the
+ * next level, otherwise the value is kept until its partner arrives.
+ */
+void
+BlockAverage::addToLevel(
+        size_t level,
+        real value)
+{
+    // iterate rather than recurse through levels:
+    while( true )
+    {
+        // add value to statistics of this level:
+        levels_[level].update(value);
+
+        // no partner yet, keep value pending:
+        if( !hasPending_[level] )
+        {
+            pending_[level] = value;
+            hasPending_[level] = true;
+            return;
+        }
+
+        // complete block and pass mean on to next level:
+        value = 0.5*(pending_[level] + value);
+        hasPending_[level] = false;
+        level++;
+
+        // create next level if necessary:
+        if( level == levels_.size() )
+        {
+            levels_.push_back(SummaryStatistics());
+            pending_.push_back(0.0);
+            hasPending_.push_back(false);
+        }
+    }
+}
+
@@ -23,6 +23,7 @@
 
 
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <stdexcept>
 #include <string>
@@ -34,10 +35,15 @@
 
 
 /*!
- * Sets initial bin width to zero.
+ * Sets initial bin width to zero. No fixed range is set initially, i.e. the
+ * estimator will adapt the histogram range to each sample.
  */
 HistogramDensityEstimator::HistogramDensityEstimator()
     : binWidth_(0.0)
+    , rangeIsSet_(false)
+    , rangeLo_(0.0)
+    , rangeHi_(0.0)
+    , numAccumulated_(0)
 {
 
 }
@@ -48,6 +54,12 @@ HistogramDensityEstimator::HistogramDensityEstimator()
  * returns a one-dimensional spline curve representing the probability density
  * of the samples. The spline curve is normalised such that its integral is
  * one.
+ *
+ * If a fixed range has been set with setRange(), the samples are binned 
+ * directly on the fixed grid without sorting and samples outside the range 
+ * are ignored. Otherwise the samples are sorted and the histogram range is
+ * adapted to the data range. The accumulator is not affected by this 
+ * function.
  */
 SplineCurve1D
 HistogramDensityEstimator::estimate(
@@ -59,6 +71,14 @@ HistogramDensityEstimator::estimate(
         throw std::logic_error("Histogram bin width must be a positive number!");
     }
 
+    // fixed range histogram does not require sorting:
+    if( rangeIsSet_ )
+    {
+        std::vector<size_t> counts(numFixedRangeBins(), 0);
+        size_t numBinned = binFixedRange(samples, counts);
+        return fixedRangeDensity(counts, numBinned);
+    }
+
     // make sure input data is sorted:
     std::sort(samples.begin(), samples.end());
 
@@ -68,18 +88,6 @@ HistogramDensityEstimator::estimate(
     // compute midpoints corresponding to these breakpoints:
     std::vector<real> midpoints = createMidpoints(breaks);
 
-    // emergency break for histogram size:
-    // (If number of bins gets too large, the spline interpolation code will
-    // fail with a segfault. This hardcoded limit is supposed to prevent that 
-    // situation, but in practice the reasonable size limit for number of 
-    // histogram bins is probably lower due to performance constraints.)
-    size_t maxBinNumber = 25000;
-    if( midpoints.size() > maxBinNumber )
-    {
-        throw std::runtime_error("Number of bins exceeds limit for spline "
-        "interpolation! Need to increase bin width.");
-    }
-    
     // calculate density:
     std::vector<real> density = calculateDensity(samples, breaks);
 
@@ -142,6 +150,116 @@ HistogramDensityEstimator::setBinWidth(
 
     // set internal bin width parameter:
     binWidth_ = binWidth;
+
+    // accumulated counts refer to the old bins:
+    resetAccumulator();
+}
+
+
+/*!
+ * Sets a fixed range for the histogram and thereby switches the estimator to
+ * streaming mode. The range is padded with one empty bin on either side so
+ * that the density spline will be zero outside the histogram range. Any
+ * previously accumulated counts are discarded.
+ */
+void
+HistogramDensityEstimator::setRange(
+        real rangeLo,
+        real rangeHi)
+{
+    // sanity check:
+    if( !(rangeLo < rangeHi) )
+    {
+        throw std::logic_error("Lower histogram range limit must be smaller "
+                               "than upper histogram range limit!");
+    }
+
+    // set internal range parameters:
+    rangeLo_ = rangeLo;
+    rangeHi_ = rangeHi;
+    rangeIsSet_ = true;
+
+    // accumulated counts refer to the old bins:
+    resetAccumulator();
+}
+
+
+/*!
+ * Adds a set of samples to the accumulated counts of the fixed range 
+ * histogram. This can be called repeatedly (e.g. once per trajectory frame)
+ * and the density of all accumulated samples can be obtained by calling
+ * accumulatedEstimate(). Samples outside the histogram range are ignored.
+ */
+void
+HistogramDensityEstimator::accumulate(
+        const std::vector<real> &samples)
+{
+    // sanity checks:
+    if( binWidth_ <= 0 )
+    {
+        throw std::logic_error("Histogram bin width must be a positive number!");
+    }
+    if( !rangeIsSet_ )
+    {
+        throw std::logic_error("Histogram range must be set before samples "
+                               "can be accumulated!");
+    }
+
+    // lazy allocation of accumulator:
+    if( counts_.empty() )
+    {
+        counts_.assign(numFixedRangeBins(), 0);
+    }
+
+    // add samples to counts:
+    numAccumulated_ += binFixedRange(samples, counts_);
+}
+
+
+/*!
+ * Returns the probability density of all samples accumulated since the last
+ * reset as a linearly interpolated spline curve.
+ */
+SplineCurve1D
+HistogramDensityEstimator::accumulatedEstimate() const
+{
+    // sanity checks:
+    if( !rangeIsSet_ )
+    {
+        throw std::logic_error("Histogram range must be set before "
+                               "accumulated density can be estimated!");
+    }
+
+    // handle case of no samples accumulated yet:
+    if( counts_.empty() )
+    {
+        std::vector<size_t> counts(numFixedRangeBins(), 0);
+        return fixedRangeDensity(counts, 0);
+    }
+
+    return fixedRangeDensity(counts_, numAccumulated_);
+}
+
+
+/*!
+ * Discards all accumulated counts.
+ */
+void
+HistogramDensityEstimator::resetAccumulator()
+{
+    counts_.clear();
+    numAccumulated_ = 0;
+}
+
+
+/*!
+ * Returns the number of samples that have been accumulated into the histogram
+ * since the last reset (excluding samples outside the histogram range).
+ */
+size_t
+HistogramDensityEstimator::numAccumulated() const
+{
+    return numAccumulated_;
 }
 
 
@@ -277,3 +395,84 @@ HistogramDensityEstimator::calculateDensity(
     return(density);
 }
 
+
+/*!
+ * Auxiliary function returning the number of bins in fixed range mode. This 
+ * includes one empty padding bin below and above the histogram range.
+ */
+size_t
+HistogramDensityEstimator::numFixedRangeBins() const
+{
+    return static_cast<size_t>(std::ceil((rangeHi_ - rangeLo_)/binWidth_)) + 2;
+}
+
+
+/*!
+ * Auxiliary function for adding samples to the counts of a fixed range 
+ * histogram. Bin indices are computed directly from the sample value, so that
+ * the sample does not need to be sorted. The first and last bin are padding 
+ * bins and remain empty, samples outside the histogram range are ignored.
+ * Returns the number of samples that were added to the histogram.
+ */
+size_t
+HistogramDensityEstimator::binFixedRange(
+        const std::vector<real> &samples,
+        std::vector<size_t> &counts) const
+{
+    // last bin that can receive samples:
+    const size_t idxMax = counts.size() - 2;
+    const real invBinWidth = 1.0/binWidth_;
+    size_t numBinned = 0;
+
+    // loop over samples and increment bin counts:
+    for(auto sample : samples)
+    {
+        // ignore samples outside histogram range:
+        if( !(sample >= rangeLo_ && sample <= rangeHi_) )
+        {
+            continue;
+        }
+
+        // index of bin containing sample (offset by one for padding bin):
+        size_t idx = 1 + static_cast<size_t>((sample - rangeLo_)*invBinWidth);
+        counts[std::min(idx, idxMax)]++;
+        numBinned++;
+    }
+
+    return numBinned;
+}
+
+
+/*!
+ * Auxiliary function for converting fixed range histogram counts into a 
+ * probability density, which is then interpolated linearly at the bin 
+ * midpoints. For an empty sample, an all-zero density is returned.
+ */
+SplineCurve1D
+HistogramDensityEstimator::fixedRangeDensity(
+        const std::vector<size_t> &counts,
+        size_t numSamples) const
+{
+    // bin midpoints (first bin is padding bin below range):
+    std::vector<real> midpoints;
+    midpoints.reserve(counts.size());
+    for(size_t i = 0; i < counts.size(); i++)
+    {
+        midpoints.push_back(rangeLo_ + (i - 0.5)*binWidth_);
+    }
+
+    // normalise counts to obtain density:
+    std::vector<real> density(counts.size(), 0.0);
+    if( numSamples > 0 )
+    {
+        real norm = 1.0/(numSamples*binWidth_);
+        for(size_t i = 0; i < counts.size(); i++)
+        {
+            density[i] = counts[i]*norm;
+        }
+    }
+
+    // linear interpolation avoids negative densities:
+    LinearSplineInterp1D Interp;
+    return Interp(midpoints, density);
+}
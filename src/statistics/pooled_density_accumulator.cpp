@@ -0,0 +1,290 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "statistics/pooled_density_accumulator.hpp"
+
+
+/*!
+ * Constructor creates an empty accumulator. The bin width is initially zero
+ * and must be set with setBinWidth() before samples can be added.
+ */
+PooledDensityAccumulator::PooledDensityAccumulator()
+    : binWidth_(0.0)
+    , idxOffset_(0)
+    , numFrames_(0)
+    , totalWeight_(0.0)
+{
+
+}
+
+
+/*!
+ * Setter method for the bin width. As the bins refer to the grid defined by 
+ * the bin width, this also discards all previously accumulated samples.
+ */
+void
+PooledDensityAccumulator::setBinWidth(
+        real binWidth)
+{
+    // sanity check:
+    if( binWidth <= 0.0 )
+    {
+        throw std::logic_error("Bin width of pooled density must be "
+                               "positive!");
+    }
+
+    // set bin width and clear accumulated data:
+    binWidth_ = binWidth;
+    reset();
+}
+
+
+/*!
+ * Adds the samples of one frame to the accumulated bins, where each sample
+ * has unit weight.
+ */
+void
+PooledDensityAccumulator::addFrame(
+        const std::vector<real> &samples)
+{
+    std::vector<real> weights(samples.size(), 1.0);
+    addFrame(samples, weights);
+}
+
+
+/*!
+ * Adds the samples of one frame to the accumulated bins, where each sample
+ * contributes the corresponding weight to the bin it falls into. Bin indices
+ * are computed directly from the sample values, so that this scales linearly
+ * with the number of samples. Non-finite samples are ignored. The frame 
+ * counter is incremented even if no samples are given, as an empty frame 
+ * still contributes to the frame-averaged density.
+ */
+void
+PooledDensityAccumulator::addFrame(
+        const std::vector<real> &samples,
+        const std::vector<real> &weights)
+{
+    // sanity checks:
+    if( binWidth_ <= 0.0 )
+    {
+        throw std::logic_error("Bin width of pooled density must be set "
+                               "before samples can be added!");
+    }
+    if( samples.size() != weights.size() )
+    {
+        throw std::logic_error("Number of samples and weights must be "
+                               "equal!");
+    }
+
+    // compute bin index of each sample and find range of indices:
+    std::vector<long int> idx(samples.size(), 0);
+    long int idxLo = std::numeric_limits<long int>::max();
+    long int idxHi = std::numeric_limits<long int>::min();
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        if( std::isfinite(samples[i]) )
+        {
+            idx[i] = static_cast<long int>(std::floor(samples[i]/binWidth_));
+            idxLo = std::min(idxLo, idx[i]);
+            idxHi = std::max(idxHi, idx[i]);
+        }
+    }
+
+    // make sure all samples fall into existing bins:
+    extendBins(idxLo, idxHi);
+
+    // add weights to bins:
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+        if( std::isfinite(samples[i]) )
+        {
+            bins_[idx[i] - idxOffset_] += weights[i];
+            totalWeight_ += weights[i];
+        }
+    }
+
+    // increment frame counter:
+    numFrames_++;
+}
+
+
+/*!
+ * Discards all accumulated samples, but keeps the bin width.
+ */
+void
+PooledDensityAccumulator::reset()
+{
+    bins_.clear();
+    idxOffset_ = 0;
+    numFrames_ = 0;
+    totalWeight_ = 0.0;
+}
+
+
+/*!
+ * Returns the number of frames added to the accumulator.
+ */
+size_t
+PooledDensityAccumulator::numFrames() const
+{
+    return numFrames_;
+}
+
+
+/*!
+ * Returns the total weight of all samples added to the accumulator (i.e. 
+ * the number of samples if no weights were given).
+ */
+real
+PooledDensityAccumulator::totalWeight() const
+{
+    return totalWeight_;
+}
+
+
+/*!
+ * Returns the probability density of all pooled samples at the given 
+ * evaluation points. The density is normalised such that its integral is 
+ * one. If no samples have been accumulated, a zero density is returned.
+ */
+std::vector<real>
+PooledDensityAccumulator::probabilityDensity(
+        const std::vector<real> &evalPoints) const
+{
+    real norm = 0.0;
+    if( totalWeight_ > 0.0 )
+    {
+        norm = 1.0/(totalWeight_*binWidth_);
+    }
+    return interpolateBins(evalPoints, norm);
+}
+
+
+/*!
+ * Returns the accumulated weight per unit length averaged over all frames at
+ * the given evaluation points. If no frames have been accumulated, a zero 
+ * density is returned.
+ */
+std::vector<real>
+PooledDensityAccumulator::frameAveragedDensity(
+        const std::vector<real> &evalPoints) const
+{
+    real norm = 0.0;
+    if( numFrames_ > 0 )
+    {
+        norm = 1.0/(numFrames_*binWidth_);
+    }
+    return interpolateBins(evalPoints, norm);
+}
+
+
+/*!
+ * Auxiliary function that extends the bin vector so that it covers all bin
+ * indices in the given range. New bins are initialised as empty.
+ */
+void
+PooledDensityAccumulator::extendBins(
+        long int idxLo,
+        long int idxHi)
+{
+    // nothing to do if range is empty:
+    if( idxHi < idxLo )
+    {
+        return;
+    }
+
+    // first allocation:
+    if( bins_.empty() )
+    {
+        bins_.assign(idxHi - idxLo + 1, 0.0);
+        idxOffset_ = idxLo;
+        return;
+    }
+
+    // extend bins below current range:
+    if( idxLo < idxOffset_ )
+    {
+        bins_.insert(bins_.begin(), idxOffset_ - idxLo, 0.0);
+        idxOffset_ = idxLo;
+    }
+
+    // extend bins above current range:
+    long int idxEnd = idxOffset_ + static_cast<long int>(bins_.size());
+    if( idxHi >= idxEnd )
+    {
+        bins_.insert(bins_.end(), idxHi - idxEnd + 1, 0.0);
+    }
+}
+
+
+/*!
+ * Auxiliary function for evaluating the accumulated bins at the given points.
+ * Bin values are scaled by the given normalisation factor and interpolated 
+ * linearly between bin centres. Outside the accumulated range the bins are 
+ * treated as empty, so that the density decays linearly to zero within half
+ * a bin width of the outermost bin centre.
+ */
+std::vector<real>
+PooledDensityAccumulator::interpolateBins(
+        const std::vector<real> &evalPoints,
+        real norm) const
+{
+    std::vector<real> density;
+    density.reserve(evalPoints.size());
+
+    // handle case of empty accumulator:
+    if( bins_.empty() || binWidth_ <= 0.0 )
+    {
+        density.assign(evalPoints.size(), 0.0);
+        return density;
+    }
+
+    // number of bins as signed integer for index comparison:
+    long int numBins = static_cast<long int>(bins_.size());
+
+    // loop over evaluation points:
+    for(auto eval : evalPoints)
+    {
+        // position relative to centre of first bin in units of bin width:
+        real u = eval/binWidth_ - 0.5 - idxOffset_;
+        long int i = static_cast<long int>(std::floor(u));
+        real t = u - i;
+
+        // values in neighbouring bins (zero outside range):
+        real lo = (i >= 0 && i < numBins) ? bins_[i] : 0.0;
+        real hi = (i + 1 >= 0 && i + 1 < numBins) ? bins_[i + 1] : 0.0;
+
+        // linear interpolation:
+        density.push_back(norm*((1.0 - t)*lo + t*hi));
+    }
+
+    return density;
+}
+
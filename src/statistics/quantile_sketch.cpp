@@ -0,0 +1,326 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "statistics/quantile_sketch.hpp"
+
+
+/*!
+ * Constructor creates an empty sketch with the given compression parameter. 
+ * Larger values of the compression parameter yield more accurate quantile 
+ * estimates at the expense of more memory. The number of retained centroids
+ * is approximately proportional to the compression parameter.
+ */
+QuantileSketch::QuantileSketch(
+        real compression)
+    : compression_(compression)
+    , bufferSize_(0)
+    , min_(std::numeric_limits<real>::max())
+    , max_(-std::numeric_limits<real>::max())
+    , num_(0)
+{
+    // sanity check:
+    if( compression <= 0.0 )
+    {
+        throw std::logic_error("Compression parameter of quantile sketch "
+                               "must be positive!");
+    }
+
+    // size of buffer for unmerged values:
+    bufferSize_ = static_cast<size_t>(std::ceil(5.0*compression_));
+}
+
+
+/*!
+ * Returns an estimate of the q-th quantile, where q must lie in the unit 
+ * interval. The estimate is obtained by linear interpolation between centroid
+ * means, where each centroid is assumed to be centred at the middle of its
+ * weight. Between the first (last) centroid and the minimum (maximum) value, 
+ * the estimate is interpolated linearly as well. If no values have been added
+ * to the sketch, zero is returned for compatibility with JSON.
+ */
+real
+QuantileSketch::quantile(
+        real q) const
+{
+    // sanity check:
+    if( q < 0.0 || q > 1.0 )
+    {
+        throw std::logic_error("Quantile must be in the unit interval!");
+    }
+
+    // handle case of no data:
+    if( num_ == 0 )
+    {
+        return 0.0;
+    }
+
+    // merge buffer into centroids on a copy of this sketch:
+    if( !buffer_.empty() )
+    {
+        QuantileSketch sketch(*this);
+        sketch.compress();
+        return sketch.quantile(q);
+    }
+
+    // handle trivial cases (extremes first, as a single centroid may hold 
+    // several values):
+    if( q == 0.0 )
+    {
+        return min_;
+    }
+    if( q == 1.0 )
+    {
+        return max_;
+    }
+    if( centroids_.size() == 1 )
+    {
+        return centroids_.front().first;
+    }
+
+    // target rank:
+    real rank = q*num_;
+
+    // rank is below centre of first centroid:
+    real firstCentre = 0.5*centroids_.front().second;
+    if( rank < firstCentre )
+    {
+        real t = rank/firstCentre;
+        return min_ + t*(centroids_.front().first - min_);
+    }
+
+    // search for pair of centroids enclosing rank:
+    real cumWeight = 0.0;
+    for(size_t i = 0; i < centroids_.size() - 1; i++)
+    {
+        real centreLo = cumWeight + 0.5*centroids_[i].second;
+        real centreHi = cumWeight + centroids_[i].second 
+                      + 0.5*centroids_[i + 1].second;
+        if( rank < centreHi )
+        {
+            real t = (rank - centreLo)/(centreHi - centreLo);
+            return centroids_[i].first 
+                 + t*(centroids_[i + 1].first - centroids_[i].first);
+        }
+        cumWeight += centroids_[i].second;
+    }
+
+    // rank is above centre of last centroid:
+    real lastCentre = num_ - 0.5*centroids_.back().second;
+    real t = (rank - lastCentre)/(num_ - lastCentre);
+    return centroids_.back().first + t*(max_ - centroids_.back().first);
+}
+
+
+/*!
+ * Getter method for the number of values added to the sketch.
+ */
+int
+QuantileSketch::num() const
+{
+    return num_;
+}
+
+
+/*!
+ * Adds a new value to the sketch. The value is stored in a buffer, which is
+ * merged into the centroids once it is full. Infinite values and NaN are 
+ * skipped.
+ */
+void
+QuantileSketch::update(
+        const real newValue)
+{
+    // handle infinities and NaN:
+    if( !std::isfinite(newValue) )
+    {
+        return;
+    }
+
+    // update range and counter:
+    min_ = std::min(min_, newValue);
+    max_ = std::max(max_, newValue);
+    num_++;
+
+    // add to buffer and merge if necessary:
+    buffer_.push_back(std::pair<real, real>(newValue, 1.0));
+    if( buffer_.size() >= bufferSize_ )
+    {
+        compress();
+    }
+}
+
+
+/*!
+ * Convenience function to update a vector of QuantileSketch objects with a 
+ * vector of new values.
+ */
+void
+QuantileSketch::updateMultiple(
+        std::vector<QuantileSketch> &sketch,
+        const std::vector<real> &newValues)
+{
+    // sanity check:
+    if( sketch.size() != newValues.size() )
+    {
+        throw std::logic_error("Can not update quantile sketch vector with "
+                               "data vector of different size.");
+    }
+
+    // update each value individually:
+    for(size_t i = 0; i < sketch.size(); i++)
+    {
+        sketch[i].update(newValues[i]);
+    }
+}
+
+
+/*!
+ * Merges another sketch into this one. The centroids of the other sketch are
+ * treated in the same way as buffered values, so that the result is again
+ * bounded in size by the compression parameter of this sketch.
+ */
+void
+QuantileSketch::merge(
+        const QuantileSketch &other)
+{
+    // nothing to do if other sketch is empty:
+    if( other.num_ == 0 )
+    {
+        return;
+    }
+
+    // combine range and counter:
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    num_ += other.num_;
+
+    // add centroids and buffered values of other sketch to buffer:
+    buffer_.insert(
+            buffer_.end(), 
+            other.centroids_.begin(), 
+            other.centroids_.end());
+    buffer_.insert(
+            buffer_.end(), 
+            other.buffer_.begin(), 
+            other.buffer_.end());
+    compress();
+}
+
+
+/*!
+ * Shifts all values in the sketch by the given amount, so that all quantiles
+ * are shifted accordingly. This is useful if the sketch is used as a data 
+ * container (see SummaryStatistics::shift()).
+ */
+void
+QuantileSketch::shift(
+        const real shift)
+{
+    for(auto &c : centroids_)
+    {
+        c.first += shift;
+    }
+    for(auto &b : buffer_)
+    {
+        b.first += shift;
+    }
+    min_ += shift;
+    max_ += shift;
+}
+
+
+/*!
+ * Merges the buffered values into the centroids. All centroids and buffered
+ * values are sorted by their mean and neighbouring centroids are combined as
+ * long as the combined centroid spans no more than one unit of the scale 
+ * function.
+ */
+void
+QuantileSketch::compress()
+{
+    // nothing to do if buffer is empty:
+    if( buffer_.empty() )
+    {
+        return;
+    }
+
+    // sort all centroids by mean:
+    buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+    std::sort(buffer_.begin(), buffer_.end());
+
+    // total weight:
+    real total = 0.0;
+    for(auto &b : buffer_)
+    {
+        total += b.second;
+    }
+
+    // merge neighbouring centroids:
+    centroids_.clear();
+    std::pair<real, real> current = buffer_.front();
+    real weightSoFar = 0.0;
+    real kLo = scaleFunction(0.0);
+    for(size_t i = 1; i < buffer_.size(); i++)
+    {
+        real qHi = (weightSoFar + current.second + buffer_[i].second)/total;
+        qHi = std::min(qHi, static_cast<real>(1.0));
+        if( scaleFunction(qHi) - kLo <= 1.0 )
+        {
+            // add to current centroid:
+            real weight = current.second + buffer_[i].second;
+            current.first += (buffer_[i].first - current.first)
+                           * buffer_[i].second/weight;
+            current.second = weight;
+        }
+        else
+        {
+            // start new centroid:
+            weightSoFar += current.second;
+            kLo = scaleFunction(weightSoFar/total);
+            centroids_.push_back(current);
+            current = buffer_[i];
+        }
+    }
+    centroids_.push_back(current);
+
+    // clear buffer:
+    buffer_.clear();
+}
+
+
+/*!
+ * Scale function limiting the size of centroids. This is the arcsine scale 
+ * function which leads to small centroids near the tails of the distribution.
+ */
+inline real
+QuantileSketch::scaleFunction(real q) const
+{
+    return compression_/(2.0*M_PI)*std::asin(2.0*q - 1.0);
+}
+
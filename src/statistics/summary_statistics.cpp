@@ -22,6 +22,7 @@
 // THE SOFTWARE.
 
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
@@ -46,6 +47,27 @@ SummaryStatistics::SummaryStatistics()
 }
 
 
+/*!
+ * Private constructor which initialises all internal variables directly. This
+ * is used by SummaryStatisticsVector to create the summary statistics of an 
+ * individual vector element.
+ */
+SummaryStatistics::SummaryStatistics(
+        real min,
+        real max,
+        real mean,
+        real sumSquaredMeanDiff,
+        int num)
+    : min_(min)
+    , max_(max)
+    , mean_(mean)
+    , sumSquaredMeanDiff_(sumSquaredMeanDiff)
+    , num_(num)
+{
+
+}
+
+
 /*!
  * This method will update all summary statistics with the given new value and
  * also increment the sample counter.
@@ -105,6 +127,54 @@ SummaryStatistics::updateMultiple(
 }
 
 
+/*!
+ * Merges the summary statistics of another dataset into this object, so that
+ * afterwards this object holds the summary statistics of the union of both
+ * datasets. Mean and sum of squared differences from the mean are combined
+ * using the pairwise algorithm of Chan et al. (1979):
+ *
+ * \f[
+ *      \bar{x} = \bar{x}_A + \delta \frac{n_B}{n_A + n_B}, \quad
+ *      M_2 = M_{2,A} + M_{2,B} + \delta^2 \frac{n_A n_B}{n_A + n_B}
+ * \f]
+ *
+ * where \f$ \delta = \bar{x}_B - \bar{x}_A \f$. The result is the same as 
+ * (up to rounding) if all values had been passed to update() on a single 
+ * object.
+ */
+void
+SummaryStatistics::merge(
+        const SummaryStatistics &other)
+{
+    // nothing to do if other dataset is empty:
+    if( other.num_ == 0 )
+    {
+        return;
+    }
+
+    // simply copy other dataset if this one is empty:
+    if( num_ == 0 )
+    {
+        *this = other;
+        return;
+    }
+
+    // minimum and maximum are trivial:
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+
+    // combine mean and squared differences from mean:
+    real num = num_ + other.num_;
+    real delta = other.mean_ - mean_;
+    mean_ += delta*other.num_/num;
+    sumSquaredMeanDiff_ += other.sumSquaredMeanDiff_ 
+                         + delta*delta*num_*other.num_/num;
+
+    // update number of samples:
+    num_ += other.num_;
+}
+
+
 /*!
  * Shifts the value of minimum, maximum, and mean by the given amount. Standard
  * deviation, variance, and number of samples are unaffected. This is useful if
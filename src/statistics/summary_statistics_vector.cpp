@@ -0,0 +1,236 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "statistics/summary_statistics_vector.hpp"
+
+
+/*!
+ * Creates summary statistics for a vector of the given size. All elements are
+ * initialised in the same way as a default constructed SummaryStatistics 
+ * object.
+ */
+SummaryStatisticsVector::SummaryStatisticsVector(
+        size_t size)
+    : min_(size, std::numeric_limits<real>::max())
+    , max_(size, -std::numeric_limits<real>::max())
+    , mean_(size, 0.0)
+    , sumSquaredMeanDiff_(size, 0.0)
+    , num_(size, 0)
+{
+
+}
+
+
+/*!
+ * Returns the number of elements in the vector.
+ */
+size_t
+SummaryStatisticsVector::size() const
+{
+    return mean_.size();
+}
+
+
+/*!
+ * Returns the summary statistics of the i-th element. Throws an exception if
+ * the index is out of range.
+ */
+SummaryStatistics
+SummaryStatisticsVector::at(
+        size_t i) const
+{
+    // sanity check:
+    if( i >= size() )
+    {
+        throw std::out_of_range("Index out of range in summary statistics "
+                                "vector.");
+    }
+
+    return SummaryStatistics(
+            min_[i], 
+            max_[i], 
+            mean_[i], 
+            sumSquaredMeanDiff_[i], 
+            num_[i]);
+}
+
+
+/*!
+ * Returns the summary statistics of all elements as a vector of 
+ * SummaryStatistics objects.
+ */
+std::vector<SummaryStatistics>
+SummaryStatisticsVector::summaries() const
+{
+    std::vector<SummaryStatistics> sumStats;
+    sumStats.reserve(size());
+    for(size_t i = 0; i < size(); i++)
+    {
+        sumStats.push_back(at(i));
+    }
+
+    return sumStats;
+}
+
+
+/*!
+ * Returns the mean of all elements, where infinities are capped as in 
+ * SummaryStatistics::mean().
+ */
+std::vector<real>
+SummaryStatisticsVector::mean() const
+{
+    std::vector<real> mean;
+    mean.reserve(size());
+    for(size_t i = 0; i < size(); i++)
+    {
+        mean.push_back(at(i).mean());
+    }
+
+    return mean;
+}
+
+
+/*!
+ * Returns the standard deviation of all elements, see SummaryStatistics::sd().
+ */
+std::vector<real>
+SummaryStatisticsVector::sd() const
+{
+    std::vector<real> sd;
+    sd.reserve(size());
+    for(size_t i = 0; i < size(); i++)
+    {
+        sd.push_back(at(i).sd());
+    }
+
+    return sd;
+}
+
+
+/*!
+ * Updates the summary statistics of each element with the corresponding new
+ * value. This is equivalent to calling SummaryStatistics::update() on each 
+ * element, but infinite values are masked out arithmetically rather than by
+ * branching so that the loop can be vectorised.
+ */
+void
+SummaryStatisticsVector::update(
+        const std::vector<real> &newValues)
+{
+    // sanity check:
+    if( newValues.size() != size() )
+    {
+        throw std::logic_error("Can not update summary statistics vector with "
+                               "data vector of different size.");
+    }
+
+    // raw pointers to contiguous arrays:
+    const real *val = newValues.data();
+    real *min = min_.data();
+    real *max = max_.data();
+    real *mean = mean_.data();
+    real *ssmd = sumSquaredMeanDiff_.data();
+    int *num = num_.data();
+    const real inf = std::numeric_limits<real>::infinity();
+
+    // update each element:
+    const size_t n = size();
+    for(size_t i = 0; i < n; i++)
+    {
+        // mask for finite values (NaN is not masked, as in update()):
+        const real x = val[i];
+        const bool isFinite = std::fabs(x) != inf;
+
+        // increment number of samples:
+        const int newNum = num[i] + isFinite;
+
+        // updated min and max:
+        const real newMin = x < min[i] ? x : min[i];
+        const real newMax = x > max[i] ? x : max[i];
+
+        // update mean and squared difference from mean:
+        const real delta = x - mean[i];
+        const real newMean = mean[i] + delta/(newNum > 0 ? newNum : 1);
+        const real newSsmd = ssmd[i] + delta*(x - newMean);
+
+        // only apply update for finite values:
+        num[i] = newNum;
+        min[i] = isFinite ? newMin : min[i];
+        max[i] = isFinite ? newMax : max[i];
+        mean[i] = isFinite ? newMean : mean[i];
+        ssmd[i] = isFinite ? newSsmd : ssmd[i];
+    }
+}
+
+
+/*!
+ * Merges the summary statistics of another vector of equal size into this one
+ * by calling SummaryStatistics::merge() on each element.
+ */
+void
+SummaryStatisticsVector::merge(
+        const SummaryStatisticsVector &other)
+{
+    // sanity check:
+    if( other.size() != size() )
+    {
+        throw std::logic_error("Can not merge summary statistics vectors of "
+                               "different size.");
+    }
+
+    // merge each element:
+    for(size_t i = 0; i < size(); i++)
+    {
+        SummaryStatistics stat = at(i);
+        stat.merge(other.at(i));
+        min_[i] = stat.min_;
+        max_[i] = stat.max_;
+        mean_[i] = stat.mean_;
+        sumSquaredMeanDiff_[i] = stat.sumSquaredMeanDiff_;
+        num_[i] = stat.num_;
+    }
+}
+
+
+/*!
+ * Shifts minimum, maximum, and mean of each element by the given amount. See
+ * SummaryStatistics::shift() for details.
+ */
+void
+SummaryStatisticsVector::shift(
+        const real shift)
+{
+    for(size_t i = 0; i < size(); i++)
+    {
+        min_[i] += shift;
+        max_[i] += shift;
+        mean_[i] += shift;
+    }
+}
+
@@ -23,6 +23,8 @@
 
 
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <string>
 
 #include <gromacs/random/threefry.h>
@@ -44,17 +46,24 @@
 #include "geometry/spline_curve_3D.hpp"
 
 #include "io/analysis_data_json_frame_exporter.hpp"
+#include "io/compressed_file_read_stream.hpp"
+#include "io/json_column_codec.hpp"
 #include "io/json_doc_importer.hpp"
 #include "io/molecular_path_obj_exporter.hpp"
 #include "io/results_json_exporter.hpp"
+#include "io/results_npz_exporter.hpp"
+#include "io/surface_mesh_sequence_exporter.hpp"
 #include "io/spline_curve_1D_json_converter.hpp"
 #include "io/summary_statistics_json_converter.hpp"
 #include "io/summary_statistics_vector_json_converter.hpp"
 
 #include "statistics/amise_optimal_bandwidth_estimator.hpp"
+#include "statistics/block_average.hpp"
 #include "statistics/histogram_density_estimator.hpp"
 #include "statistics/kernel_density_estimator.hpp"
+#include "statistics/quantile_sketch.hpp"
 #include "statistics/summary_statistics.hpp"
+#include "statistics/summary_statistics_vector.hpp"
 #include "statistics/weighted_kernel_density_estimator.hpp"
 
 #include "path-finding/inplane_optimised_probe_path_finder.hpp"
@@ -194,6 +203,77 @@ ChapTrajectoryAnalysis::initOptions(
                                       "probe positions and spline parameters. "
                                       "This is mostly useful for debugging."));
 
+    options -> addOption(RealOption("out-detailed-precision")
+                         .store(&outputDetailedPrecision_)
+                         .defaultValue(0.0)
+                         .description("If positive, residue and solvent "
+                                      "positions in the per-frame data file "
+                                      "are written in a compact encoding, "
+                                      "where coordinates are rounded to this "
+                                      "precision (in nm and rad), flags are "
+                                      "bit-packed and residue IDs are delta-"
+                                      "encoded. A value of zero writes full "
+                                      "precision."));
+
+    const char * const allowedOutputFormat[] = {"json",
+                                                "npz",
+                                                "all"};
+    outputFormat_ = eOutputFormatJson;
+    options -> addOption(EnumOption<eOutputFormat>("out-format")
+                         .enumValue(allowedOutputFormat)
+                         .store(&outputFormat_)
+                         .description("Format of the results file. In "
+                                      "addition to JSON, results can be "
+                                      "written as columnar binary file in "
+                                      "NumPy's NPZ format, which allows "
+                                      "quick loading of time series."));
+
+    options -> addOption(BooleanOption("out-compress")
+                         .store(&outputCompress_)
+                         .defaultValue(false)
+                         .description("If true, JSON output files (including "
+                                      "the per-frame data file) are gzip "
+                                      "compressed and '.gz' is appended to "
+                                      "their file names."));
+
+    options -> addOption(IntegerOption("out-flush-interval")
+                         .store(&outputFlushInterval_)
+                         .defaultValue(100)
+                         .description("Number of frames after which buffered "
+                                      "per-frame data is flushed to disk. A "
+                                      "value of zero means that data is only "
+                                      "written when the buffer is full."));
+
+    options -> addOption(IntegerOption("out-mesh-stride")
+                         .store(&outputMeshStride_)
+                         .defaultValue(0)
+                         .description("If positive, the pathway surface of "
+                                      "every n-th frame is written to a "
+                                      "binary mesh sequence file with shared "
+                                      "triangulation, e.g. for making movies "
+                                      "of the pore surface. A value of zero "
+                                      "disables this output."));
+
+    options -> addOption(IntegerOption("out-pdb-stride")
+                         .store(&outputPdbStride_)
+                         .defaultValue(0)
+                         .description("If positive, the structure of every "
+                                      "n-th frame is written to a multi-model "
+                                      "PDB file, in which the occupancy and "
+                                      "B-factor fields hold the instantaneous "
+                                      "pore-lining and pore-facing flags of "
+                                      "each residue. A value of zero disables "
+                                      "this output."));
+
+    options -> addOption(BooleanOption("out-ply")
+                         .store(&outputPly_)
+                         .defaultValue(false)
+                         .description("If true, the time-averaged pathway "
+                                      "surface is in addition written to a "
+                                      "binary PLY file, in which all scalar "
+                                      "properties are attached to a single "
+                                      "set of vertices."));
+
 
     // PATH FINDING PARAMETERS
     //-------------------------------------------------------------------------
@@ -604,10 +684,45 @@ ChapTrajectoryAnalysis::initAnalysis(
     AnalysisDataJsonFrameExporterPointer jsonFrameExporter(new AnalysisDataJsonFrameExporter);
     jsonFrameExporter -> setDataSetNames(frameStreamDataSetNames);
     jsonFrameExporter -> setColumnNames(frameStreamColumnNames);
+    if( outputDetailedPrecision_ > 0.0 )
+    {
+        // compact encoding of residue and solvent positions (data sets 4 and
+        // 5), all other data sets remain plain:
+        JsonColumnCodec id(eColumnEncodingDelta);
+        JsonColumnCodec pos(eColumnEncodingQuantised, outputDetailedPrecision_);
+        JsonColumnCodec flag(eColumnEncodingBitPacked);
+        JsonColumnCodec plain;
+        std::vector<std::vector<JsonColumnCodec>> frameStreamColumnCodecs(4);
+        frameStreamColumnCodecs.push_back(
+                {id, pos, pos, pos, flag, flag, plain, plain, pos, pos, pos});
+        frameStreamColumnCodecs.push_back(
+                {id, pos, pos, pos, flag, flag, pos, pos, pos});
+        jsonFrameExporter -> setColumnCodecs(frameStreamColumnCodecs);
+    }
     std::string frameStreamFileName = std::string("stream_") + outputJsonFileName_;
     jsonFrameExporter -> setFileName(frameStreamFileName);
+    jsonFrameExporter -> setFlushInterval(outputFlushInterval_);
     frameStreamData_.addModule(jsonFrameExporter);
 
+    // prepare per-frame surface mesh output:
+    if( outputMeshStride_ > 0 )
+    {
+        std::pair<size_t, size_t> meshResolution = 
+                MolecularPathObjExporter().resolution();
+        outputMeshSequence_.reset(new SurfaceMeshSequenceExporter(
+                outputMeshFileName_,
+                meshResolution.first,
+                meshResolution.second));
+    }
+
+    // prepare per-frame PDB output:
+    if( outputPdbStride_ > 0 )
+    {
+        outputPdbTrajectory_.reset(new PdbTrajectoryWriter(
+                outputPdbTrajectoryFileName_,
+                outputStructure_));
+    }
+
 
     // PREPARE SELECTIONS FOR PORE PARTICLE MAPPING
     //-------------------------------------------------------------------------
@@ -744,11 +859,11 @@ ChapTrajectoryAnalysis::initAnalysis(
 
     // import vdW radii JSON: 
     JsonDocImporter jdi;
-    rapidjson::Document radiiDoc = jdi(pfVdwRadiusJson_.c_str());
+    ImportedJsonDoc radiiDoc = jdi(pfVdwRadiusJson_.c_str());
    
     // create radius provider and build lookup table:
     VdwRadiusProvider vrp;
-    vrp.lookupTableFromJson(radiiDoc);
+    vrp.lookupTableFromJson(radiiDoc.doc_);
 
     // set user-defined default radius?
     if( pfDefaultVdwRadiusIsSet_ )
@@ -822,10 +937,10 @@ ChapTrajectoryAnalysis::initAnalysis(
     }
 
     // import hydrophbicity JSON:
-    rapidjson::Document hydrophobicityDoc = jdi(hydrophobicityJson_.c_str());
+    ImportedJsonDoc hydrophobicityDoc = jdi(hydrophobicityJson_.c_str());
    
     // generate hydrophobicity lookup table:
-    resInfo_.hydrophobicityFromJson(hydrophobicityDoc);
+    resInfo_.hydrophobicityFromJson(hydrophobicityDoc.doc_);
 
     // set fallback hydrophobicity:
     if( hydrophobicityDefaultIsSet_ )
@@ -1006,6 +1121,18 @@ ChapTrajectoryAnalysis::analyzeFrame(
         molPath.shift(mappedIpp.front());
     }
 
+    // export pathway surface of this frame:
+    if( outputMeshSequence_ && frnr % outputMeshStride_ == 0 )
+    {
+        MolecularPathObjExporter mpexp;
+        mpexp.setExtrapDist(outputExtrapDist_);
+        mpexp.setGridSampleDist(outputGridSampleDist_);
+        mpexp.setCorrectionThreshold(outputCorrectionThreshold_);
+        outputMeshSequence_ -> addFrame(
+                fr.time,
+                mpexp.surfaceVertices(molPath));
+    }
+
     // get original path points and radii:
     std::vector<gmx::RVec> pathPoints = molPath.pathPoints();
     std::vector<real> pathRadii = molPath.pathRadii();
@@ -1023,8 +1150,8 @@ ChapTrajectoryAnalysis::analyzeFrame(
 
     // add radius spline knots and control points to frame stream dataset:
     dhFrameStream.selectDataSet(2);
-    std::vector<real> radiusKnots = molPath.poreRadiusUniqueKnots();    
-    std::vector<real> radiusCtrlPoints = molPath.poreRadiusCtrlPoints();
+    ArrayView<real> radiusKnots = molPath.poreRadiusUniqueKnots();    
+    const std::vector<real> &radiusCtrlPoints = molPath.poreRadiusCtrlPoints();
     for(size_t i = 0; i < radiusKnots.size(); i++)
     {
         dhFrameStream.setPoint(0, radiusKnots.at(i));
@@ -1034,8 +1161,9 @@ ChapTrajectoryAnalysis::analyzeFrame(
     
     // add centre line spline knots and control points to frame stream dataset:
     dhFrameStream.selectDataSet(3);
-    std::vector<real> centreLineKnots = molPath.centreLineUniqueKnots();    
-    std::vector<gmx::RVec> centreLineCtrlPoints = molPath.centreLineCtrlPoints();
+    ArrayView<real> centreLineKnots = molPath.centreLineUniqueKnots();    
+    const std::vector<gmx::RVec> &centreLineCtrlPoints = 
+            molPath.centreLineCtrlPoints();
     for(size_t i = 0; i < centreLineKnots.size(); i++)
     {
         dhFrameStream.setPoint(0, centreLineKnots.at(i));
@@ -1106,6 +1234,27 @@ ChapTrajectoryAnalysis::analyzeFrame(
         }
     }
     tResPoreFacing = (std::clock() - tResPoreFacing)/CLOCKS_PER_SEC;
+
+    // write structure with instantaneous pore-lining/facing flags:
+    if( outputPdbTrajectory_ && frnr % outputPdbStride_ == 0 )
+    {
+        std::vector<real> framePoreLining(poreMappingSelCog.posCount(), 0.0);
+        std::vector<real> framePoreFacing(poreMappingSelCog.posCount(), 0.0);
+        for(auto res : poreLining)
+        {
+            framePoreLining.at(res.first) = res.second;
+        }
+        for(auto res : poreFacing)
+        {
+            framePoreFacing.at(res.first) = res.second;
+        }
+        outputPdbTrajectory_ -> writeModel(
+                fr.x,
+                fr.natoms,
+                fr.box,
+                framePoreLining,
+                framePoreFacing);
+    }
     
 
     // ESTIMATE HYDROPHOBICITY PROFILE
@@ -1166,14 +1315,13 @@ ChapTrajectoryAnalysis::analyzeFrame(
 
     // add spline curve parameters to data handle:   
     dhFrameStream.selectDataSet(7);
-    for(size_t i = 0; i < plHydrophobicity.ctrlPoints().size(); i++)
-    {
-        dhFrameStream.setPoint(
-                0, 
-                plHydrophobicity.uniqueKnots().at(i));
-        dhFrameStream.setPoint(
-                1, 
-                plHydrophobicity.ctrlPoints().at(i));
+    ArrayView<real> plHydrophobicityKnots = plHydrophobicity.uniqueKnots();
+    const std::vector<real> &plHydrophobicityCtrlPoints = 
+            plHydrophobicity.ctrlPoints();
+    for(size_t i = 0; i < plHydrophobicityCtrlPoints.size(); i++)
+    {
+        dhFrameStream.setPoint(0, plHydrophobicityKnots.at(i));
+        dhFrameStream.setPoint(1, plHydrophobicityCtrlPoints[i]);
         dhFrameStream.finishPointSet();
     }
 
@@ -1184,14 +1332,13 @@ ChapTrajectoryAnalysis::analyzeFrame(
 
     // add spline curve parameters to data handle:   
     dhFrameStream.selectDataSet(8);
-    for(size_t i = 0; i < pfHydrophobicity.ctrlPoints().size(); i++)
-    {
-        dhFrameStream.setPoint(
-                0, 
-                pfHydrophobicity.uniqueKnots().at(i));
-        dhFrameStream.setPoint(
-                1, 
-                pfHydrophobicity.ctrlPoints().at(i));
+    ArrayView<real> pfHydrophobicityKnots = pfHydrophobicity.uniqueKnots();
+    const std::vector<real> &pfHydrophobicityCtrlPoints = 
+            pfHydrophobicity.ctrlPoints();
+    for(size_t i = 0; i < pfHydrophobicityCtrlPoints.size(); i++)
+    {
+        dhFrameStream.setPoint(0, pfHydrophobicityKnots.at(i));
+        dhFrameStream.setPoint(1, pfHydrophobicityCtrlPoints[i]);
         dhFrameStream.finishPointSet();
     }
 
@@ -1265,7 +1412,7 @@ ChapTrajectoryAnalysis::analyzeFrame(
              dhFrameStream.setPoint(0, solvMapSel.position(it -> first).mappedId()); // res.id
              dhFrameStream.setPoint(1, it -> second[0]);     // s
              dhFrameStream.setPoint(2, it -> second[1]);     // rho
-             dhFrameStream.setPoint(3, 0.0);                 // phi 
+             dhFrameStream.setPoint(3, it -> second[PP]);    // phi
              dhFrameStream.setPoint(4, solvInsidePore[it -> first]);        // inside pore
              dhFrameStream.setPoint(5, solvInsideSample[it -> first]);      // inside sample
              dhFrameStream.setPoint(6, solvMapSel.position(it -> first).x()[XX]);  // x
@@ -1307,11 +1454,45 @@ ChapTrajectoryAnalysis::analyzeFrame(
         }
     }
 
+    // pool samples over frames, weighted by inverse cross-sectional area:
+    std::vector<real> solventSampleWeights;
+    solventSampleWeights.reserve(solventSampleCoordS.size());
+    std::vector<real> solventPooledCoordS;
+    solventPooledCoordS.reserve(solventSampleCoordS.size());
+    for(auto s : solventSampleCoordS)
+    {
+        // skip samples where extrapolated radius degenerates:
+        real rad = molPath.radius(s);
+        if( !(rad > 0.0) )
+        {
+            continue;
+        }
+        solventPooledCoordS.push_back(s);
+        solventSampleWeights.push_back(1.0/(M_PI*rad*rad));
+    }
+    solventDensityPool_.addFrame(solventPooledCoordS, solventSampleWeights);
+
     // create density estimator:
     std::unique_ptr<AbstractDensityEstimator> densityEstimator;
     if( deMethod_ == eDensityEstimatorHistogram )
     {
-        densityEstimator.reset(new HistogramDensityEstimator());
+        // fixed histogram range covers pathway and all samples, which allows
+        // binning without sorting the sample:
+        real histRangeLo = molPath.sLo() - outputExtrapDist_;
+        real histRangeHi = molPath.sHi() + outputExtrapDist_;
+        if( !solventSampleCoordS.empty() )
+        {
+            auto sampleRange = std::minmax_element(
+                    solventSampleCoordS.begin(),
+                    solventSampleCoordS.end());
+            histRangeLo = std::min(histRangeLo, *sampleRange.first);
+            histRangeHi = std::max(histRangeHi, *sampleRange.second);
+        }
+
+        std::unique_ptr<HistogramDensityEstimator> histEstimator(
+                new HistogramDensityEstimator());
+        histEstimator -> setRange(histRangeLo, histRangeHi);
+        densityEstimator = std::move(histEstimator);
     }
     else if( deMethod_ == eDensityEstimatorKernel )
     {
@@ -1333,20 +1514,19 @@ ChapTrajectoryAnalysis::analyzeFrame(
 
     // add spline curve parameters to data handle:   
     dhFrameStream.selectDataSet(6);
-    for(size_t i = 0; i < solventDensityCoordS.ctrlPoints().size(); i++)
-    {
-        dhFrameStream.setPoint(
-                0, 
-                solventDensityCoordS.uniqueKnots().at(i));
-        dhFrameStream.setPoint(
-                1, 
-                solventDensityCoordS.ctrlPoints().at(i));
+    ArrayView<real> solventDensityKnots = solventDensityCoordS.uniqueKnots();
+    const std::vector<real> &solventDensityCtrlPoints = 
+            solventDensityCoordS.ctrlPoints();
+    for(size_t i = 0; i < solventDensityCtrlPoints.size(); i++)
+    {
+        dhFrameStream.setPoint(0, solventDensityKnots.at(i));
+        dhFrameStream.setPoint(1, solventDensityCtrlPoints[i]);
         dhFrameStream.finishPointSet();
     }
 
     // track range covered by solvent:
-    real solventRangeLo = solventDensityCoordS.uniqueKnots().front();
-    real solventRangeHi = solventDensityCoordS.uniqueKnots().back();
+    real solventRangeLo = solventDensityKnots.front();
+    real solventRangeHi = solventDensityKnots.back();
 
     // obtain physical number density:
     SplineCurve1D pathRadius = molPath.pathRadius();
@@ -1368,9 +1548,10 @@ ChapTrajectoryAnalysis::analyzeFrame(
     dhFrameStream.selectDataSet(0);
 
     // only one point per frame:
+    std::pair<real, real> minRadius = molPath.minRadius();
     dhFrameStream.setPoint(0, fr.time);
-    dhFrameStream.setPoint(1, molPath.minRadius().first);
-    dhFrameStream.setPoint(2, molPath.minRadius().second);
+    dhFrameStream.setPoint(1, minRadius.first);
+    dhFrameStream.setPoint(2, minRadius.second);
     dhFrameStream.setPoint(3, molPath.length());
     dhFrameStream.setPoint(4, molPath.volume());
     dhFrameStream.setPoint(5, numSolvInsidePore); 
@@ -1439,17 +1620,37 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     // free line for neater output:
     std::cout<<std::endl;
 
+    // complete per-frame surface mesh output:
+    if( outputMeshSequence_ )
+    {
+        outputMeshSequence_ -> close();
+        std::cout<<"Wrote pathway surface of "
+                 <<outputMeshSequence_ -> numFrames()
+                 <<" frames to "<<outputMeshFileName_<<"."<<std::endl;
+        outputMeshSequence_.reset();
+    }
+
+    // complete per-frame PDB output:
+    if( outputPdbTrajectory_ )
+    {
+        outputPdbTrajectory_ -> close();
+        std::cout<<"Wrote structure of "
+                 <<outputPdbTrajectory_ -> numModels()
+                 <<" frames to "<<outputPdbTrajectoryFileName_<<"."
+                 <<std::endl;
+        outputPdbTrajectory_.reset();
+    }
+
     // transfer file names from user input:
     std::string inFileName = std::string("stream_") + outputJsonFileName_;
     std::string outFileName = outputJsonFileName_;
-    std::fstream inFile;
-    std::fstream outFile;
+    std::unique_ptr<CompressedFileReadStream> inFile;
 
     // READ PER-FRAME DATA AND AGGREGATE ALL NON-PROFILE DATA
     // ------------------------------------------------------------------------
 
-    // openen per-frame data set for reading:
-    inFile.open(inFileName, std::fstream::in);
+    // openen per-frame data set for reading (may be gzip compressed):
+    inFile.reset(new CompressedFileReadStream(inFileName));
 
     // prepare summary statistics for aggregate properties:
     SummaryStatistics argMinRadiusSummary;
@@ -1466,7 +1667,32 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     SummaryStatistics arcLengthHiSummary;
     SummaryStatistics bandWidthSummary;
 
-    // containers for scalar time series:
+    // prepare quantile sketches for aggregate properties:
+    QuantileSketch argMinRadiusQuantiles;
+    QuantileSketch minRadiusQuantiles;
+    QuantileSketch lengthQuantiles;
+    QuantileSketch volumeQuantiles;
+    QuantileSketch numPathQuantiles;
+    QuantileSketch numSampleQuantiles;
+    QuantileSketch argMinSolventDensityQuantiles;
+    QuantileSketch minSolventDensityQuantiles;
+    QuantileSketch bandWidthQuantiles;
+
+    // prepare block averages for standard errors of aggregate properties:
+    BlockAverage argMinRadiusBlockAvg;
+    BlockAverage minRadiusBlockAvg;
+    BlockAverage lengthBlockAvg;
+    BlockAverage volumeBlockAvg;
+    BlockAverage numPathBlockAvg;
+    BlockAverage numSampleBlockAvg;
+    BlockAverage argMinSolventDensityBlockAvg;
+    BlockAverage minSolventDensityBlockAvg;
+    BlockAverage bandWidthBlockAvg;
+
+    // containers for scalar time series (unlike all other quantities, time 
+    // series are held in memory until output, as the JSON results file lists
+    // them after the summaries and the NPZ file needs complete arrays; the
+    // number of frames is known, so that no capacity is wasted):
     std::vector<real> argMinRadiusTimeSeries;
     std::vector<real> minRadiusTimeSeries;
     std::vector<real> lengthTimeSeries;
@@ -1476,6 +1702,18 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     std::vector<real> argMinSolventDensityTimeSeries;
     std::vector<real> minSolventDensityTimeSeries;
     std::vector<real> bandWidthTimeSeries;
+    for(auto timeSeries : {&argMinRadiusTimeSeries, 
+                           &minRadiusTimeSeries, 
+                           &lengthTimeSeries,
+                           &volumeTimeSeries,
+                           &numPathwayTimeSeries,
+                           &numSampleTimeSeries,
+                           &argMinSolventDensityTimeSeries,
+                           &minSolventDensityTimeSeries,
+                           &bandWidthTimeSeries})
+    {
+        timeSeries -> reserve(numFrames);
+    }
 
     // number of residues in pore forming group:
     size_t numPoreRes = 0;
@@ -1483,16 +1721,27 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
 
     // container for time stamps:
     std::vector<real> timeStamps;
+    timeStamps.reserve(numFrames);
 
     // read file line by line and calculate summary statistics:
     int linesRead = 0;
     std::string line;
-    while( std::getline(inFile, line) )
+    std::vector<char> lineAllocBuffer(1 << 20);
+    size_t lineAllocSize = 0;
+    while( inFile -> getline(line) )
     {
-        // read line into JSON document:
-        rapidjson::StringStream lineStream(line.c_str());
-        rapidjson::Document lineDoc;
-        lineDoc.ParseStream(lineStream);
+        // grow DOM buffer if previous line did not fit into it:
+        if( lineAllocSize > lineAllocBuffer.size() )
+        {
+            lineAllocBuffer.resize(2*lineAllocSize);
+        }
+
+        // parse line in situ into JSON document backed by reusable buffer:
+        rapidjson::MemoryPoolAllocator<> lineAlloc(
+                lineAllocBuffer.data(), 
+                lineAllocBuffer.size());
+        rapidjson::Document lineDoc(&lineAlloc);
+        lineDoc.ParseInsitu(&line[0]);
 
         // sanity checks:
         if( !lineDoc.IsObject() )
@@ -1530,6 +1779,46 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
                 lineDoc["pathSummary"]["arcLengthHi"][0].GetDouble());
         bandWidthSummary.update(
                 lineDoc["pathSummary"]["bandWidth"][0].GetDouble());
+
+        // calculate quantile sketches of aggregate variables:
+        argMinRadiusQuantiles.update(
+                lineDoc["pathSummary"]["argMinRadius"][0].GetDouble());
+        minRadiusQuantiles.update(
+                lineDoc["pathSummary"]["minRadius"][0].GetDouble());
+        lengthQuantiles.update(
+                lineDoc["pathSummary"]["length"][0].GetDouble());
+        volumeQuantiles.update(
+                lineDoc["pathSummary"]["volume"][0].GetDouble());
+        numPathQuantiles.update(
+                lineDoc["pathSummary"]["numPath"][0].GetDouble());
+        numSampleQuantiles.update(
+                lineDoc["pathSummary"]["numSample"][0].GetDouble());
+        argMinSolventDensityQuantiles.update(
+                lineDoc["pathSummary"]["argMinSolventDensity"][0].GetDouble());
+        minSolventDensityQuantiles.update(
+                lineDoc["pathSummary"]["minSolventDensity"][0].GetDouble());
+        bandWidthQuantiles.update(
+                lineDoc["pathSummary"]["bandWidth"][0].GetDouble());
+
+        // calculate block averages of aggregate variables:
+        argMinRadiusBlockAvg.update(
+                lineDoc["pathSummary"]["argMinRadius"][0].GetDouble());
+        minRadiusBlockAvg.update(
+                lineDoc["pathSummary"]["minRadius"][0].GetDouble());
+        lengthBlockAvg.update(
+                lineDoc["pathSummary"]["length"][0].GetDouble());
+        volumeBlockAvg.update(
+                lineDoc["pathSummary"]["volume"][0].GetDouble());
+        numPathBlockAvg.update(
+                lineDoc["pathSummary"]["numPath"][0].GetDouble());
+        numSampleBlockAvg.update(
+                lineDoc["pathSummary"]["numSample"][0].GetDouble());
+        argMinSolventDensityBlockAvg.update(
+                lineDoc["pathSummary"]["argMinSolventDensity"][0].GetDouble());
+        minSolventDensityBlockAvg.update(
+                lineDoc["pathSummary"]["minSolventDensity"][0].GetDouble());
+        bandWidthBlockAvg.update(
+                lineDoc["pathSummary"]["bandWidth"][0].GetDouble());
         
         // get time stamp of current frame:
         real timeStamp = lineDoc["pathSummary"]["timeStamp"][0].GetDouble();
@@ -1549,21 +1838,25 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
         // in first line, also read number of residues in pore forming group:
         if( linesRead == 0 )
         {
-            numPoreRes = lineDoc["residuePositions"]["resId"].Size();
+            std::vector<real> resIds = JsonColumnCodec::decode(
+                    lineDoc["residuePositions"]["resId"]);
+            numPoreRes = resIds.size();
 
             for(size_t i = 0; i < numPoreRes; i++)
             {
-                poreResIds.push_back(
-                        lineDoc["residuePositions"]["resId"][i].GetDouble());
+                poreResIds.push_back(resIds[i]);
             }
         }
 
+        // remember memory required by this line's DOM:
+        lineAllocSize = lineAlloc.Capacity();
+
         // increment line counter:
         linesRead++;
     }
 
     // close per frame data set:
-    inFile.close();
+    inFile.reset();
     
     // sanity check:
     if( linesRead != numFrames )
@@ -1596,14 +1889,28 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     SummaryStatistics anchorEnergyHi;
 
     // open JSON data file in read mode:
-    inFile.open(inFileName.c_str(), std::fstream::in);
+    inFile.reset(new CompressedFileReadStream(inFileName));
     
     // prepare containers for profile summaries:
-    std::vector<SummaryStatistics> radiusSummary(supportPoints.size());
-    std::vector<SummaryStatistics> solventDensitySummary(supportPoints.size());
-    std::vector<SummaryStatistics> energySummary(supportPoints.size());
-    std::vector<SummaryStatistics> plHydrophobicitySummary(supportPoints.size());
-    std::vector<SummaryStatistics> pfHydrophobicitySummary(supportPoints.size());
+    SummaryStatisticsVector radiusSummary(supportPoints.size());
+    SummaryStatisticsVector solventDensitySummary(supportPoints.size());
+    SummaryStatisticsVector energySummary(supportPoints.size());
+    SummaryStatisticsVector plHydrophobicitySummary(supportPoints.size());
+    SummaryStatisticsVector pfHydrophobicitySummary(supportPoints.size());
+
+    // prepare quantile sketches for profiles:
+    std::vector<QuantileSketch> radiusQuantiles(supportPoints.size());
+    std::vector<QuantileSketch> solventDensityQuantiles(supportPoints.size());
+    std::vector<QuantileSketch> energyQuantiles(supportPoints.size());
+    std::vector<QuantileSketch> plHydrophobicityQuantiles(supportPoints.size());
+    std::vector<QuantileSketch> pfHydrophobicityQuantiles(supportPoints.size());
+
+    // prepare block averages for standard errors of profiles:
+    std::vector<BlockAverage> radiusBlockAvg(supportPoints.size());
+    std::vector<BlockAverage> solventDensityBlockAvg(supportPoints.size());
+    std::vector<BlockAverage> energyBlockAvg(supportPoints.size());
+    std::vector<BlockAverage> plHydrophobicityBlockAvg(supportPoints.size());
+    std::vector<BlockAverage> pfHydrophobicityBlockAvg(supportPoints.size());
 
     // prepare summary statistics for residue properties:
     std::vector<SummaryStatistics> residueArcSummary(numPoreRes);
@@ -1617,15 +1924,26 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     std::vector<SummaryStatistics> residueYSummary(numPoreRes);
     std::vector<SummaryStatistics> residueZSummary(numPoreRes);
 
-    // containers for profile valued time series: 
+    // containers for profile valued time series (held in memory for the same
+    // reason as the scalar time series): 
     std::vector<std::vector<real>> radiusProfileTimeSeries;
     std::vector<std::vector<real>> solventDensityTimeSeries;
     std::vector<std::vector<real>> plHydrophobicityTimeSeries;
     std::vector<std::vector<real>> pfHydrophobicityTimeSeries;
+    radiusProfileTimeSeries.reserve(numFrames);
+    solventDensityTimeSeries.reserve(numFrames);
+    plHydrophobicityTimeSeries.reserve(numFrames);
+    pfHydrophobicityTimeSeries.reserve(numFrames);
+
+    // columns of residue positions (may be compactly encoded):
+    const std::vector<std::string> residueColumnNames = {
+            "s", "rho", "phi", "poreLining", "poreFacing", "x", "y", "z",
+            "poreRadius", "solventDensity"};
+    std::vector<std::vector<real>> residueColumns(residueColumnNames.size());
 
     // read file line by line:
     int linesProcessed = 0;
-    while( std::getline(inFile, line) )
+    while( inFile -> getline(line) )
     {
         std::cout.precision(3);
         std::cout<<"\rForming time averages, "
@@ -1633,10 +1951,18 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
                  <<"\% complete"
                  <<std::flush;
 
-        // read line into JSON document:
-        rapidjson::StringStream lineStream(line.c_str());
-        rapidjson::Document lineDoc;
-        lineDoc.ParseStream(lineStream);
+        // grow DOM buffer if previous line did not fit into it:
+        if( lineAllocSize > lineAllocBuffer.size() )
+        {
+            lineAllocBuffer.resize(2*lineAllocSize);
+        }
+
+        // parse line in situ into JSON document backed by reusable buffer:
+        rapidjson::MemoryPoolAllocator<> lineAlloc(
+                lineAllocBuffer.data(), 
+                lineAllocBuffer.size());
+        rapidjson::Document lineDoc(&lineAlloc);
+        lineDoc.ParseInsitu(&line[0]);
 
         // sanity checks:
         if( !lineDoc.IsObject() )
@@ -1658,10 +1984,9 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
 
         // sample radius at support points and add to summary statistics:
         std::vector<real> radiusSample = molPath.sampleRadii(supportPoints); 
-        for(size_t i = 0; i < radiusSample.size(); i++)
-        {
-            radiusSummary.at(i).update(radiusSample.at(i));
-        }
+        radiusSummary.update(radiusSample);
+        QuantileSketch::updateMultiple(radiusQuantiles, radiusSample);
+        BlockAverage::updateMultiple(radiusBlockAvg, radiusSample);
 
         // add to time series:
         radiusProfileTimeSeries.push_back(radiusSample);
@@ -1672,18 +1997,18 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
                 lineDoc["pfHydrophobicitySpline"], 1);
         std::vector<real> pfHydrophobicitySample = 
                 pfHydrophobicitySpline.evaluateMultiple(supportPoints, 0);
-        SummaryStatistics::updateMultiple(
-                pfHydrophobicitySummary,
-                pfHydrophobicitySample);
+        pfHydrophobicitySummary.update(pfHydrophobicitySample);
+        QuantileSketch::updateMultiple(pfHydrophobicityQuantiles, pfHydrophobicitySample);
+        BlockAverage::updateMultiple(pfHydrophobicityBlockAvg, pfHydrophobicitySample);
         pfHydrophobicityTimeSeries.push_back(pfHydrophobicitySample);
 
         SplineCurve1D plHydrophobicitySpline = SplineCurve1DJsonConverter::fromJson(
                 lineDoc["plHydrophobicitySpline"], 1);
         std::vector<real> plHydrophobicitySample = 
                 plHydrophobicitySpline.evaluateMultiple(supportPoints, 0);
-        SummaryStatistics::updateMultiple(
-                plHydrophobicitySummary,
-                plHydrophobicitySample);
+        plHydrophobicitySummary.update(plHydrophobicitySample);
+        QuantileSketch::updateMultiple(plHydrophobicityQuantiles, plHydrophobicitySample);
+        BlockAverage::updateMultiple(plHydrophobicityBlockAvg, plHydrophobicitySample);
         plHydrophobicityTimeSeries.push_back(plHydrophobicitySample);
 
 
@@ -1703,17 +2028,17 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
                 solventDensitySample, 
                 radiusSample, 
                 totalNumber);
-        SummaryStatistics::updateMultiple(
-                solventDensitySummary,
-                solventDensitySample);
+        solventDensitySummary.update(solventDensitySample);
+        QuantileSketch::updateMultiple(solventDensityQuantiles, solventDensitySample);
+        BlockAverage::updateMultiple(solventDensityBlockAvg, solventDensitySample);
         solventDensityTimeSeries.push_back(solventDensitySample);
  
         // convert to energy and add to summary statistic:
         BoltzmannEnergyCalculator bec;
         std::vector<real> energySample = bec.calculate(solventDensitySample);
-        SummaryStatistics::updateMultiple(
-                energySummary,
-                energySample);
+        energySummary.update(energySample);
+        QuantileSketch::updateMultiple(energyQuantiles, energySample);
+        BlockAverage::updateMultiple(energyBlockAvg, energySample);
 
         // also evaluate density and radius at anchor points:
         real solventDensityAnchorLo = solventDensitySpline.evaluate(
@@ -1730,43 +2055,86 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
         anchorEnergyHi.update( energySpline.evaluate(anchorPointHi, 0) );
 
 
+        // decode residue position columns:
+        for(size_t j = 0; j < residueColumnNames.size(); j++)
+        {
+            JsonColumnCodec::decode(
+                    lineDoc["residuePositions"][residueColumnNames[j].c_str()],
+                    residueColumns[j]);
+            if( residueColumns[j].size() < numPoreRes )
+            {
+                throw std::runtime_error("Column residuePositions/" + 
+                                         residueColumnNames[j] + " in line " +
+                                         std::to_string(linesProcessed) + 
+                                         " has too few entries.");
+            }
+        }
+
         // loop over all pore forming residues:
         for(size_t i = 0; i < numPoreRes; i++)
         {
-            residueArcSummary.at(i).update(
-                    lineDoc["residuePositions"]["s"][i].GetDouble());
-            residueRhoSummary.at(i).update(
-                    lineDoc["residuePositions"]["rho"][i].GetDouble());
-            residuePhiSummary.at(i).update(
-                    lineDoc["residuePositions"]["phi"][i].GetDouble());
-            residuePlSummary.at(i).update(
-                    lineDoc["residuePositions"]["poreLining"][i].GetDouble());
-            residuePfSummary.at(i).update(
-                    lineDoc["residuePositions"]["poreFacing"][i].GetDouble());
-            residueXSummary.at(i).update(
-                    lineDoc["residuePositions"]["x"][i].GetDouble());
-            residueYSummary.at(i).update(
-                    lineDoc["residuePositions"]["y"][i].GetDouble());
-            residueZSummary.at(i).update(
-                    lineDoc["residuePositions"]["z"][i].GetDouble());
+            residueArcSummary.at(i).update(residueColumns[0][i]);
+            residueRhoSummary.at(i).update(residueColumns[1][i]);
+            residuePhiSummary.at(i).update(residueColumns[2][i]);
+            residuePlSummary.at(i).update(residueColumns[3][i]);
+            residuePfSummary.at(i).update(residueColumns[4][i]);
+            residueXSummary.at(i).update(residueColumns[5][i]);
+            residueYSummary.at(i).update(residueColumns[6][i]);
+            residueZSummary.at(i).update(residueColumns[7][i]);
 
             // residue-local number density requires additional post-processing:
-            real rad = lineDoc["residuePositions"]["poreRadius"][i].GetDouble();
-            real den = lineDoc["residuePositions"]["solventDensity"][i].GetDouble();
+            real rad = residueColumns[8][i];
+            real den = residueColumns[9][i];
             residuePoreRadiusSummary.at(i).update(rad);
             residueSolventDensitySummary.at(i).update(den*totalNumber/(M_PI*rad*rad));
         }
 
+        // remember memory required by this line's DOM:
+        lineAllocSize = lineAlloc.Capacity();
+
         // increment line counter:
         linesProcessed++;
     }
   
     // shift of energy profile so that energy at anchor points is zero:
     real shift = -0.5*(anchorEnergyLo.mean() + anchorEnergyHi.mean());
+    energySummary.shift(shift);
     std::for_each(
-            energySummary.begin(), 
-            energySummary.end(), 
-            [this, shift](SummaryStatistics &s){s.shift(shift);});
+            energyQuantiles.begin(), 
+            energyQuantiles.end(), 
+            [shift](QuantileSketch &q){q.shift(shift);});
+
+    // time-averaged density and energy from samples pooled over all frames:
+    std::vector<real> pooledDensity = solventDensityPool_.frameAveragedDensity(
+            supportPoints);
+    BoltzmannEnergyCalculator pooledBec;
+    std::vector<real> pooledEnergy = pooledBec.calculate(pooledDensity);
+
+    // shift pooled energy so that energy at anchor points is zero (anchor
+    // energies are obtained from interpolated density, as interpolating the
+    // energy itself is meaningless where infinities have been mended):
+    LinearSplineInterp1D pooledInterp;
+    auto pooledDensitySpline = pooledInterp(supportPoints, pooledDensity);
+    std::vector<real> pooledAnchorEnergy = pooledBec.calculate({
+            pooledDensitySpline.evaluate(anchorPointLo, 0),
+            pooledDensitySpline.evaluate(anchorPointHi, 0)});
+    const real energyMax = std::numeric_limits<real>::max();
+    if( std::abs(pooledAnchorEnergy[0]) < energyMax && 
+        std::abs(pooledAnchorEnergy[1]) < energyMax )
+    {
+        // mended infinities are left untouched:
+        real pooledShift = -0.5*(pooledAnchorEnergy[0] + pooledAnchorEnergy[1]);
+        std::for_each(
+                pooledEnergy.begin(), 
+                pooledEnergy.end(), 
+                [pooledShift, energyMax](real &e)
+                {
+                    if( std::abs(e) < energyMax )
+                    {
+                        e += pooledShift;
+                    }
+                });
+    }
 
     // inform user about progress:
     std::cout.precision(3);
@@ -1784,7 +2152,7 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     }
 
     // close filestream object:
-    inFile.close();
+    inFile.reset();
 
     
     // CREATE PDB OUTPUT
@@ -1800,63 +2168,157 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     // CREATE OUTPUT JSON
     // ------------------------------------------------------------------------
 
-    // initialise a JSON results container:
-    ResultsJsonExporter results;
-
-    // add summary statistics for scalr variables describing the pathway:
-    results.addPathwaySummary("argMinRadius", argMinRadiusSummary);
-    results.addPathwaySummary("minRadius", minRadiusSummary);
-    results.addPathwaySummary("length", lengthSummary);
-    results.addPathwaySummary("volume", volumeSummary);
-    results.addPathwaySummary("numPathway", numPathSummary);
-    results.addPathwaySummary("numSample", numSampleSummary);
-    results.addPathwaySummary("argMinSolventDensity", argMinSolventDensitySummary);
-    results.addPathwaySummary("minSolventDensity", minSolventDensitySummary);
-    results.addPathwaySummary("bandWidth", bandWidthSummary);
-
-    // add time-averaged pathway profiles:
-    results.addSupportPoints(supportPoints);
-    results.addPathwayProfile("radius", radiusSummary);
-    results.addPathwayProfile("plHydrophobicity", plHydrophobicitySummary);
-    results.addPathwayProfile("pfHydrophobicity", pfHydrophobicitySummary);
-    results.addPathwayProfile("density", solventDensitySummary);
-    results.addPathwayProfile("energy", energySummary);
+    // JSON output requested?
+    if( outputFormat_ == eOutputFormatJson || outputFormat_ == eOutputFormatAll )
+    {
+        // initialise a JSON results container that streams its sections to file
+        // as they are completed:
+        ResultsJsonExporter results;
+        results.beginStreaming(outFileName);
+
+        // add summary statistics for scalr variables describing the pathway:
+        results.addPathwaySummary("argMinRadius", argMinRadiusSummary);
+        results.addPathwaySummary("minRadius", minRadiusSummary);
+        results.addPathwaySummary("length", lengthSummary);
+        results.addPathwaySummary("volume", volumeSummary);
+        results.addPathwaySummary("numPathway", numPathSummary);
+        results.addPathwaySummary("numSample", numSampleSummary);
+        results.addPathwaySummary("argMinSolventDensity", argMinSolventDensitySummary);
+        results.addPathwaySummary("minSolventDensity", minSolventDensitySummary);
+        results.addPathwaySummary("bandWidth", bandWidthSummary);
+
+        // add quantiles of scalar variables describing the pathway:
+        results.addPathwayQuantiles("argMinRadius", argMinRadiusQuantiles);
+        results.addPathwayQuantiles("minRadius", minRadiusQuantiles);
+        results.addPathwayQuantiles("length", lengthQuantiles);
+        results.addPathwayQuantiles("volume", volumeQuantiles);
+        results.addPathwayQuantiles("numPathway", numPathQuantiles);
+        results.addPathwayQuantiles("numSample", numSampleQuantiles);
+        results.addPathwayQuantiles("argMinSolventDensity", argMinSolventDensityQuantiles);
+        results.addPathwayQuantiles("minSolventDensity", minSolventDensityQuantiles);
+        results.addPathwayQuantiles("bandWidth", bandWidthQuantiles);
+
+        // add block averaging standard errors of scalar variables:
+        results.addPathwayStandardError("argMinRadius", argMinRadiusBlockAvg);
+        results.addPathwayStandardError("minRadius", minRadiusBlockAvg);
+        results.addPathwayStandardError("length", lengthBlockAvg);
+        results.addPathwayStandardError("volume", volumeBlockAvg);
+        results.addPathwayStandardError("numPathway", numPathBlockAvg);
+        results.addPathwayStandardError("numSample", numSampleBlockAvg);
+        results.addPathwayStandardError("argMinSolventDensity", argMinSolventDensityBlockAvg);
+        results.addPathwayStandardError("minSolventDensity", minSolventDensityBlockAvg);
+        results.addPathwayStandardError("bandWidth", bandWidthBlockAvg);
+
+        // add time-averaged pathway profiles:
+        results.addSupportPoints(supportPoints);
+        results.addPathwayProfile("radius", radiusSummary.summaries());
+        results.addPathwayProfile("plHydrophobicity", plHydrophobicitySummary.summaries());
+        results.addPathwayProfile("pfHydrophobicity", pfHydrophobicitySummary.summaries());
+        results.addPathwayProfile("density", solventDensitySummary.summaries());
+        results.addPathwayProfile("energy", energySummary.summaries());
+        results.addPathwayProfile("densityPooled", pooledDensity);
+        results.addPathwayProfile("energyPooled", pooledEnergy);
+
+        // add quantiles of pathway profiles:
+        results.addPathwayProfileQuantiles("radius", radiusQuantiles);
+        results.addPathwayProfileQuantiles("plHydrophobicity", plHydrophobicityQuantiles);
+        results.addPathwayProfileQuantiles("pfHydrophobicity", pfHydrophobicityQuantiles);
+        results.addPathwayProfileQuantiles("density", solventDensityQuantiles);
+        results.addPathwayProfileQuantiles("energy", energyQuantiles);
+
+        // add block averaging standard errors of pathway profiles (note that the
+        // energy shift does not affect the standard error):
+        results.addPathwayProfileStandardError("radius", radiusBlockAvg);
+        results.addPathwayProfileStandardError("plHydrophobicity", plHydrophobicityBlockAvg);
+        results.addPathwayProfileStandardError("pfHydrophobicity", pfHydrophobicityBlockAvg);
+        results.addPathwayProfileStandardError("density", solventDensityBlockAvg);
+        results.addPathwayProfileStandardError("energy", energyBlockAvg);
     
-    // add scalar time series data to output:
-    results.addTimeStamps(timeStamps);
-    results.addPathwayScalarTimeSeries("argMinRadius", argMinRadiusTimeSeries);
-    results.addPathwayScalarTimeSeries("minRadius", minRadiusTimeSeries);
-    results.addPathwayScalarTimeSeries("length", lengthTimeSeries);
-    results.addPathwayScalarTimeSeries("volume", volumeTimeSeries);
-    results.addPathwayScalarTimeSeries("numPathway", numPathwayTimeSeries);
-    results.addPathwayScalarTimeSeries("numSample", numSampleTimeSeries);
-    results.addPathwayScalarTimeSeries("argMinSolventDensity", argMinSolventDensityTimeSeries);
-    results.addPathwayScalarTimeSeries("minSolventDensity", minSolventDensityTimeSeries);
-    results.addPathwayScalarTimeSeries("bandWidth", bandWidthTimeSeries);
-
-    // add vector-valued time series data to output:
-    results.addPathwayGridPoints(timeStamps, supportPoints);
-    results.addPathwayProfileTimeSeries("radius", radiusProfileTimeSeries);
-    results.addPathwayProfileTimeSeries("density", solventDensityTimeSeries);
-    results.addPathwayProfileTimeSeries("plHydrophobicity", plHydrophobicityTimeSeries);
-    results.addPathwayProfileTimeSeries("pfHydrophobicity", pfHydrophobicityTimeSeries);
-
-    // add per-residue data to output document:
-    results.addResidueInformation(poreResIds, resInfo_);
-    results.addResidueSummary("s", residueArcSummary);
-    results.addResidueSummary("rho", residueRhoSummary);
-    results.addResidueSummary("phi", residuePhiSummary);
-    results.addResidueSummary("poreLining", residuePlSummary);
-    results.addResidueSummary("poreFacing", residuePfSummary);
-    results.addResidueSummary("poreRadius", residuePoreRadiusSummary);
-    results.addResidueSummary("solventDensity", residueSolventDensitySummary);
-    results.addResidueSummary("x", residueXSummary);
-    results.addResidueSummary("y", residueYSummary);
-    results.addResidueSummary("z", residueZSummary);
-
-
-    // write results to JSON file:
-    results.write(outFileName);
+        // add scalar time series data to output:
+        results.addTimeStamps(timeStamps);
+        results.addPathwayScalarTimeSeries("argMinRadius", argMinRadiusTimeSeries);
+        results.addPathwayScalarTimeSeries("minRadius", minRadiusTimeSeries);
+        results.addPathwayScalarTimeSeries("length", lengthTimeSeries);
+        results.addPathwayScalarTimeSeries("volume", volumeTimeSeries);
+        results.addPathwayScalarTimeSeries("numPathway", numPathwayTimeSeries);
+        results.addPathwayScalarTimeSeries("numSample", numSampleTimeSeries);
+        results.addPathwayScalarTimeSeries("argMinSolventDensity", argMinSolventDensityTimeSeries);
+        results.addPathwayScalarTimeSeries("minSolventDensity", minSolventDensityTimeSeries);
+        results.addPathwayScalarTimeSeries("bandWidth", bandWidthTimeSeries);
+
+        // add vector-valued time series data to output:
+        results.addPathwayGridPoints(timeStamps, supportPoints);
+        results.addPathwayProfileTimeSeries("radius", radiusProfileTimeSeries);
+        results.addPathwayProfileTimeSeries("density", solventDensityTimeSeries);
+        results.addPathwayProfileTimeSeries("plHydrophobicity", plHydrophobicityTimeSeries);
+        results.addPathwayProfileTimeSeries("pfHydrophobicity", pfHydrophobicityTimeSeries);
+
+        // add per-residue data to output document:
+        results.addResidueInformation(poreResIds, resInfo_);
+        results.addResidueSummary("s", residueArcSummary);
+        results.addResidueSummary("rho", residueRhoSummary);
+        results.addResidueSummary("phi", residuePhiSummary);
+        results.addResidueSummary("poreLining", residuePlSummary);
+        results.addResidueSummary("poreFacing", residuePfSummary);
+        results.addResidueSummary("poreRadius", residuePoreRadiusSummary);
+        results.addResidueSummary("solventDensity", residueSolventDensitySummary);
+        results.addResidueSummary("x", residueXSummary);
+        results.addResidueSummary("y", residueYSummary);
+        results.addResidueSummary("z", residueZSummary);
+
+
+        // complete results JSON file:
+        results.finishStreaming();
+    }
+
+
+    // CREATE OUTPUT NPZ
+    // ------------------------------------------------------------------------
+
+    // columnar binary output requested?
+    if( outputFormat_ == eOutputFormatNpz || outputFormat_ == eOutputFormatAll )
+    {
+        // arrays are written to file as they are added:
+        ResultsNpzExporter npz(outputNpzFileName_);
+
+        // time-averaged pathway profiles:
+        npz.addArray("pathwayProfile/s", supportPoints);
+        npz.addArray("pathwayProfile/radiusMean", radiusSummary.mean());
+        npz.addArray("pathwayProfile/radiusSd", radiusSummary.sd());
+        npz.addArray("pathwayProfile/plHydrophobicityMean", plHydrophobicitySummary.mean());
+        npz.addArray("pathwayProfile/plHydrophobicitySd", plHydrophobicitySummary.sd());
+        npz.addArray("pathwayProfile/pfHydrophobicityMean", pfHydrophobicitySummary.mean());
+        npz.addArray("pathwayProfile/pfHydrophobicitySd", pfHydrophobicitySummary.sd());
+        npz.addArray("pathwayProfile/densityMean", solventDensitySummary.mean());
+        npz.addArray("pathwayProfile/densitySd", solventDensitySummary.sd());
+        npz.addArray("pathwayProfile/energyMean", energySummary.mean());
+        npz.addArray("pathwayProfile/energySd", energySummary.sd());
+        npz.addArray("pathwayProfile/densityPooled", pooledDensity);
+        npz.addArray("pathwayProfile/energyPooled", pooledEnergy);
+
+        // scalar time series:
+        npz.addArray("pathwayScalarTimeSeries/t", timeStamps);
+        npz.addArray("pathwayScalarTimeSeries/argMinRadius", argMinRadiusTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/minRadius", minRadiusTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/length", lengthTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/volume", volumeTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/numPathway", numPathwayTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/numSample", numSampleTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/argMinSolventDensity", argMinSolventDensityTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/minSolventDensity", minSolventDensityTimeSeries);
+        npz.addArray("pathwayScalarTimeSeries/bandWidth", bandWidthTimeSeries);
+
+        // profile time series as (time x support point) matrices:
+        npz.addArray("pathwayProfileTimeSeries/t", timeStamps);
+        npz.addArray("pathwayProfileTimeSeries/s", supportPoints);
+        npz.addArray("pathwayProfileTimeSeries/radius", radiusProfileTimeSeries);
+        npz.addArray("pathwayProfileTimeSeries/density", solventDensityTimeSeries);
+        npz.addArray("pathwayProfileTimeSeries/plHydrophobicity", plHydrophobicityTimeSeries);
+        npz.addArray("pathwayProfileTimeSeries/pfHydrophobicity", pfHydrophobicityTimeSeries);
+
+        // complete archive:
+        npz.close();
+    }
 
 
     // DELETE PER FRAME DATA
@@ -1873,42 +2335,24 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     // ------------------------------------------------------------------------
 
     // retrieve averaged properties:
-    std::vector<real> avgRadius;
-    std::vector<real> avgSolventDensity;
-    std::vector<real> avgEnergy;
-    std::vector<real> avgPlHydrophobicity;
-    std::vector<real> avgPfHydrophobicity;
-    for(size_t i = 0; i < supportPoints.size(); i++)
-    {
-        avgRadius.push_back(radiusSummary.at(i).mean());
-        avgSolventDensity.push_back(solventDensitySummary.at(i).mean());
-        avgEnergy.push_back(energySummary.at(i).mean());
-        avgPlHydrophobicity.push_back(plHydrophobicitySummary.at(i).mean());
-        avgPfHydrophobicity.push_back(pfHydrophobicitySummary.at(i).mean());
-    }
-
-    // averaged properties as spline curves:
+    std::vector<std::vector<real>> avgProfiles = {
+            radiusSummary.mean(),
+            solventDensitySummary.mean(),
+            energySummary.mean(),
+            plHydrophobicitySummary.mean(),
+            pfHydrophobicitySummary.mean()};
+
+    // averaged properties as spline curves (all share the support points):
     CubicSplineInterp1D interp;
-    auto avgRadiusSpl = interp(
-            supportPoints, 
-            avgRadius, 
-            eSplineInterpBoundaryHermite);
-    auto avgSolventDensitySpl = interp(
-            supportPoints, 
-            avgSolventDensity, 
-            eSplineInterpBoundaryHermite);
-    auto avgEnergySpl = interp(
-            supportPoints, 
-            avgEnergy, 
-            eSplineInterpBoundaryHermite);
-    auto avgPlHydrophobicitySpl = interp(
-            supportPoints, 
-            avgPlHydrophobicity, 
-            eSplineInterpBoundaryHermite);
-    auto avgPfHydrophobicitySpl = interp(
-            supportPoints, 
-            avgPfHydrophobicity, 
+    std::vector<SplineCurve1D> avgProfileSpl = interp(
+            supportPoints,
+            avgProfiles,
             eSplineInterpBoundaryHermite);
+    SplineCurve1D &avgRadiusSpl = avgProfileSpl[0];
+    SplineCurve1D &avgSolventDensitySpl = avgProfileSpl[1];
+    SplineCurve1D &avgEnergySpl = avgProfileSpl[2];
+    SplineCurve1D &avgPlHydrophobicitySpl = avgProfileSpl[3];
+    SplineCurve1D &avgPfHydrophobicitySpl = avgProfileSpl[4];
 
 
     // associate properties with pathway:
@@ -1930,11 +2374,20 @@ ChapTrajectoryAnalysis::finishAnalysis(int numFrames)
     mpexp.setExtrapDist(outputExtrapDist_);
     mpexp.setGridSampleDist(outputGridSampleDist_);
     mpexp.setCorrectionThreshold(outputCorrectionThreshold_);
+    mpexp.setWritePly(outputPly_);
     mpexp(
         outputBaseFileName_, 
         "time_averaged_molecular_path", 
         *molPathAvg_,
         palettes);
+
+    // report time spent on pathway surface export:
+    double tSurface = 0.0;
+    for(auto t : mpexp.timings())
+    {
+        tSurface += t.second;
+    }
+    std::cout<<"Exported pathway surface in "<<tSurface<<" s."<<std::endl;
 }
 
 
@@ -1991,7 +2444,14 @@ ChapTrajectoryAnalysis::checkParameters()
     // add proper extensions to file names:
     // TODO: better in exporter code?
     outputJsonFileName_ = outputBaseFileName_ + ".json";
+    if( outputCompress_ )
+    {
+        outputJsonFileName_ += ".gz";
+    }
     outputPdbFileName_ = outputBaseFileName_ + ".pdb";
+    outputNpzFileName_ = outputBaseFileName_ + ".npz";
+    outputMeshFileName_ = outputBaseFileName_ + ".mesh";
+    outputPdbTrajectoryFileName_ = outputBaseFileName_ + "_frames.pdb";
 
     // sanity checks:
     if( outputExtrapDist_ < 0.0 )
@@ -1999,6 +2459,21 @@ ChapTrajectoryAnalysis::checkParameters()
         throw std::runtime_error("Parameter -out-extrap-dist may not be "
                                  "negative.");
     }
+    if( outputDetailedPrecision_ < 0.0 )
+    {
+        throw std::runtime_error("Parameter -out-detailed-precision may not "
+                                 "be negative.");
+    }
+    if( outputMeshStride_ < 0 )
+    {
+        throw std::runtime_error("Parameter -out-mesh-stride may not be "
+                                 "negative.");
+    }
+    if( outputPdbStride_ < 0 )
+    {
+        throw std::runtime_error("Parameter -out-pdb-stride may not be "
+                                 "negative.");
+    }
     if( outputGridSampleDist_ <= 0.0 )
     {
         throw std::runtime_error("Parameter -out-grid-dist must be strictly "
@@ -2064,6 +2539,9 @@ ChapTrajectoryAnalysis::checkParameters()
         deParams_.setMaxEvalPointDist(deResolution_);
     }
 
+    // samples pooled over all frames are binned at density resolution:
+    solventDensityPool_.setBinWidth(deResolution_);
+
     
     // HYDROPHOBICITY PARAMETERS
     //-------------------------------------------------------------------------
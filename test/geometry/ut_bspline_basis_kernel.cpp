@@ -0,0 +1,165 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geometry/bspline_basis_kernel.hpp"
+#include "geometry/bspline_basis_set.hpp"
+
+
+/*!
+ * \brief Test fixture for BSplineBasisKernel.
+ */
+class BSplineBasisKernelTest : public ::testing::Test
+{
+    protected:
+
+        // nonuniform unique knots:
+        std::vector<real> uniqueKnots_ = {-4.0, -0.5, 0.0, 0.3, 0.5, 4.0};
+
+        // evaluation points including knots and endpoints:
+        std::vector<real> evalPoints_ = {-4.0, -2.5, -0.5, -0.1, 0.0, 0.4, 
+                                         0.5, std::sqrt(2.0), 4.0};
+
+        // create degree-appropriate knot vector from unique knots:
+        std::vector<real> prepareKnotVector(
+                const std::vector<real> &uniqueKnots, 
+                unsigned int degree)
+        {
+            std::vector<real> knots;
+            for(unsigned int i = 0; i < degree; i++)
+            {
+                knots.push_back(uniqueKnots.front());
+            }
+            for(unsigned int i = 0; i < uniqueKnots.size(); i++)
+            {
+                knots.push_back(uniqueKnots[i]);
+            }
+            for(unsigned int i = 0; i < degree; i++)
+            {
+                knots.push_back(uniqueKnots.back());
+            }
+
+            return knots;
+        }
+
+        // compare kernel to generic basis set evaluation:
+        template<int Degree, int Deriv>
+        void compareToBasisSet()
+        {
+            real eps = std::numeric_limits<real>::epsilon();
+
+            std::vector<real> knots = prepareKnotVector(uniqueKnots_, Degree);
+            BSplineBasisSet B;
+
+            for(auto eval : evalPoints_)
+            {
+                // knot span as used by spline curves:
+                int knotSpanIdx = Degree;
+                while( knotSpanIdx < static_cast<int>(knots.size()) - Degree - 2 &&
+                       knots[knotSpanIdx + 1] <= eval )
+                {
+                    knotSpanIdx++;
+                }
+
+                // evaluate both ways:
+                SparseBasis ref = B(eval, knots, Degree, Deriv);
+                typename BSplineBasisKernel<Degree, Deriv>::Elements basis =
+                        BSplineBasisKernel<Degree, Deriv>::evaluate(
+                                eval,
+                                knots.data(),
+                                knotSpanIdx);
+
+                // nonzero elements must agree:
+                for(int i = 0; i <= Degree; i++)
+                {
+                    real refVal = ref[knotSpanIdx - Degree + i];
+                    ASSERT_NEAR(refVal, basis[i], 
+                                100*eps*std::max(real(1.0), std::abs(refVal)));
+                }
+            }
+        }
+};
+
+
+/*!
+ * Checks that the linear kernel agrees with BSplineBasisSet for the basis 
+ * functions, their first derivative, and the vanishing second derivative.
+ */
+TEST_F(BSplineBasisKernelTest, BSplineBasisKernelLinearTest)
+{
+    compareToBasisSet<1, 0>();
+    compareToBasisSet<1, 1>();
+    compareToBasisSet<1, 2>();
+}
+
+
+/*!
+ * Checks that the cubic kernel agrees with BSplineBasisSet for the basis 
+ * functions and all derivatives up to fourth order (which vanishes).
+ */
+TEST_F(BSplineBasisKernelTest, BSplineBasisKernelCubicTest)
+{
+    compareToBasisSet<3, 0>();
+    compareToBasisSet<3, 1>();
+    compareToBasisSet<3, 2>();
+    compareToBasisSet<3, 3>();
+    compareToBasisSet<3, 4>();
+}
+
+
+/*!
+ * Checks that the basis functions returned by the cubic kernel form a 
+ * partition of unity and that their derivatives sum to zero.
+ */
+TEST_F(BSplineBasisKernelTest, BSplineBasisKernelPartitionOfUnityTest)
+{
+    real eps = std::numeric_limits<real>::epsilon();
+
+    std::vector<real> knots = prepareKnotVector(uniqueKnots_, 3);
+    for(int knotSpanIdx = 3; knotSpanIdx < 3 + 5; knotSpanIdx++)
+    {
+        real eval = 0.5*(knots[knotSpanIdx] + knots[knotSpanIdx + 1]);
+
+        BSplineBasisKernel<3, 0>::Elements basis = 
+                BSplineBasisKernel<3, 0>::evaluate(eval, knots.data(), knotSpanIdx);
+        BSplineBasisKernel<3, 1>::Elements deriv = 
+                BSplineBasisKernel<3, 1>::evaluate(eval, knots.data(), knotSpanIdx);
+
+        real sumBasis = 0.0;
+        real sumDeriv = 0.0;
+        for(int i = 0; i <= 3; i++)
+        {
+            sumBasis += basis[i];
+            sumDeriv += deriv[i];
+        }
+        ASSERT_NEAR(1.0, sumBasis, 10*eps);
+        ASSERT_NEAR(0.0, sumDeriv, 100*eps);
+    }
+}
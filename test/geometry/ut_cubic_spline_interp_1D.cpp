@@ -73,3 +73,88 @@ TEST_F(CubicSplineInterp1DTest, CubicSplineInterpHermiteLinearTest)
     }
 }
 
+
+
+/*!
+ * Tests interpolation of a large number of support points, which exceeds the
+ * size of the linear system that could previously be allocated on the stack.
+ * Correct evaluation is checked at a subset of the support points.
+ */
+TEST_F(CubicSplineInterp1DTest, CubicSplineInterpHermiteLargeSystemTest)
+{
+    // floating point tolerance:
+    real eps = std::sqrt(std::numeric_limits<real>::epsilon());
+
+    // define a large point set sampling a smooth function:
+    size_t nDat = 500000;
+    std::vector<real> x(nDat);
+    std::vector<real> f(nDat);
+    for(size_t i = 0; i < nDat; i++)
+    {
+        x[i] = 10.0*i/(nDat - 1);
+        f[i] = std::sin(x[i]);
+    }
+
+    // interpolate twice with same object to reuse workspace:
+    CubicSplineInterp1D Interp;
+    SplineCurve1D Spl = Interp(x, f, eSplineInterpBoundaryHermite);
+    Spl = Interp(x, f, eSplineInterpBoundaryHermite);
+
+    // check that spline curve goes through support points:
+    for(size_t i = 0; i < nDat; i += 997)
+    {
+        ASSERT_NEAR(f[i], Spl.evaluate(x[i], 0), eps);
+    }
+}
+
+
+/*!
+ * Tests that interpolating several profiles over the same support points in 
+ * one call yields the same spline curves as interpolating each profile 
+ * individually and that these curves share a single knot vector.
+ */
+TEST_F(CubicSplineInterp1DTest, CubicSplineInterpHermiteMultipleProfilesTest)
+{
+    // floating point tolerance:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // define support points and several profiles:
+    std::vector<real> x = {-2.0, -1.3,  0.0,  0.4,  1.0,  2.5};
+    std::vector<std::vector<real>> f = {
+            { 1.0,  0.5, -0.3,  0.2,  1.7, -1.0},
+            {-2.0, -1.3,  0.0,  0.4,  1.0,  2.5},
+            { 0.0,  3.0,  0.0,  3.0,  0.0,  3.0}};
+
+    // interpolate all profiles at once:
+    CubicSplineInterp1D Interp;
+    std::vector<SplineCurve1D> splines = Interp(
+            x, f, eSplineInterpBoundaryHermite);
+    ASSERT_EQ(f.size(), splines.size());
+
+    // all curves refer to the same knot storage:
+    for(size_t j = 1; j < splines.size(); j++)
+    {
+        ASSERT_EQ(&splines[0].knotVector(), &splines[j].knotVector());
+    }
+
+    // compare to individual interpolation:
+    for(size_t j = 0; j < f.size(); j++)
+    {
+        SplineCurve1D Spl = Interp(x, f[j], eSplineInterpBoundaryHermite);
+
+        ASSERT_EQ(Spl.knotVector().size(), splines[j].knotVector().size());
+        for(size_t i = 0; i < Spl.knotVector().size(); i++)
+        {
+            ASSERT_EQ(Spl.knotVector()[i], splines[j].knotVector()[i]);
+        }
+
+        ASSERT_EQ(Spl.ctrlPoints().size(), splines[j].ctrlPoints().size());
+        for(size_t i = 0; i < Spl.ctrlPoints().size(); i++)
+        {
+            ASSERT_NEAR(
+                    Spl.ctrlPoints()[i], 
+                    splines[j].ctrlPoints()[i], 
+                    eps);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geometry/rotation_minimising_frame.hpp"
+
+
+/*!
+ * \brief Test fixture for RotationMinimisingFrame.
+ */
+class RotationMinimisingFrameTest : public ::testing::Test
+{
+    protected:
+
+        const real PI_ = std::acos(-1.0);
+};
+
+
+/*!
+ * Checks that the frame along a straight line is constant and that angle() 
+ * and direction() are inverse to one another, also outside the table range.
+ */
+TEST_F(RotationMinimisingFrameTest, RotationMinimisingFrameStraightLineTest)
+{
+    real eps = 10*std::numeric_limits<real>::epsilon();
+
+    // straight line along the y-axis:
+    real step = 0.25;
+    std::vector<gmx::RVec> points;
+    std::vector<gmx::RVec> tangents;
+    for(int i = 0; i < 9; i++)
+    {
+        points.push_back(gmx::RVec(1.0, i*step, -3.0));
+        tangents.push_back(gmx::RVec(0.0, 2.0, 0.0));
+    }
+    RotationMinimisingFrame frame(step, points, tangents);
+    ASSERT_EQ(9u, frame.size());
+
+    // frame is constant and orthonormal:
+    gmx::RVec n0 = frame.normal(0.0);
+    gmx::RVec b0 = frame.binormal(0.0);
+    for(real s = -1.0; s < 3.0; s += 0.1)
+    {
+        gmx::RVec n = frame.normal(s);
+        gmx::RVec b = frame.binormal(s);
+        for(int d = XX; d <= ZZ; d++)
+        {
+            ASSERT_NEAR(n0[d], n[d], eps);
+            ASSERT_NEAR(b0[d], b[d], eps);
+        }
+        ASSERT_NEAR(0.0, n[YY], eps);
+        ASSERT_NEAR(0.0, iprod(n, b), eps);
+        ASSERT_NEAR(1.0, norm(n), eps);
+        ASSERT_NEAR(1.0, norm(b), eps);
+    }
+
+    // angle and direction are inverse to one another:
+    for(real phi = -3.0; phi < 3.1; phi += 0.5)
+    {
+        for(real s = -0.5; s < 2.5; s += 0.7)
+        {
+            gmx::RVec dir = frame.direction(s, phi);
+            ASSERT_NEAR(phi, frame.angle(s, dir), eps);
+        }
+    }
+}
+
+
+/*!
+ * Checks that the frame along a helix is orthonormal and orthogonal to the 
+ * tangent, and that it does not rotate about the tangent, i.e. that the 
+ * normal changes only in the direction of the tangent. In the Frenet frame,
+ * the normal would rotate towards the binormal at a rate given by the torsion
+ * of the helix.
+ */
+TEST_F(RotationMinimisingFrameTest, RotationMinimisingFrameHelixTest)
+{
+    real eps = std::sqrt(std::numeric_limits<real>::epsilon());
+
+    // helix with unit speed parameterisation:
+    real a = 1.5;
+    real c = 0.8;
+    real speed = std::sqrt(a*a + c*c);
+    real step = 0.01;
+    int numPoints = 2.0*PI_*speed/step;
+    std::vector<gmx::RVec> points;
+    std::vector<gmx::RVec> tangents;
+    for(int i = 0; i < numPoints; i++)
+    {
+        real t = i*step/speed;
+        points.push_back(gmx::RVec(a*std::cos(t), a*std::sin(t), c*t));
+        tangents.push_back(gmx::RVec(-a*std::sin(t), a*std::cos(t), c));
+    }
+    RotationMinimisingFrame frame(step, points, tangents);
+
+    // check frame at each table entry:
+    for(int i = 0; i < numPoints - 1; i++)
+    {
+        real s = i*step;
+        gmx::RVec tangent;
+        unitv(tangents[i], tangent);
+        gmx::RVec n = frame.normal(s);
+        gmx::RVec b = frame.binormal(s);
+
+        // orthonormality:
+        ASSERT_NEAR(0.0, iprod(n, tangent), eps);
+        ASSERT_NEAR(0.0, iprod(b, tangent), eps);
+        ASSERT_NEAR(0.0, iprod(n, b), eps);
+        ASSERT_NEAR(1.0, norm(n), eps);
+
+        // no rotation about tangent between consecutive entries:
+        gmx::RVec nNext = frame.normal(s + step);
+        ASSERT_NEAR(0.0, iprod(nNext, b), eps);
+    }
+}
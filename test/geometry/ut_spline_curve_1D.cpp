@@ -22,6 +22,7 @@
 // THE SOFTWARE.
 
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
 #include <limits>
@@ -93,6 +94,106 @@ TEST_F(SplineCurve1DTest, SplineCurve1DFindIntervalTest)
 }
 
 
+/*!
+ * Checks that uniformly spaced knots are detected and that the constant time
+ * interval lookup used in this case gives the same interval as a binary 
+ * search, also at the knots themselves and after shifting the curve. Spline
+ * evaluation is compared to direct evaluation of the basis functions.
+ */
+TEST_F(SplineCurve1DTest, SplineCurve1DUniformKnotsTest)
+{
+    // floating point comparison threshold:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // cubic spline with uniform knot spacing that is not exactly representable:
+    int degree = 3;
+    int nUnique = 37;
+    std::vector<real> uniqueKnots;
+    for(int i = 0; i < nUnique; i++)
+    {
+        uniqueKnots.push_back(-1.3 + 0.1*i);
+    }
+    std::vector<real> knots = prepareKnotVector(uniqueKnots, degree);
+    std::vector<real> ctrlPoints;
+    for(size_t i = 0; i < knots.size() - degree - 1; i++)
+    {
+        ctrlPoints.push_back(std::sin(0.7*i));
+    }
+    SplineCurve1D SplC(degree, knots, ctrlPoints);
+    ASSERT_TRUE(SplC.hasUniformKnots());
+
+    // evaluation points include all knots and points in between:
+    std::vector<real> evalPoints(uniqueKnots);
+    for(int i = 0; i < 1000; i++)
+    {
+        evalPoints.push_back(uniqueKnots.front() + 
+                i*(uniqueKnots.back() - uniqueKnots.front())/999);
+    }
+
+    // compare with binary search and direct basis evaluation:
+    BSplineBasisSet B;
+    for(auto eval : evalPoints)
+    {
+        int refIdx = std::upper_bound(knots.begin(), knots.end(), eval) 
+                   - knots.begin() - 1;
+        if( eval == knots.back() )
+        {
+            refIdx = std::lower_bound(knots.begin(), knots.end(), eval)
+                   - knots.begin() - 1;
+        }
+        ASSERT_EQ(refIdx, SplC.findInterval(eval));
+
+        for(unsigned int deriv = 0; deriv <= 2; deriv++)
+        {
+            // derivatives scale with inverse knot spacing:
+            real tol = 10*eps*std::pow(real(10.0), deriv);
+
+            SparseBasis basis = B(eval, knots, degree, deriv);
+            real refValue = 0.0;
+            for(auto b : basis)
+            {
+                refValue += b.second*ctrlPoints[b.first];
+            }
+            ASSERT_NEAR(refValue, SplC.evaluate(eval, deriv), tol);
+        }
+    }
+
+    // shifted curve still uses uniform knots:
+    SplC.shift(gmx::RVec(0.05, 0.0, 0.0));
+    ASSERT_TRUE(SplC.hasUniformKnots());
+    std::vector<real> shiftedKnots = SplC.knotVector();
+    for(auto eval : shiftedKnots)
+    {
+        int refIdx = std::upper_bound(
+                shiftedKnots.begin(), shiftedKnots.end(), eval) 
+                   - shiftedKnots.begin() - 1;
+        if( eval == shiftedKnots.back() )
+        {
+            refIdx = std::lower_bound(
+                    shiftedKnots.begin(), shiftedKnots.end(), eval) 
+                   - shiftedKnots.begin() - 1;
+        }
+        ASSERT_EQ(refIdx, SplC.findInterval(eval));
+    }
+
+    // extrapolation uses values at the endpoints:
+    ASSERT_NEAR(SplC.evaluate(shiftedKnots.front(), 0),
+                SplC.evaluate(shiftedKnots.front() - 1.0, 0),
+                eps);
+    ASSERT_NEAR(SplC.evaluate(shiftedKnots.back(), 0),
+                SplC.evaluate(shiftedKnots.back() + 1.0, 0),
+                eps);
+
+    // nonuniform knots are detected as such:
+    uniqueKnots[nUnique/2] += 0.02;
+    SplineCurve1D NonUniform(
+            degree, 
+            prepareKnotVector(uniqueKnots, degree), 
+            ctrlPoints);
+    ASSERT_FALSE(NonUniform.hasUniformKnots());
+}
+
+
 /*!
  * Uses a simple linear interpolating spline to test whether spline evaluation 
  * works correctly. Evaluation points are chosen to be the control points and
@@ -247,3 +348,114 @@ TEST_F(SplineCurve1DTest, SplineCurve1DExtrapolationTest)
                 eps); 
 }
 
+
+
+/*!
+ * Checks that copies of a spline curve share their knots and control points
+ * rather than copying them, and that shifting a copy does not affect the 
+ * original curve.
+ */
+TEST_F(SplineCurve1DTest, SplineCurve1DSharedStorageTest)
+{
+    // create a linear spline curve:
+    int degree = 1;
+    std::vector<real> knots = {-1.0, -1.0, 0.0, 1.0, 1.0};
+    std::vector<real> ctrlPoints = {2.0, -1.0, 3.0};
+    SplineCurve1D original(degree, knots, ctrlPoints);
+
+    // copy shares underlying data:
+    SplineCurve1D copy = original;
+    ASSERT_EQ(original.knotVector().data(), copy.knotVector().data());
+    ASSERT_EQ(original.ctrlPoints().data(), copy.ctrlPoints().data());
+
+    // unique knots are a view into the knot vector:
+    ArrayView<real> uniqueKnots = original.uniqueKnots();
+    ASSERT_EQ(3u, uniqueKnots.size());
+    ASSERT_EQ(original.knotVector().data() + degree, &uniqueKnots.front());
+
+    // shifting the copy leaves the original untouched:
+    copy.shift(gmx::RVec(0.5, 0.0, 0.0));
+    for(size_t i = 0; i < knots.size(); i++)
+    {
+        ASSERT_EQ(knots[i], original.knotVector()[i]);
+        ASSERT_EQ(knots[i] - 0.5, copy.knotVector()[i]);
+    }
+    ASSERT_EQ(original.ctrlPoints().data(), copy.ctrlPoints().data());
+    ASSERT_EQ(original.evaluate(0.0, 0), copy.evaluate(-0.5, 0));
+}
+
+
+/*!
+ * Checks the closed-form minimisation of spline curves for a cubic Bezier 
+ * curve representing a shifted parabola and for a piecewise linear curve. 
+ * This includes search ranges where the minimum lies on the range boundary.
+ */
+TEST_F(SplineCurve1DTest, SplineCurve1DMinimumTest)
+{
+    // floating point comparison threshold:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // cubic Bezier representation of f(s) = (s - 0.3)^2 + 0.5:
+    std::vector<real> knots = {0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0};
+    std::vector<real> ctrlPoints = {0.59, 0.39, 0.59 - 0.4 + 1.0/3.0, 0.99};
+    SplineCurve1D cubic(3, knots, ctrlPoints);
+
+    // interior minimum:
+    std::pair<real, real> min = cubic.minimum(std::make_pair(0.0, 1.0));
+    ASSERT_NEAR(0.3, min.first, 10*eps);
+    ASSERT_NEAR(0.5, min.second, 10*eps);
+
+    // minimum on boundary of search range:
+    min = cubic.minimum(std::make_pair(0.5, 1.0));
+    ASSERT_NEAR(0.5, min.first, 10*eps);
+    ASSERT_NEAR(0.54, min.second, 10*eps);
+
+    // piecewise linear curve with minimum at interior knot:
+    knots = {0.0, 0.0, 1.0, 2.0, 2.0};
+    ctrlPoints = {1.0, -1.0, 2.0};
+    SplineCurve1D linear(1, knots, ctrlPoints);
+    min = linear.minimum(std::make_pair(-1.0, 3.0));
+    ASSERT_NEAR(1.0, min.first, 10*eps);
+    ASSERT_NEAR(-1.0, min.second, 10*eps);
+}
+
+
+/*!
+ * Checks the closed-form integral of the squared spline curve against 
+ * analytical results for a cubic Bezier curve and for a piecewise linear 
+ * curve, including the contribution of the constant extrapolation regions.
+ */
+TEST_F(SplineCurve1DTest, SplineCurve1DIntegrateSquareTest)
+{
+    // floating point comparison threshold:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // cubic Bezier representation of f(s) = (s - 0.3)^2 + 0.5:
+    std::vector<real> knots = {0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0};
+    std::vector<real> ctrlPoints = {0.59, 0.39, 0.59 - 0.4 + 1.0/3.0, 0.99};
+    SplineCurve1D cubic(3, knots, ctrlPoints);
+
+    // integral of (u^2 + 0.5)^2 for u in [-0.3, 0.7]:
+    real integral = (std::pow(0.7, 5) + std::pow(0.3, 5))/5.0 +
+                    (std::pow(0.7, 3) + std::pow(0.3, 3))/3.0 + 
+                    0.25;
+    ASSERT_NEAR(integral, 
+                cubic.integrateSquare(std::make_pair(0.0, 1.0)), 
+                10*eps);
+
+    // extrapolation regions add squared boundary values:
+    ASSERT_NEAR(integral + 0.59*0.59 + 0.99*0.99, 
+                cubic.integrateSquare(std::make_pair(-1.0, 2.0)), 
+                10*eps);
+
+    // piecewise linear curve:
+    knots = {0.0, 0.0, 1.0, 2.0, 2.0};
+    ctrlPoints = {1.0, -1.0, 2.0};
+    SplineCurve1D linear(1, knots, ctrlPoints);
+    ASSERT_NEAR(4.0/3.0, 
+                linear.integrateSquare(std::make_pair(0.0, 2.0)), 
+                10*eps);
+    ASSERT_NEAR(1.0, 
+                linear.integrateSquare(std::make_pair(1.0, 2.0)), 
+                10*eps);
+}
@@ -440,6 +440,68 @@ TEST_F(SplineCurve3DTest, SplineCurve3DArcLengthReparameterisationTest)
 }
 
 
+/*!
+ * Tests the accuracy of arc length re-parameterisation on a helix, for which 
+ * the arc length is known analytically. After re-parameterisation, evaluating
+ * the curve at a given arc length must yield the same point as evaluating the
+ * helix at the corresponding original parameter value.
+ */
+TEST_F(SplineCurve3DTest, SplineCurve3DArcLengthInversionTest)
+{
+    // floating point comparison threshold:
+    real eps = 1e-4;
+
+    // define helix parameters:
+    const real PI = std::acos(-1.0);
+    real tStart = 0.0;
+    real tEnd = 2.0*PI;
+    real a = 1.573;
+    real b = 0.875/(tEnd - tStart);
+    real speed = std::sqrt(a*a + b*b);
+
+    // create a point set describing a helix:
+    size_t nParams = 50;
+    real paramStep = (tEnd - tStart) / (nParams - 1);
+    std::vector<real> params;
+    std::vector<gmx::RVec> points;
+    for(unsigned int i = 0; i < nParams; i++)
+    {
+        params.push_back(i*paramStep + tStart);
+        points.push_back(gmx::RVec(a*std::cos(params.back()),
+                                   a*std::sin(params.back()),
+                                   b*params.back())); 
+    }
+
+    // create spline by interpolation and re-parameterise:
+    CubicSplineInterp3D Interp;
+    SplineCurve3D SplC = Interp(params, points, eSplineInterpBoundaryHermite);
+    SplC.arcLengthParam();
+
+    // parameter range should now match analytical length:
+    ASSERT_NEAR((tEnd - tStart)*speed, SplC.length(), eps);
+    ASSERT_NEAR(0.0, SplC.frstPointArcLength(), eps);
+    ASSERT_NEAR((tEnd - tStart)*speed, SplC.lastPointArcLength(), eps);
+
+    // compare with helix at corresponding original parameter:
+    int nEval = 100;
+    for(int i = 0; i < nEval; i++)
+    {
+        // evaluation point in terms of arc length and original parameter:
+        real arcLength = i*(tEnd - tStart)*speed/(nEval - 1);
+        real t = arcLength/speed;
+
+        // evaluate spline and analytical expression at this point:
+        gmx::RVec splVal = SplC.evaluate(arcLength, 0);
+        gmx::RVec anaVal(a*std::cos(t), a*std::sin(t), b*t);
+
+        // these should be the same:
+        ASSERT_NEAR(anaVal[XX], splVal[XX], eps);
+        ASSERT_NEAR(anaVal[YY], splVal[YY], eps);
+        ASSERT_NEAR(anaVal[ZZ], splVal[ZZ], eps);
+    }
+}
+
+
 /*!
  * Test for the projection of points in Cartesian coordinates onto a spline 
  * curve. Two cases are considered: a linear spline curve and a spline curve 
@@ -719,3 +781,64 @@ TEST_F(SplineCurve3DTest, CartesianToCurvilinearExternalTest)
     }   
 }
 
+
+
+/*!
+ * Tests the angular coordinate returned by cartesianToCurvilinear() for a 
+ * straight line along the z-axis, where the rotation-minimising frame is 
+ * constant, both inside the curve's parameter range and in the extrapolation
+ * range. The frame normal is along the x-axis in this case, so that the 
+ * angular coordinate is the usual polar angle in the xy-plane. Also checks
+ * that the curve remains consistent after shifting its parameterisation.
+ */
+TEST_F(SplineCurve3DTest, CartesianToCurvilinearAngularTest)
+{
+    // floating point comparison threshold:
+    real eps = 10*std::numeric_limits<real>::epsilon();
+    const real PI = std::acos(-1.0);
+
+    // linear spline along z-axis:
+    int degree = 1;
+    std::vector<real> knots = {-2.0, -2.0, -1.0, 0.0, 1.0, 2.0, 2.0};
+    std::vector<gmx::RVec> f = {gmx::RVec( 0.0,  0.0, -2.0),
+                                gmx::RVec( 0.0,  0.0, -1.0),
+                                gmx::RVec( 0.0,  0.0,  0.0),
+                                gmx::RVec( 0.0,  0.0,  1.0),
+                                gmx::RVec( 0.0,  0.0,  2.0)};
+    SplineCurve3D Spl(degree, knots, f);
+
+    // test points and their polar angles:
+    std::vector<gmx::RVec> pts = {gmx::RVec( 1.0,  0.0, -1.0),
+                                  gmx::RVec( 0.0,  0.5,  0.3),
+                                  gmx::RVec(-2.0,  0.0,  1.7),
+                                  gmx::RVec( 0.0, -1.0,  0.0),
+                                  gmx::RVec( 1.0,  1.0,  3.5),
+                                  gmx::RVec(-1.0, -1.0, -4.0)};
+    std::vector<real> phiTrue = {0.0, 
+                                 PI/2.0, 
+                                 PI, 
+                                 -PI/2.0, 
+                                 PI/4.0, 
+                                 -3.0*PI/4.0};
+
+    // check angular coordinate:
+    for(size_t i = 0; i < pts.size(); i++)
+    {
+        gmx::RVec curvi = Spl.cartesianToCurvilinear(pts[i]);
+        ASSERT_NEAR(phiTrue[i], curvi[PP], eps);
+    }
+
+    // frame vectors are consistent with angular coordinate:
+    gmx::RVec normal = Spl.frameNormal(0.5);
+    gmx::RVec binormal = Spl.frameBinormal(0.5);
+    ASSERT_NEAR(1.0, normal[XX], eps);
+    ASSERT_NEAR(1.0, binormal[YY], eps);
+
+    // shifting parameterisation does not change angular coordinate:
+    Spl.shift(gmx::RVec(0.5, 0.0, 0.0));
+    for(size_t i = 0; i < pts.size(); i++)
+    {
+        gmx::RVec curvi = Spl.cartesianToCurvilinear(pts[i]);
+        ASSERT_NEAR(phiTrue[i], curvi[PP], eps);
+    }
+}
@@ -0,0 +1,166 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "geometry/spline_interp_workspace.hpp"
+
+
+/*!
+ * \brief Test fixture for the tridiagonal solver in SplineInterpWorkspace.
+ */
+class SplineInterpWorkspaceTest : public ::testing::Test
+{
+    public:
+
+        // multiply tridiagonal matrix with vector:
+        std::vector<real> multiply(
+                const std::vector<real> &subDiag,
+                const std::vector<real> &mainDiag,
+                const std::vector<real> &superDiag,
+                const std::vector<real> &x)
+        {
+            size_t n = mainDiag.size();
+            std::vector<real> b(n, 0.0);
+            for(size_t i = 0; i < n; i++)
+            {
+                b[i] += mainDiag[i]*x[i];
+                if( i > 0 )
+                {
+                    b[i] += subDiag[i - 1]*x[i - 1];
+                }
+                if( i + 1 < n )
+                {
+                    b[i] += superDiag[i]*x[i + 1];
+                }
+            }
+            return b;
+        }
+};
+
+
+/*!
+ * Solves a tridiagonal system with zero entries on the main diagonal, which 
+ * requires row interchanges, for several right hand sides at once. The 
+ * solution is checked against known solution vectors.
+ */
+TEST_F(SplineInterpWorkspaceTest, SplineInterpWorkspacePivotingMultiRhsTest)
+{
+    // floating point tolerance:
+    real eps = 10.0*std::sqrt(std::numeric_limits<real>::epsilon());
+
+    // system matrix with zero pivots in first and second-to-last rows:
+    std::vector<real> subDiag =   { 1.0,  0.3, -0.2,  0.0,  -1.5};
+    std::vector<real> mainDiag =  { 0.0,  2.0,  1.5,  0.7,   0.0,  1.5};
+    std::vector<real> superDiag = { 1.0, -0.4,  0.1,  0.5,   1.0};
+
+    // known solutions:
+    size_t nSys = mainDiag.size();
+    size_t nRhs = 3;
+    std::vector<std::vector<real>> solutions = {
+            {1.0, 2.0, 3.0, 4.0, 5.0, 6.0},
+            {-0.5, 0.0, 0.25, 1.0, -2.0, 0.0},
+            {0.1, -0.1, 0.2, -0.2, 0.3, -0.3}};
+
+    // set up workspace:
+    SplineInterpWorkspace ws;
+    ws.resize(nSys, nRhs);
+    std::copy(subDiag.begin(), subDiag.end(), ws.subDiag());
+    std::copy(mainDiag.begin(), mainDiag.end(), ws.mainDiag());
+    std::copy(superDiag.begin(), superDiag.end(), ws.superDiag());
+    for(size_t j = 0; j < nRhs; j++)
+    {
+        std::vector<real> b = multiply(
+                subDiag, mainDiag, superDiag, solutions[j]);
+        std::copy(b.begin(), b.end(), ws.rhs(j));
+    }
+
+    // solve and compare with known solution:
+    ws.solve();
+    for(size_t j = 0; j < nRhs; j++)
+    {
+        for(size_t i = 0; i < nSys; i++)
+        {
+            ASSERT_NEAR(solutions[j][i], ws.rhs(j)[i], eps);
+        }
+    }
+}
+
+
+/*!
+ * Checks that a singular system is reported by throwing an exception.
+ */
+TEST_F(SplineInterpWorkspaceTest, SplineInterpWorkspaceSingularTest)
+{
+    // system matrix with zero row:
+    std::vector<real> subDiag =   {0.0, 0.0};
+    std::vector<real> mainDiag =  {1.0, 0.0, 1.0};
+    std::vector<real> superDiag = {0.0, 0.0};
+    std::vector<real> rhs =       {1.0, 1.0, 1.0};
+
+    // set up workspace:
+    SplineInterpWorkspace ws;
+    ws.resize(mainDiag.size(), 1);
+    std::copy(subDiag.begin(), subDiag.end(), ws.subDiag());
+    std::copy(mainDiag.begin(), mainDiag.end(), ws.mainDiag());
+    std::copy(superDiag.begin(), superDiag.end(), ws.superDiag());
+    std::copy(rhs.begin(), rhs.end(), ws.rhs());
+
+    ASSERT_THROW(ws.solve(), std::runtime_error);
+}
+
+
+/*!
+ * Checks that a system consisting of a single equation is solved for several
+ * right hand sides and that a zero coefficient is reported as singular.
+ */
+TEST_F(SplineInterpWorkspaceTest, SplineInterpWorkspaceSingleEquationTest)
+{
+    // floating point tolerance:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // single equation with two right hand sides:
+    SplineInterpWorkspace ws;
+    ws.resize(1, 2);
+    ws.mainDiag()[0] = 4.0;
+    ws.rhs(0)[0] = 2.0;
+    ws.rhs(1)[0] = -1.0;
+
+    // solve and compare with known solution:
+    ws.solve();
+    ASSERT_NEAR(0.5, ws.rhs(0)[0], eps);
+    ASSERT_NEAR(-0.25, ws.rhs(1)[0], eps);
+
+    // zero coefficient is singular:
+    ws.resize(1, 1);
+    ws.mainDiag()[0] = 0.0;
+    ws.rhs()[0] = 1.0;
+    ASSERT_THROW(ws.solve(), std::runtime_error);
+}
@@ -0,0 +1,176 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gromacs/analysisdata/analysisdata.h>
+#include <gromacs/analysisdata/paralleloptions.h>
+
+#include "external/rapidjson/document.h"
+
+#include "io/analysis_data_json_frame_exporter.hpp"
+#include "io/compressed_file_read_stream.hpp"
+#include "io/json_column_codec.hpp"
+
+
+/*!
+ * \brief Test fixture for AnalysisDataJsonFrameExporter.
+ *
+ * Feeds frames through a gmx::AnalysisData object in the same way as the 
+ * trajectory analysis module does, i.e. with multipoint data sets that are 
+ * filled point set by point set.
+ */
+class AnalysisDataJsonFrameExporterTest : public ::testing::Test
+{
+    protected:
+
+        /*!
+         * Writes the given number of frames to file, where the first data set
+         * holds two points with two columns and the second data set holds a 
+         * single point with one (bit-packed) column. Returns the exporter.
+         */
+        AnalysisDataJsonFrameExporterPointer writeFrames(
+                const std::string &fileName,
+                int numFrames,
+                int flushInterval)
+        {
+            // set up data container:
+            gmx::AnalysisData data;
+            data.setMultipoint(true);
+            data.setDataSetCount(2);
+            data.setColumnCount(0, 2);
+            data.setColumnCount(1, 1);
+
+            // set up exporter:
+            AnalysisDataJsonFrameExporterPointer exporter(
+                    new AnalysisDataJsonFrameExporter);
+            exporter -> setFileName(fileName);
+            exporter -> setDataSetNames({"points", "flags"});
+            exporter -> setColumnNames({{"x", "y"}, {"on"}});
+            exporter -> setColumnCodecs(
+                    {{}, {JsonColumnCodec(eColumnEncodingBitPacked)}});
+            exporter -> setFlushInterval(flushInterval);
+            exporter -> setBufferSize(64);
+            data.addModule(exporter);
+
+            // add frames:
+            gmx::AnalysisDataHandle handle = data.startData(
+                    gmx::AnalysisDataParallelOptions());
+            for(int i = 0; i < numFrames; i++)
+            {
+                handle.startFrame(i, 10.0*i);
+                handle.selectDataSet(0);
+                for(int j = 0; j < 2; j++)
+                {
+                    handle.setPoint(0, i + j);
+                    handle.setPoint(1, -i - j);
+                    handle.finishPointSet();
+                }
+                handle.selectDataSet(1);
+                handle.setPoint(0, i % 2);
+                handle.finishPointSet();
+                handle.finishFrame();
+            }
+            data.finishData(handle);
+
+            return exporter;
+        }
+
+        /*!
+         * Checks that the file contains one line per frame with the data 
+         * written by writeFrames().
+         */
+        void checkFrames(
+                const std::string &fileName,
+                int numFrames)
+        {
+            CompressedFileReadStream stream(fileName);
+            std::string line;
+            int numLines = 0;
+            while( stream.getline(line) )
+            {
+                rapidjson::Document doc;
+                doc.Parse(line.c_str());
+                ASSERT_TRUE(doc.IsObject());
+
+                int i = numLines;
+                ASSERT_EQ(i, doc["i"].GetInt());
+                ASSERT_DOUBLE_EQ(10.0*i, doc["t"].GetDouble());
+
+                const rapidjson::Value &x = doc["points"]["x"];
+                const rapidjson::Value &y = doc["points"]["y"];
+                ASSERT_EQ(2u, x.Size());
+                ASSERT_EQ(2u, y.Size());
+                for(int j = 0; j < 2; j++)
+                {
+                    ASSERT_DOUBLE_EQ(i + j, x[j].GetDouble());
+                    ASSERT_DOUBLE_EQ(-i - j, y[j].GetDouble());
+                }
+
+                std::vector<real> on = JsonColumnCodec::decode(
+                        doc["flags"]["on"]);
+                ASSERT_EQ(1u, on.size());
+                ASSERT_EQ(static_cast<real>(i % 2), on[0]);
+
+                numLines++;
+            }
+            ASSERT_EQ(numFrames, numLines);
+        }
+};
+
+
+/*!
+ * Writes frames with different flush intervals to plain and compressed files
+ * and checks that the data is only flushed to disk at the flush interval
+ * (rather than after every frame) and that each line holds one frame.
+ */
+TEST_F(AnalysisDataJsonFrameExporterTest, 
+       AnalysisDataJsonFrameExporterFlushIntervalTest)
+{
+    const size_t numFrames = 25;
+    for(auto fileName : {"test_json_frame_exporter.json",
+                         "test_json_frame_exporter.json.gz"})
+    {
+        // flush every ten frames:
+        auto exporter = writeFrames(fileName, numFrames, 10);
+        ASSERT_EQ(numFrames/10, exporter -> numSyncs());
+        checkFrames(fileName, numFrames);
+
+        // flush every frame:
+        exporter = writeFrames(fileName, numFrames, 1);
+        ASSERT_EQ(numFrames, exporter -> numSyncs());
+        checkFrames(fileName, numFrames);
+
+        // flush only when buffer is full:
+        exporter = writeFrames(fileName, numFrames, 0);
+        ASSERT_EQ(0u, exporter -> numSyncs());
+        checkFrames(fileName, numFrames);
+
+        std::remove(fileName);
+    }
+}
@@ -0,0 +1,205 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "external/rapidjson/document.h"
+#include "external/rapidjson/writer.h"
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/compressed_file_write_stream.hpp"
+
+
+/*!
+ * \brief Test fixture for CompressedFileWriteStream and 
+ * CompressedFileReadStream.
+ *
+ * Creates a set of lines that is large compared to the buffer size used in 
+ * the tests, so that several buffers are handed over to the worker thread.
+ */
+class CompressedFileStreamTest : public ::testing::Test
+{
+    public:
+
+        // constructor for creating test data:
+        CompressedFileStreamTest()
+        {
+            for(size_t i = 0; i < 1000; i++)
+            {
+                lines_.push_back(
+                        "{\"i\":" + std::to_string(i) + 
+                        ",\"data\":\"" + std::string(i % 97, 'x') + "\"}");
+            }
+        }
+
+    protected:
+
+        // test data:
+        std::vector<std::string> lines_;
+
+        // writes test data to file, flushing in between:
+        void writeLines(
+                const std::string &fileName)
+        {
+            CompressedFileWriteStream stream(fileName, 256);
+            for(size_t i = 0; i < lines_.size(); i++)
+            {
+                stream.write(lines_[i].c_str(), lines_[i].size());
+                stream.Put('\n');
+                if( i % 100 == 0 )
+                {
+                    stream.sync();
+                }
+            }
+            stream.close();
+        }
+
+        // checks that file content is equal to test data:
+        void checkLines(
+                const std::string &fileName)
+        {
+            CompressedFileReadStream stream(fileName, 64);
+            std::string line;
+            size_t numLines = 0;
+            while( stream.getline(line) )
+            {
+                ASSERT_LT(numLines, lines_.size());
+                ASSERT_EQ(lines_[numLines], line);
+                numLines++;
+            }
+            ASSERT_EQ(lines_.size(), numLines);
+        }
+};
+
+
+/*!
+ * Checks that compression is selected by file extension.
+ */
+TEST_F(CompressedFileStreamTest, CompressedFileStreamExtensionTest)
+{
+    ASSERT_TRUE(CompressedFileWriteStream::isCompressedFileName("a.json.gz"));
+    ASSERT_FALSE(CompressedFileWriteStream::isCompressedFileName("a.json"));
+    ASSERT_FALSE(CompressedFileWriteStream::isCompressedFileName("gz"));
+}
+
+
+/*!
+ * Checks that uncompressed and compressed files can be written and read back
+ * line by line and that compressed files are actually compressed.
+ */
+TEST_F(CompressedFileStreamTest, CompressedFileStreamRoundTripTest)
+{
+    std::string plainName = "test_compressed_file_stream.json";
+    std::string gzipName = "test_compressed_file_stream.json.gz";
+
+    // write and read back both files:
+    writeLines(plainName);
+    writeLines(gzipName);
+    checkLines(plainName);
+    checkLines(gzipName);
+
+    // whole file content is identical:
+    CompressedFileReadStream plain(plainName);
+    CompressedFileReadStream gzip(gzipName);
+    std::string plainContent = plain.readAll();
+    ASSERT_EQ(plainContent, gzip.readAll());
+
+    // compressed file is smaller:
+    std::FILE *file = std::fopen(gzipName.c_str(), "rb");
+    std::fseek(file, 0, SEEK_END);
+    long gzipSize = std::ftell(file);
+    std::fclose(file);
+    ASSERT_LT(gzipSize, static_cast<long>(plainContent.size()/2));
+
+    // clean up:
+    std::remove(plainName.c_str());
+    std::remove(gzipName.c_str());
+}
+
+
+/*!
+ * Checks that opening a nonexistent file throws.
+ */
+TEST_F(CompressedFileStreamTest, CompressedFileStreamMissingFileTest)
+{
+    ASSERT_THROW(
+            CompressedFileReadStream("nonexistent/file.json.gz"), 
+            std::runtime_error);
+    ASSERT_THROW(
+            CompressedFileWriteStream("nonexistent/file.json.gz"), 
+            std::runtime_error);
+}
+
+
+
+/*!
+ * Writes many small and repetitive JSON documents through a rapidjson::Writer
+ * in the same way as the per-frame exporter does. The Flush() calls made by 
+ * the writer after each document must not force data to disk, so that only 
+ * the explicit sync() calls are counted and compression remains effective.
+ */
+TEST_F(CompressedFileStreamTest, CompressedFileStreamWriterFlushTest)
+{
+    std::string gzipName = "test_compressed_file_stream_writer.json.gz";
+    int numFrames = 1000;
+    int syncInterval = 100;
+
+    // repetitive frame document:
+    rapidjson::Document doc;
+    doc.Parse("{\"i\":0,\"data\":[1.0,2.0,3.0,4.0,5.0]}");
+
+    // write one document per line, syncing at fixed interval:
+    CompressedFileWriteStream stream(gzipName);
+    rapidjson::Writer<CompressedFileWriteStream> writer;
+    for(int i = 0; i < numFrames; i++)
+    {
+        writer.Reset(stream);
+        doc.Accept(writer);
+        stream.Put('\n');
+        if( (i + 1) % syncInterval == 0 )
+        {
+            stream.sync();
+        }
+    }
+    ASSERT_EQ(numFrames/syncInterval, stream.numSyncs());
+    stream.close();
+
+    // data can be read back:
+    std::string content = CompressedFileReadStream(gzipName).readAll();
+    ASSERT_EQ(numFrames, std::count(content.begin(), content.end(), '\n'));
+
+    // repetitive input compresses well:
+    std::FILE *file = std::fopen(gzipName.c_str(), "rb");
+    std::fseek(file, 0, SEEK_END);
+    long gzipSize = std::ftell(file);
+    std::fclose(file);
+    ASSERT_LT(gzipSize, static_cast<long>(content.size()/10));
+
+    // clean up:
+    std::remove(gzipName.c_str());
+}
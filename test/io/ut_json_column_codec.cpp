@@ -0,0 +1,194 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "external/rapidjson/stringbuffer.h"
+#include "external/rapidjson/writer.h"
+
+#include "io/json_column_codec.hpp"
+
+
+/*!
+ * \brief Test fixture for JsonColumnCodec.
+ */
+class JsonColumnCodecTest : public ::testing::Test
+{
+    public:
+
+        /*!
+         * Encodes the given values into a column inside a JSON document, 
+         * serialises and parses the document, and returns the decoded values
+         * along with the serialised string.
+         */
+        std::vector<real> roundTrip(
+                JsonColumnCodec codec,
+                const std::vector<real> &values,
+                std::string &serialised)
+        {
+            // build document holding a single column:
+            rapidjson::Document doc;
+            doc.SetObject();
+            rapidjson::Value column = codec.makeColumn(doc.GetAllocator());
+            doc.AddMember("col", column, doc.GetAllocator());
+            codec.attach(doc["col"]);
+
+            // fill column twice to check that clearing resets the state:
+            for(int pass = 0; pass < 2; pass++)
+            {
+                codec.clear();
+                for(auto val : values)
+                {
+                    codec.append(val, doc.GetAllocator());
+                }
+            }
+            EXPECT_EQ(values.size(), codec.size());
+
+            // serialise and parse again:
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            doc.Accept(writer);
+            serialised = buffer.GetString();
+            rapidjson::Document parsed;
+            parsed.Parse(serialised.c_str());
+
+            return JsonColumnCodec::decode(parsed["col"]);
+        }
+};
+
+
+/*!
+ * Plain columns are written as arrays and reproduce values exactly.
+ */
+TEST_F(JsonColumnCodecTest, JsonColumnCodecPlainTest)
+{
+    std::vector<real> values = {1.23456f, -0.5f, 1e6f};
+    std::string serialised;
+    std::vector<real> decoded = roundTrip(
+            JsonColumnCodec(), values, serialised);
+
+    ASSERT_EQ(0, serialised.find("{\"col\":["));
+    ASSERT_EQ(values.size(), decoded.size());
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_FLOAT_EQ(values[i], decoded[i]);
+    }
+}
+
+
+/*!
+ * Quantised columns reproduce values to within half a quantum and are written
+ * as integers.
+ */
+TEST_F(JsonColumnCodecTest, JsonColumnCodecQuantisedTest)
+{
+    real quantum = 0.001;
+    std::vector<real> values = {1.23456f, -7.89012f, 0.0f, 0.0004f, 12.3456f};
+    std::string serialised;
+    std::vector<real> decoded = roundTrip(
+            JsonColumnCodec(eColumnEncodingQuantised, quantum), 
+            values, 
+            serialised);
+
+    ASSERT_NE(std::string::npos, serialised.find("\"data\":[1235,-7890,0,0,12346]"));
+    ASSERT_EQ(values.size(), decoded.size());
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_NEAR(values[i], decoded[i], 0.5*quantum + 1e-6);
+    }
+
+    // quantum must be positive:
+    ASSERT_THROW(JsonColumnCodec(eColumnEncodingQuantised, 0.0), 
+                 std::logic_error);
+}
+
+
+/*!
+ * Delta encoded columns store differences between successive integers.
+ */
+TEST_F(JsonColumnCodecTest, JsonColumnCodecDeltaTest)
+{
+    std::vector<real> values = {1000, 1001, 1002, 1005, 998, 2000};
+    std::string serialised;
+    std::vector<real> decoded = roundTrip(
+            JsonColumnCodec(eColumnEncodingDelta), values, serialised);
+
+    ASSERT_NE(std::string::npos, serialised.find("\"data\":[1000,1,1,3,-7,1002]"));
+    ASSERT_EQ(values.size(), decoded.size());
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], decoded[i]);
+    }
+}
+
+
+/*!
+ * Bit-packed columns store 32 flags per integer, including a partially filled
+ * last word.
+ */
+TEST_F(JsonColumnCodecTest, JsonColumnCodecBitPackedTest)
+{
+    std::vector<real> values;
+    for(int i = 0; i < 70; i++)
+    {
+        values.push_back( (i % 3 == 0) ? 1.0 : 0.0 );
+    }
+    std::string serialised;
+    std::vector<real> decoded = roundTrip(
+            JsonColumnCodec(eColumnEncodingBitPacked), values, serialised);
+
+    ASSERT_NE(std::string::npos, serialised.find("\"size\":70"));
+    ASSERT_EQ(values.size(), decoded.size());
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], decoded[i]);
+    }
+
+    // three words for 70 flags:
+    rapidjson::Document doc;
+    doc.Parse(serialised.c_str());
+    ASSERT_EQ(3, doc["col"]["data"].Size());
+}
+
+
+/*!
+ * Malformed columns are rejected when decoding.
+ */
+TEST_F(JsonColumnCodecTest, JsonColumnCodecInvalidTest)
+{
+    rapidjson::Document doc;
+    doc.Parse("{\"a\":{\"encoding\":\"zip\",\"data\":[]},"
+              "\"b\":{\"data\":[]},"
+              "\"c\":{\"encoding\":\"bits\",\"size\":40,\"data\":[1]},"
+              "\"d\":3}");
+    ASSERT_THROW(JsonColumnCodec::decode(doc["a"]), std::runtime_error);
+    ASSERT_THROW(JsonColumnCodec::decode(doc["b"]), std::runtime_error);
+    ASSERT_THROW(JsonColumnCodec::decode(doc["c"]), std::runtime_error);
+    ASSERT_THROW(JsonColumnCodec::decode(doc["d"]), std::runtime_error);
+}
+
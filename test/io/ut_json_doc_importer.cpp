@@ -0,0 +1,105 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_write_stream.hpp"
+#include "io/json_doc_importer.hpp"
+
+
+/*!
+ * \brief Test fixture for JsonDocImporter.
+ */
+class JsonDocImporterTest : public ::testing::Test
+{
+    protected:
+
+        // writes a string to a (possibly compressed) file:
+        void writeFile(
+                const std::string &fileName, 
+                const std::string &content)
+        {
+            CompressedFileWriteStream stream(fileName);
+            stream.write(content.c_str(), content.size());
+            stream.close();
+        }
+};
+
+
+/*!
+ * Imports plain and gzip compressed files and checks that the string values
+ * of the returned documents remain valid after the importer has been 
+ * destroyed and the documents have been moved.
+ */
+TEST_F(JsonDocImporterTest, JsonDocImporterOwnershipTest)
+{
+    std::string content = "{\"name\": \"hydrophobicity\", "
+                          "\"values\": [{\"resname\": \"ALA\", \"h\": 0.5}]}";
+    std::vector<std::string> fileNames = {"test_json_doc_importer.json", 
+                                          "test_json_doc_importer.json.gz"};
+
+    // import files with an importer that goes out of scope:
+    std::vector<ImportedJsonDoc> docs;
+    {
+        JsonDocImporter import;
+        for(auto &fileName : fileNames)
+        {
+            writeFile(fileName, content);
+            docs.push_back(import(fileName));
+            std::remove(fileName.c_str());
+        }
+    }
+
+    // string values are still accessible:
+    for(auto &json : docs)
+    {
+        ASSERT_TRUE(json.doc_.IsObject());
+        ASSERT_STREQ("hydrophobicity", json.doc_["name"].GetString());
+        ASSERT_STREQ("ALA", json.doc_["values"][0]["resname"].GetString());
+        ASSERT_DOUBLE_EQ(0.5, json.doc_["values"][0]["h"].GetDouble());
+    }
+}
+
+
+/*!
+ * Checks that missing files and input that is not a JSON object are 
+ * rejected.
+ */
+TEST_F(JsonDocImporterTest, JsonDocImporterInvalidInputTest)
+{
+    JsonDocImporter import;
+    ASSERT_THROW(
+            import("test_json_doc_importer_nonexistent.json"), 
+            std::runtime_error);
+
+    std::string fileName = "test_json_doc_importer_invalid.json.gz";
+    writeFile(fileName, "[1, 2, 3]");
+    ASSERT_THROW(import(fileName), std::invalid_argument);
+    std::remove(fileName.c_str());
+}
@@ -139,3 +139,111 @@ TEST_F(MolecularPathObjExporterTest, MolecularPathObjExporterAxisRotationTest)
     ASSERT_NEAR( vec[ZZ], rotZ[ZZ], 10*eps);
 }
 
+
+
+/*!
+ * Tests that properties in a RegularVertexGrid are interned in insertion 
+ * order and that faces reference the vertices of the correct property.
+ */
+TEST_F(MolecularPathObjExporterTest, RegularVertexGridPropertyIndexTest)
+{
+    // small cylindrical grid:
+    std::vector<real> s = {0.0, 1.0, 2.0};
+    std::vector<real> phi = {0.0, 2.0*M_PI/3.0, 4.0*M_PI/3.0};
+    RegularVertexGrid grid(s, phi);
+
+    // properties in non-alphabetical order:
+    std::vector<std::string> props = {"zeta", "alpha"};
+    for(size_t p = 0; p < props.size(); p++)
+    {
+        ASSERT_EQ(p, grid.addProperty(props[p]));
+        ASSERT_EQ(p, grid.addProperty(props[p]));
+        ASSERT_EQ(p, grid.propertyId(props[p]));
+    }
+    ASSERT_THROW(grid.propertyId("beta"), std::logic_error);
+
+    // incomplete grid can not be triangulated:
+    ASSERT_THROW(grid.faces("zeta"), std::logic_error);
+
+    // add vertices on cylinder surface:
+    for(size_t p = 0; p < props.size(); p++)
+    {
+        for(size_t i = 0; i < s.size(); i++)
+        {
+            for(size_t j = 0; j < phi.size(); j++)
+            {
+                gmx::RVec vert(std::cos(phi[j]), std::sin(phi[j]), s[i]);
+                grid.addVertex(i, j, props[p], vert, s[i]/s.back());
+            }
+        }
+    }
+    grid.normalsFromFaces();
+
+    // vertices are linearly indexed with angular index running fastest:
+    auto vert = grid.vertices("alpha");
+    ASSERT_EQ(s.size()*phi.size(), vert.size());
+    ASSERT_NEAR(s[1], vert[phi.size()][ZZ], std::numeric_limits<real>::epsilon());
+
+    // faces of second property are offset by size of first property grid:
+    size_t numVert = s.size()*phi.size();
+    for(size_t p = 0; p < props.size(); p++)
+    {
+        auto faces = grid.faces(props[p]);
+        ASSERT_EQ(2*(s.size() - 1)*phi.size(), faces.size());
+        for(auto face : faces)
+        {
+            for(int k = 0; k < face.numVertices(); k++)
+            {
+                ASSERT_GT(face.vertexIdx(k), p*numVert);
+                ASSERT_LE(face.vertexIdx(k), (p + 1)*numVert);
+            }
+        }
+    }
+}
+
+
+/*!
+ * Checks that the surface vertices generated with several threads are 
+ * identical to those generated serially, for a curved pathway with varying 
+ * radius on which the clash correction is active.
+ */
+TEST_F(MolecularPathObjExporterTest, MolecularPathObjExporterThreadingTest)
+{
+    // pathway along a circular arc with varying radius:
+    std::vector<gmx::RVec> pathPoints;
+    std::vector<real> pathRadii;
+    int numPoints = 21;
+    for(int i = 0; i < numPoints; i++)
+    {
+        real angle = 1.5*i/(numPoints - 1);
+        pathPoints.push_back(gmx::RVec(
+                2.0*std::cos(angle), 
+                2.0*std::sin(angle), 
+                0.1*i));
+        pathRadii.push_back(0.6 + 0.3*std::sin(2.0*angle));
+    }
+    MolecularPath molPath(pathPoints, pathRadii);
+
+    // generate surface serially and in parallel:
+    std::vector<std::vector<gmx::RVec>> surfaces;
+    for(int numThreads : {1, 4})
+    {
+        MolecularPathObjExporter molPathExp;
+        molPathExp.setGridSampleDist(0.01);
+        molPathExp.setExtrapDist(0.5);
+        molPathExp.setNumThreads(numThreads);
+        surfaces.push_back(molPathExp.surfaceVertices(molPath));
+    }
+
+    // vertices must be identical:
+    auto res = MolecularPathObjExporter().resolution();
+    ASSERT_EQ(res.first*res.second, surfaces[0].size());
+    ASSERT_EQ(surfaces[0].size(), surfaces[1].size());
+    for(size_t i = 0; i < surfaces[0].size(); i++)
+    {
+        for(int j = 0; j < 3; j++)
+        {
+            ASSERT_EQ(surfaces[0][i][j], surfaces[1][i][j]);
+        }
+    }
+}
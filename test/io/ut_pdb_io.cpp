@@ -0,0 +1,219 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/pdb_io.hpp"
+
+
+/*!
+ * \brief Test fixture for PdbTrajectoryWriter.
+ *
+ * Sets up a small structure of three atoms in two residues. The atom and 
+ * residue records are assembled by hand rather than read from a topology 
+ * file, so the fixture owns all name strings.
+ */
+class PdbTrajectoryWriterTest : public ::testing::Test
+{
+    public:
+
+        // constructor sets up atoms and residues:
+        PdbTrajectoryWriterTest()
+            : atomNameStrings_{"N", "CA", "HD21"}
+            , resNameStrings_{"ALA", "ASN"}
+        {
+            for(auto &name : atomNameStrings_)
+            {
+                atomNames_.push_back(&name[0]);
+            }
+            for(auto &name : resNameStrings_)
+            {
+                resNames_.push_back(&name[0]);
+            }
+
+            // residues 7 and 8 of chain A:
+            resinfo_.resize(2, t_resinfo());
+            for(size_t i = 0; i < resinfo_.size(); i++)
+            {
+                resinfo_[i].name = &resNames_[i];
+                resinfo_[i].nr = 7 + i;
+                resinfo_[i].ic = ' ';
+                resinfo_[i].chainid = 'A';
+            }
+
+            // first two atoms in first residue, third atom in second residue:
+            atom_.resize(3, t_atom());
+            atom_[0].resind = 0;
+            atom_[1].resind = 0;
+            atom_[2].resind = 1;
+            for(size_t i = 0; i < atom_.size(); i++)
+            {
+                atomNamePtrs_.push_back(&atomNames_[i]);
+            }
+        }
+
+        // creates structure referring to the fixture's atoms and residues:
+        PdbStructure structure()
+        {
+            t_atoms atoms = t_atoms();
+            atoms.nr = atom_.size();
+            atoms.atom = atom_.data();
+            atoms.atomname = atomNamePtrs_.data();
+            atoms.nres = resinfo_.size();
+            atoms.resinfo = resinfo_.data();
+            atoms.pdbinfo = nullptr;
+
+            PdbStructure structure;
+            structure.fromAtoms(atoms);
+            return structure;
+        }
+
+        // splits string into lines:
+        std::vector<std::string> lines(const std::string &str)
+        {
+            std::vector<std::string> result;
+            std::istringstream stream(str);
+            std::string line;
+            while( std::getline(stream, line) )
+            {
+                result.push_back(line);
+            }
+            return result;
+        }
+
+    private:
+
+        // names and the pointer indirections used by Gromacs:
+        std::vector<std::string> atomNameStrings_;
+        std::vector<std::string> resNameStrings_;
+        std::vector<char*> atomNames_;
+        std::vector<char*> resNames_;
+        std::vector<char**> atomNamePtrs_;
+
+        // atom and residue records:
+        std::vector<t_atom> atom_;
+        std::vector<t_resinfo> resinfo_;
+};
+
+
+/*!
+ * Writes two models, the first with and the second without a unit cell, and
+ * checks MODEL/ENDMDL framing, the width of all records, and the position of
+ * each field in the fixed-column ATOM records.
+ */
+TEST_F(PdbTrajectoryWriterTest, PdbTrajectoryWriterTwoModelTest)
+{
+    std::string fileName = "test_pdb_trajectory_writer.pdb";
+
+    // coordinates in nm and per-residue flags:
+    rvec coordsA[3] = {{0.1, 0.2, 0.3}, {-1.0, 2.5, 10.0}, {0.0, 0.0, -0.5}};
+    rvec coordsB[3] = {{1.0, 1.0, 1.0}, {2.0, 2.0, 2.0}, {3.0, 3.0, 3.0}};
+    matrix box = {{5.0, 0.0, 0.0}, {0.0, 6.0, 0.0}, {0.0, 0.0, 7.0}};
+    matrix noBox = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+    std::vector<real> poreLining = {1.0, 0.0};
+    std::vector<real> poreFacing = {0.0, 1.0};
+
+    // write two models:
+    PdbTrajectoryWriter writer(fileName, structure());
+    writer.writeModel(coordsA, 3, box, poreLining, poreFacing);
+    writer.writeModel(coordsB, 3, noBox, {1.0}, {1.0});
+    ASSERT_EQ(2, writer.numModels());
+    writer.close();
+
+    // read file back:
+    std::vector<std::string> pdb = lines(
+            CompressedFileReadStream(fileName).readAll());
+    std::remove(fileName.c_str());
+
+    // too few atoms are rejected:
+    std::string invalidFileName = "test_pdb_trajectory_writer_invalid.pdb";
+    PdbTrajectoryWriter invalidWriter(invalidFileName, structure());
+    ASSERT_THROW(
+            invalidWriter.writeModel(coordsA, 2, box, poreLining, poreFacing),
+            std::runtime_error);
+    invalidWriter.close();
+    std::remove(invalidFileName.c_str());
+
+    // overall framing:
+    std::vector<std::string> expectedRecords = {
+            "TITLE ", "CRYST1", 
+            "MODEL ", "ATOM  ", "ATOM  ", "ATOM  ", "TER", "ENDMDL",
+            "MODEL ", "ATOM  ", "ATOM  ", "ATOM  ", "TER", "ENDMDL",
+            "END"};
+    ASSERT_EQ(expectedRecords.size(), pdb.size());
+    for(size_t i = 0; i < pdb.size(); i++)
+    {
+        ASSERT_EQ(0, pdb[i].find(expectedRecords[i]));
+    }
+    ASSERT_EQ("END", pdb.back());
+
+    // unit cell in Angstrom and degrees:
+    ASSERT_EQ(
+            "CRYST1   50.000   60.000   70.000  90.00  90.00  90.00 P 1           1",
+            pdb[1]);
+
+    // model serial numbers right-aligned in columns 11-14:
+    ASSERT_EQ("MODEL        1", pdb[2]);
+    ASSERT_EQ("MODEL        2", pdb[8]);
+
+    // all atom records span exactly 66 columns:
+    std::vector<size_t> atomLines = {3, 4, 5, 9, 10, 11};
+    for(auto i : atomLines)
+    {
+        ASSERT_EQ(66, pdb[i].size());
+    }
+
+    // fields of second atom in first model:
+    const std::string &atom = pdb[4];
+    ASSERT_EQ("    2", atom.substr(6, 5));      // serial
+    ASSERT_EQ(" CA ", atom.substr(12, 4));      // atom name
+    ASSERT_EQ("ALA", atom.substr(17, 3));       // residue name
+    ASSERT_EQ('A', atom[21]);                   // chain identifier
+    ASSERT_EQ("   7", atom.substr(22, 4));      // residue number
+    ASSERT_EQ(" -10.000", atom.substr(30, 8));  // x
+    ASSERT_EQ("  25.000", atom.substr(38, 8));  // y
+    ASSERT_EQ(" 100.000", atom.substr(46, 8));  // z
+    ASSERT_EQ("  1.00", atom.substr(54, 6));    // occupancy = pore lining
+    ASSERT_EQ("  0.00", atom.substr(60, 6));    // B-factor = pore facing
+
+    // four character atom names start in column 13:
+    ASSERT_EQ("HD21", pdb[5].substr(12, 4));
+    ASSERT_EQ("ASN", pdb[5].substr(17, 3));
+    ASSERT_EQ("   8", pdb[5].substr(22, 4));
+    ASSERT_EQ("  0.00", pdb[5].substr(54, 6));
+    ASSERT_EQ("  1.00", pdb[5].substr(60, 6));
+
+    // residues without flags are assigned zero:
+    ASSERT_EQ("  1.00", pdb[10].substr(54, 6));
+    ASSERT_EQ("  0.00", pdb[11].substr(54, 6));
+    ASSERT_EQ("  0.00", pdb[11].substr(60, 6));
+}
+
@@ -0,0 +1,108 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/ply_io.hpp"
+
+
+/*!
+ * \brief Test fixture for PlyExporter.
+ */
+class PlyExporterTest : public ::testing::Test
+{
+
+};
+
+
+/*!
+ * Writes a single triangle with normals and one property and checks header 
+ * and binary body of the resulting file.
+ */
+TEST_F(PlyExporterTest, PlyExporterTriangleTest)
+{
+    // single triangle in xy-plane:
+    std::vector<gmx::RVec> vertices = {gmx::RVec(0.0, 0.0, 0.0),
+                                       gmx::RVec(1.0, 0.0, 0.0),
+                                       gmx::RVec(0.0, 1.0, 0.0)};
+    std::vector<gmx::RVec> normals(3, gmx::RVec(0.0, 0.0, 1.0));
+    std::vector<std::pair<std::string, std::vector<real>>> props;
+    props.push_back(std::make_pair("radius", std::vector<real>{0.1, 0.2, 0.3}));
+    std::vector<uint32_t> triangles = {0, 1, 2};
+
+    // invalid input is rejected:
+    PlyExporter ply;
+    std::string fileName = "test_ply_exporter.ply";
+    ASSERT_THROW(
+            ply.write(fileName, vertices, normals, props, {0, 1, 3}),
+            std::logic_error);
+    ASSERT_THROW(
+            ply.write(fileName, vertices, {gmx::RVec(0, 0, 1)}, props, triangles),
+            std::logic_error);
+
+    // write file and read it back in:
+    ply.write(fileName, vertices, normals, props, triangles);
+    std::string bytes = CompressedFileReadStream(fileName).readAll();
+    std::remove(fileName.c_str());
+
+    // check header:
+    std::string endHeader = "end_header\n";
+    size_t bodyPos = bytes.find(endHeader);
+    ASSERT_NE(std::string::npos, bodyPos);
+    std::string header = bytes.substr(0, bodyPos);
+    bodyPos += endHeader.size();
+    ASSERT_EQ(0, header.find("ply\nformat binary_little_endian 1.0\n"));
+    ASSERT_NE(std::string::npos, header.find("element vertex 3\n"));
+    ASSERT_NE(std::string::npos, header.find("property float nz\n"));
+    ASSERT_NE(std::string::npos, header.find("property float radius\n"));
+    ASSERT_NE(std::string::npos, header.find("element face 1\n"));
+
+    // check body size (seven floats per vertex, count and three indices per
+    // face):
+    ASSERT_EQ(bodyPos + 3*7*sizeof(float) + 1 + 3*sizeof(uint32_t), 
+              bytes.size());
+
+    // check second vertex:
+    float vertex[7];
+    std::memcpy(vertex, bytes.data() + bodyPos + 7*sizeof(float), sizeof(vertex));
+    ASSERT_FLOAT_EQ(1.0, vertex[0]);
+    ASSERT_FLOAT_EQ(0.0, vertex[1]);
+    ASSERT_FLOAT_EQ(1.0, vertex[5]);
+    ASSERT_FLOAT_EQ(0.2, vertex[6]);
+
+    // check face:
+    size_t facePos = bodyPos + 3*7*sizeof(float);
+    ASSERT_EQ(3, static_cast<unsigned char>(bytes[facePos]));
+    uint32_t idx[3];
+    std::memcpy(idx, bytes.data() + facePos + 1, sizeof(idx));
+    ASSERT_EQ(0, idx[0]);
+    ASSERT_EQ(1, idx[1]);
+    ASSERT_EQ(2, idx[2]);
+}
+
@@ -0,0 +1,176 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/results_json_exporter.hpp"
+
+
+/*!
+ * \brief Test fixture for ResultsJsonExporter.
+ */
+class ResultsJsonExporterTest : public ::testing::Test
+{
+    protected:
+
+        /*!
+         * Adds a small set of results covering all sections except the 
+         * residue summary (which needs topology information) to the given 
+         * exporter, in the order in which CHAP adds them.
+         */
+        void addResults(ResultsJsonExporter &results)
+        {
+            // samples over a few frames at a few support points:
+            std::vector<real> timeStamps = {0.0, 10.0, 20.0, 30.0, 40.0};
+            std::vector<real> supportPoints = {-1.0, 0.0, 1.0};
+            std::vector<std::vector<real>> radius;
+            for(size_t i = 0; i < timeStamps.size(); i++)
+            {
+                std::vector<real> frame;
+                for(auto s : supportPoints)
+                {
+                    frame.push_back(0.5 + 0.1*s*s + 0.01*i);
+                }
+                radius.push_back(frame);
+            }
+
+            // statistics over frames:
+            SummaryStatistics minRadius;
+            QuantileSketch minRadiusSketch;
+            BlockAverage minRadiusBlockAvg;
+            std::vector<SummaryStatistics> radiusSummary(supportPoints.size());
+            std::vector<QuantileSketch> radiusSketch(supportPoints.size());
+            std::vector<BlockAverage> radiusBlockAvg(supportPoints.size());
+            std::vector<real> minRadiusTimeSeries;
+            for(auto &frame : radius)
+            {
+                minRadius.update(frame[1]);
+                minRadiusSketch.update(frame[1]);
+                minRadiusBlockAvg.update(frame[1]);
+                SummaryStatistics::updateMultiple(radiusSummary, frame);
+                QuantileSketch::updateMultiple(radiusSketch, frame);
+                BlockAverage::updateMultiple(radiusBlockAvg, frame);
+                minRadiusTimeSeries.push_back(frame[1]);
+            }
+
+            // add to exporter:
+            results.addPathwaySummary("minRadius", minRadius);
+            results.addPathwayQuantiles("minRadius", minRadiusSketch);
+            results.addPathwayStandardError("minRadius", minRadiusBlockAvg);
+            results.addSupportPoints(supportPoints);
+            results.addPathwayProfile("radius", radiusSummary);
+            results.addPathwayProfileQuantiles("radius", radiusSketch);
+            results.addPathwayProfileStandardError("radius", radiusBlockAvg);
+            results.addPathwayProfile("radiusFirst", radius.front());
+            results.addTimeStamps(timeStamps);
+            results.addPathwayScalarTimeSeries(
+                    "minRadius", 
+                    minRadiusTimeSeries);
+            results.addPathwayGridPoints(timeStamps, supportPoints);
+            results.addPathwayProfileTimeSeries("radius", radius);
+        }
+};
+
+
+/*!
+ * Checks that the output written in streaming mode is byte for byte identical
+ * to the output written from the in-memory document, both for plain and 
+ * compressed output.
+ */
+TEST_F(ResultsJsonExporterTest, ResultsJsonExporterStreamingTest)
+{
+    // write output from in-memory document:
+    std::string memFileName = "test_results_json_exporter_mem.json";
+    ResultsJsonExporter memResults;
+    addResults(memResults);
+    memResults.write(memFileName);
+    std::string memOutput = CompressedFileReadStream(memFileName).readAll();
+    std::remove(memFileName.c_str());
+
+    // output contains all sections:
+    for(auto section : {"reproducibilityInformation",
+                        "pathwaySummary",
+                        "pathwayProfile",
+                        "pathwayScalarTimeSeries",
+                        "pathwayProfileTimeSeries",
+                        "residueSummary"})
+    {
+        ASSERT_NE(std::string::npos, memOutput.find(section));
+    }
+
+    // streamed output must be identical:
+    for(auto fileName : {"test_results_json_exporter_stream.json", 
+                         "test_results_json_exporter_stream.json.gz"})
+    {
+        ResultsJsonExporter streamResults;
+        streamResults.beginStreaming(fileName);
+        addResults(streamResults);
+        streamResults.finishStreaming();
+        std::string streamOutput = CompressedFileReadStream(fileName).readAll();
+        std::remove(fileName);
+
+        ASSERT_EQ(memOutput, streamOutput);
+    }
+}
+
+
+/*!
+ * Checks that inconsistent use of the exporter is rejected.
+ */
+TEST_F(ResultsJsonExporterTest, ResultsJsonExporterConsistencyTest)
+{
+    // profile can not be added before support points or with wrong size:
+    ResultsJsonExporter results;
+    std::vector<real> profile = {1.0, 2.0};
+    ASSERT_THROW(results.addPathwayProfile("p", profile), std::logic_error);
+    results.addSupportPoints({0.0, 1.0, 2.0});
+    ASSERT_THROW(results.addPathwayProfile("p", profile), std::logic_error);
+    profile.push_back(3.0);
+    results.addPathwayProfile("p", profile);
+
+    // streaming must start before data is added:
+    ASSERT_THROW(
+            results.beginStreaming("test_results_json_exporter_invalid.json"),
+            std::logic_error);
+
+    // in streaming mode, sections can not be revisited:
+    std::string fileName = "test_results_json_exporter_sections.json";
+    ResultsJsonExporter streamResults;
+    streamResults.beginStreaming(fileName);
+    SummaryStatistics summary;
+    summary.update(1.0);
+    streamResults.addPathwaySummary("a", summary);
+    streamResults.addSupportPoints({0.0});
+    ASSERT_THROW(
+            streamResults.addPathwaySummary("b", summary), 
+            std::logic_error);
+    ASSERT_THROW(streamResults.write(fileName), std::logic_error);
+    streamResults.finishStreaming();
+    std::remove(fileName.c_str());
+}
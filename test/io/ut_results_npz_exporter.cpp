@@ -0,0 +1,144 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/results_npz_exporter.hpp"
+
+
+/*!
+ * \brief Test fixture for ResultsNpzExporter.
+ */
+class ResultsNpzExporterTest : public ::testing::Test
+{
+    protected:
+
+        // reads little endian integers from a byte string:
+        uint32_t readUint32(const std::string &bytes, size_t pos)
+        {
+            uint32_t value = 0;
+            for(int i = 3; i >= 0; i--)
+            {
+                value = (value << 8) | static_cast<unsigned char>(bytes[pos + i]);
+            }
+            return value;
+        }
+        uint16_t readUint16(const std::string &bytes, size_t pos)
+        {
+            return static_cast<uint16_t>(
+                    static_cast<unsigned char>(bytes[pos]) | 
+                    (static_cast<unsigned char>(bytes[pos + 1]) << 8));
+        }
+};
+
+
+/*!
+ * Writes a one- and a two-dimensional array and checks the structure of the 
+ * resulting ZIP archive and NPY files as well as the stored data.
+ */
+TEST_F(ResultsNpzExporterTest, ResultsNpzExporterStructureTest)
+{
+    // write test file:
+    std::string fileName = "test_results_npz_exporter.npz";
+    std::vector<real> vec = {1.0, 2.0, 3.0};
+    std::vector<std::vector<real>> mat = {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}};
+    ResultsNpzExporter npz(fileName);
+    npz.addArray("group/vec", vec);
+    npz.addArray("mat", mat);
+    npz.close();
+
+    // read file back in:
+    std::string bytes = CompressedFileReadStream(fileName).readAll();
+    std::remove(fileName.c_str());
+
+    // end of central directory record lists both entries:
+    size_t eocd = bytes.size() - 22;
+    ASSERT_EQ(0x06054b50u, readUint32(bytes, eocd));
+    ASSERT_EQ(2, readUint16(bytes, eocd + 10));
+
+    // first local file header:
+    ASSERT_EQ(0x04034b50u, readUint32(bytes, 0));
+    uint32_t size = readUint32(bytes, 18);
+    uint16_t nameLen = readUint16(bytes, 26);
+    uint16_t extraLen = readUint16(bytes, 28);
+    ASSERT_EQ("group/vec.npy", bytes.substr(30, nameLen));
+
+    // NPY file starts at aligned offset, header describes 1D array:
+    size_t npy = 30 + nameLen + extraLen;
+    ASSERT_EQ(0u, npy % 64);
+    ASSERT_EQ(std::string("\x93NUMPY", 6), bytes.substr(npy, 6));
+    uint16_t headerLen = readUint16(bytes, npy + 8);
+    ASSERT_EQ(0u, (npy + 10u + headerLen) % 64);
+    std::string header = bytes.substr(npy + 10, headerLen);
+    ASSERT_NE(std::string::npos, header.find("'shape': (3,)"));
+    ASSERT_NE(std::string::npos, header.find(
+            "f" + std::to_string(sizeof(real))));
+
+    // data follows header:
+    ASSERT_EQ(10 + headerLen + vec.size()*sizeof(real), size);
+    ASSERT_EQ(0, std::memcmp(
+            bytes.data() + npy + 10 + headerLen, 
+            vec.data(), 
+            vec.size()*sizeof(real)));
+
+    // second entry describes two-dimensional array in row major order:
+    size_t second = npy + size;
+    ASSERT_EQ(0x04034b50u, readUint32(bytes, second));
+    nameLen = readUint16(bytes, second + 26);
+    extraLen = readUint16(bytes, second + 28);
+    ASSERT_EQ("mat.npy", bytes.substr(second + 30, nameLen));
+    npy = second + 30 + nameLen + extraLen;
+    ASSERT_EQ(0u, npy % 64);
+    headerLen = readUint16(bytes, npy + 8);
+    ASSERT_EQ(0u, (npy + 10u + headerLen) % 64);
+    header = bytes.substr(npy + 10, headerLen);
+    ASSERT_NE(std::string::npos, header.find("'shape': (3, 2)"));
+    for(size_t i = 0; i < mat.size(); i++)
+    {
+        ASSERT_EQ(0, std::memcmp(
+                bytes.data() + npy + 10 + headerLen + 2*i*sizeof(real), 
+                mat[i].data(), 
+                2*sizeof(real)));
+    }
+}
+
+
+/*!
+ * Checks that non-rectangular two-dimensional arrays are rejected.
+ */
+TEST_F(ResultsNpzExporterTest, ResultsNpzExporterRaggedArrayTest)
+{
+    std::string fileName = "test_results_npz_exporter_ragged.npz";
+    ResultsNpzExporter npz(fileName);
+    std::vector<std::vector<real>> ragged = {{1.0, 2.0}, {3.0}};
+    ASSERT_THROW(npz.addArray("ragged", ragged), std::logic_error);
+    npz.close();
+    std::remove(fileName.c_str());
+}
+
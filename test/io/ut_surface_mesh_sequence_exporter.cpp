@@ -0,0 +1,153 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "io/compressed_file_read_stream.hpp"
+#include "io/molecular_path_obj_exporter.hpp"
+#include "io/surface_mesh_sequence_exporter.hpp"
+
+
+/*!
+ * \brief Test fixture for SurfaceMeshSequenceExporter.
+ */
+class SurfaceMeshSequenceExporterTest : public ::testing::Test
+{
+    protected:
+
+        // reads little endian integer from a byte string:
+        uint32_t readUint32(const std::string &bytes, size_t pos)
+        {
+            uint32_t value = 0;
+            for(int i = 3; i >= 0; i--)
+            {
+                value = (value << 8) | static_cast<unsigned char>(bytes[pos + i]);
+            }
+            return value;
+        }
+};
+
+
+/*!
+ * Checks that the shared triangulation is the same as the one used by 
+ * RegularVertexGrid for the OBJ output.
+ */
+TEST_F(SurfaceMeshSequenceExporterTest, SurfaceMeshSequenceExporterTopologyTest)
+{
+    // regular grid with single property:
+    std::vector<real> s = {0.0, 1.0, 2.0, 3.0};
+    std::vector<real> phi = {0.0, 1.5, 3.0, 4.5};
+    RegularVertexGrid grid(s, phi);
+    for(size_t i = 0; i < s.size(); i++)
+    {
+        for(size_t j = 0; j < phi.size(); j++)
+        {
+            gmx::RVec vert(std::cos(phi[j]), std::sin(phi[j]), s[i]);
+            grid.addVertex(i, j, "radius", vert, s[i]);
+        }
+    }
+    auto faces = grid.faces("radius");
+
+    // triangles must match OBJ faces (which use one-based indices):
+    auto tri = SurfaceMeshSequenceExporter::triangles(s.size(), phi.size());
+    ASSERT_EQ(3*faces.size(), tri.size());
+    for(size_t f = 0; f < faces.size(); f++)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            ASSERT_EQ(faces[f].vertexIdx(k) - 1, tri[3*f + k]);
+        }
+    }
+}
+
+
+/*!
+ * Writes two frames and checks header, topology, and frame data in the 
+ * resulting file.
+ */
+TEST_F(SurfaceMeshSequenceExporterTest, SurfaceMeshSequenceExporterFileTest)
+{
+    // mesh dimensions:
+    size_t numLen = 3;
+    size_t numPhi = 4;
+    size_t numVert = numLen*numPhi;
+    size_t numTri = 2*(numLen - 1)*numPhi;
+
+    // write two frames to file:
+    std::string fileName = "test_surface_mesh_sequence_exporter.mesh";
+    SurfaceMeshSequenceExporter mesh(fileName, numLen, numPhi);
+    for(int t = 0; t < 2; t++)
+    {
+        std::vector<gmx::RVec> vertices;
+        for(size_t i = 0; i < numVert; i++)
+        {
+            vertices.push_back(gmx::RVec(0.1*i, 0.2*t, -0.3));
+        }
+        mesh.addFrame(10.0*t, vertices);
+    }
+    ASSERT_THROW(
+            mesh.addFrame(20.0, std::vector<gmx::RVec>(numVert - 1)), 
+            std::logic_error);
+    ASSERT_EQ(2, mesh.numFrames());
+    mesh.close();
+
+    // read file back in:
+    std::string bytes = CompressedFileReadStream(fileName).readAll();
+    std::remove(fileName.c_str());
+
+    // check header:
+    size_t frameSize = (1 + 3*numVert)*sizeof(float);
+    size_t headerSize = 24 + 12*numTri;
+    ASSERT_EQ(headerSize + 2*frameSize, bytes.size());
+    ASSERT_EQ("CHAPMESH", bytes.substr(0, 8));
+    ASSERT_EQ(1, readUint32(bytes, 8));
+    ASSERT_EQ(numLen, readUint32(bytes, 12));
+    ASSERT_EQ(numPhi, readUint32(bytes, 16));
+    ASSERT_EQ(numTri, readUint32(bytes, 20));
+
+    // check first triangle:
+    ASSERT_EQ(0, readUint32(bytes, 24));
+    ASSERT_EQ(numPhi + 1, readUint32(bytes, 28));
+    ASSERT_EQ(numPhi, readUint32(bytes, 32));
+
+    // check frame data (converted to Angstrom):
+    const real eps = 1e-5;
+    for(int t = 0; t < 2; t++)
+    {
+        float frame[1 + 3*12];
+        std::memcpy(frame, bytes.data() + headerSize + t*frameSize, frameSize);
+        ASSERT_NEAR(10.0*t, frame[0], eps);
+        for(size_t i = 0; i < numVert; i++)
+        {
+            ASSERT_NEAR(1.0*i, frame[1 + 3*i + XX], eps);
+            ASSERT_NEAR(2.0*t, frame[1 + 3*i + YY], eps);
+            ASSERT_NEAR(-3.0, frame[1 + 3*i + ZZ], eps);
+        }
+    }
+}
+
@@ -476,3 +476,62 @@ TEST_F(MolecularPathTest, MolecularPathVolumeTest)
                 std::sqrt(eps));                
 }
 
+
+
+/*!
+ * Checks that accessors return references to the internal data rather than 
+ * copies and that the cached summary quantities are kept consistent with the
+ * path when its parameterisation is shifted.
+ */
+TEST_F(MolecularPathTest, MolecularPathCachedPropertiesTest)
+{
+    // get machine epsilon:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // create an hourglass-shaped path:
+    gmx::RVec dir(-0.6, 0.5, 1.0);
+    gmx::RVec centre(0.4, -2.5, -0.1);
+    real length = 2.1;
+    real radius = 0.5;
+    int numPoints = 25;
+    MolecularPath mpHourglass = makeHourglassPath(
+            dir, 
+            centre, 
+            length, 
+            radius,
+            numPoints);
+
+    // accessors do not copy:
+    ASSERT_EQ(&mpHourglass.pathRadius(), &mpHourglass.pathRadius());
+    ASSERT_EQ(&mpHourglass.centreLine(), &mpHourglass.centreLine());
+    ASSERT_EQ(&mpHourglass.pathPoints(), &mpHourglass.pathPoints());
+    ASSERT_EQ(&mpHourglass.pathRadii(), &mpHourglass.pathRadii());
+
+    // cached values before shift:
+    std::pair<real, real> minRadius = mpHourglass.minRadius();
+    real volume = mpHourglass.volume();
+    real pathLength = mpHourglass.length();
+    real sLo = mpHourglass.sLo();
+    real sHi = mpHourglass.sHi();
+
+    // shift path parameterisation:
+    gmx::RVec shift(0.7, 0.0, 0.0);
+    mpHourglass.shift(shift);
+
+    // location of openings and minimum move with the shift:
+    ASSERT_NEAR(sLo - shift[SS], mpHourglass.sLo(), eps);
+    ASSERT_NEAR(sHi - shift[SS], mpHourglass.sHi(), eps);
+    ASSERT_NEAR(minRadius.first - shift[SS], 
+                mpHourglass.minRadius().first, 
+                std::sqrt(eps));
+
+    // cached minimum is consistent with shifted radius spline:
+    ASSERT_NEAR(mpHourglass.radius(mpHourglass.minRadius().first),
+                mpHourglass.minRadius().second,
+                eps);
+
+    // invariant quantities are unchanged:
+    ASSERT_EQ(minRadius.second, mpHourglass.minRadius().second);
+    ASSERT_EQ(volume, mpHourglass.volume());
+    ASSERT_EQ(pathLength, mpHourglass.length());
+}
@@ -0,0 +1,179 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "statistics/block_average.hpp"
+
+
+/*!
+ * \brief Test fixture for BlockAverage.
+ */
+class BlockAverageTest : public ::testing::Test
+{
+    protected:
+
+        // creates an AR(1) process with given correlation coefficient:
+        std::vector<real> autoregressiveSeries(
+                size_t num, 
+                real phi,
+                real sigma)
+        {
+            std::default_random_engine generator;
+            std::normal_distribution<real> distribution(0.0, sigma);
+            std::vector<real> series;
+            series.reserve(num);
+            real x = 0.0;
+            for(size_t i = 0; i < num; i++)
+            {
+                x = phi*x + distribution(generator);
+                series.push_back(x);
+            }
+            return series;
+        }
+};
+
+
+/*!
+ * Checks that the mean is computed exactly, that the number of levels grows
+ * only logarithmically, and that zero is returned as standard error for 
+ * insufficient data.
+ */
+TEST_F(BlockAverageTest, BlockAverageMeanAndLevelsTest)
+{
+    // floating point tolerance:
+    real eps = std::sqrt(std::numeric_limits<real>::epsilon());
+
+    // empty and single value case:
+    BlockAverage blockAvg;
+    ASSERT_EQ(0, blockAvg.num());
+    ASSERT_NEAR(0.0, blockAvg.standardError(), eps);
+    blockAvg.update(1.0);
+    ASSERT_NEAR(0.0, blockAvg.standardError(), eps);
+
+    // infinite values are ignored:
+    blockAvg.update(std::numeric_limits<real>::infinity());
+    ASSERT_EQ(1, blockAvg.num());
+
+    // add a sequence of integers:
+    size_t num = 1024;
+    for(size_t i = 2; i <= num; i++)
+    {
+        blockAvg.update(i);
+    }
+    ASSERT_EQ(static_cast<int>(num), blockAvg.num());
+    ASSERT_NEAR(0.5*(num + 1), blockAvg.mean(), eps*num);
+    ASSERT_EQ(11u, blockAvg.numLevels());
+
+    // requesting nonexistent level throws:
+    ASSERT_THROW(blockAvg.standardError(11), std::out_of_range);
+}
+
+
+/*!
+ * Checks that for uncorrelated data the standard error agrees with the naive
+ * estimate.
+ */
+TEST_F(BlockAverageTest, BlockAverageUncorrelatedTest)
+{
+    // create uncorrelated series:
+    size_t num = 1 << 16;
+    real sigma = 2.0;
+    std::vector<real> series = autoregressiveSeries(num, 0.0, sigma);
+
+    BlockAverage blockAvg;
+    for(auto x : series)
+    {
+        blockAvg.update(x);
+    }
+
+    // compare to naive estimate:
+    real expected = sigma/std::sqrt(num);
+    ASSERT_NEAR(expected, blockAvg.standardError(0), 0.05*expected);
+    ASSERT_NEAR(expected, blockAvg.standardError(), 0.1*expected);
+}
+
+
+/*!
+ * Checks that for correlated data the standard error is close to the 
+ * analytical result for an AR(1) process and considerably larger than the
+ * naive estimate.
+ */
+TEST_F(BlockAverageTest, BlockAverageCorrelatedTest)
+{
+    // create correlated series:
+    size_t num = 1 << 18;
+    real phi = 0.9;
+    real sigma = 1.0;
+    std::vector<real> series = autoregressiveSeries(num, phi, sigma);
+
+    BlockAverage blockAvg;
+    for(auto x : series)
+    {
+        blockAvg.update(x);
+    }
+
+    // analytical standard error of mean for AR(1) process:
+    real expected = sigma/(1.0 - phi)/std::sqrt(num);
+
+    // naive estimate is too optimistic:
+    ASSERT_LT(blockAvg.standardError(0), 0.5*expected);
+
+    // blocking estimate is close to the true value:
+    ASSERT_NEAR(expected, blockAvg.standardError(), 0.25*expected);
+}
+
+
+/*!
+ * Checks that updating multiple block averages at once is equivalent to 
+ * updating them individually.
+ */
+TEST_F(BlockAverageTest, BlockAverageUpdateMultipleTest)
+{
+    std::vector<real> series = autoregressiveSeries(1000, 0.5, 1.0);
+
+    std::vector<BlockAverage> multiple(2);
+    BlockAverage single;
+    for(auto x : series)
+    {
+        BlockAverage::updateMultiple(multiple, {x, 2.0*x});
+        single.update(x);
+    }
+
+    ASSERT_FLOAT_EQ(single.mean(), multiple[0].mean());
+    ASSERT_FLOAT_EQ(single.standardError(), multiple[0].standardError());
+    ASSERT_FLOAT_EQ(
+            2.0*single.standardError(), 
+            multiple[1].standardError());
+
+    // size mismatch throws:
+    ASSERT_THROW(
+            BlockAverage::updateMultiple(multiple, {1.0}),
+            std::logic_error);
+}
+
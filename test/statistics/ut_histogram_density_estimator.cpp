@@ -321,3 +321,162 @@ TEST_F(HistogramDensityEstimatorTest, HistogramDensityEstimatorEstimateTest)
    }
 }
 
+
+/*!
+ * This test checks that fixed range binning assigns each sample inside the 
+ * histogram range to exactly one bin, that the padding bins remain empty, and
+ * that samples outside the range are ignored. No sorting of the input data is
+ * performed.
+ */
+TEST_F(HistogramDensityEstimatorTest, 
+       HistogramDensityEstimatorFixedRangeBinningTest)
+{
+    // create histogram estimator with fixed range:
+    HistogramDensityEstimator hde;
+    hde.setBinWidth(0.1);
+    hde.setRange(-5.0, 5.0);
+
+    // check that invalid range is rejected:
+    HistogramDensityEstimator hdeInvalid;
+    ASSERT_THROW(hdeInvalid.setRange(1.0, 1.0), std::logic_error);
+    ASSERT_THROW(hdeInvalid.setRange(1.0, -1.0), std::logic_error);
+
+    // count number of samples inside range:
+    size_t numInside = 0;
+    for(auto s : testData_)
+    {
+        if( s >= -5.0 && s <= 5.0 )
+        {
+            numInside++;
+        }
+    }
+
+    // bin the (unsorted) test data:
+    std::vector<size_t> counts(hde.numFixedRangeBins(), 0);
+    size_t numBinned = hde.binFixedRange(testData_, counts);
+
+    // all samples inside range must be counted exactly once:
+    ASSERT_EQ(numInside, numBinned);
+    size_t sum = 0;
+    for(auto c : counts)
+    {
+        sum += c;
+    }
+    ASSERT_EQ(numInside, sum);
+
+    // padding bins should be empty:
+    ASSERT_EQ(0, counts.front());
+    ASSERT_EQ(0, counts.back());
+
+    // samples exactly on range limits are counted:
+    std::vector<size_t> limitCounts(hde.numFixedRangeBins(), 0);
+    std::vector<real> limits = {-5.0, 5.0};
+    ASSERT_EQ(2, hde.binFixedRange(limits, limitCounts));
+    ASSERT_EQ(0, limitCounts.front());
+    ASSERT_EQ(0, limitCounts.back());
+}
+
+
+/*!
+ * This test checks that the fixed range histogram yields a normalised density
+ * whose bin densities agree with those of the adaptive range histogram (if 
+ * its bins are aligned with the adaptive breaks) and that accumulating the 
+ * sample in several chunks yields the same density as estimating it from the
+ * full sample at once.
+ */
+TEST_F(HistogramDensityEstimatorTest, 
+       HistogramDensityEstimatorAccumulateTest)
+{
+    // floating point comparison tolerance:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // data range:
+    real dataMin = *std::min_element(testData_.begin(), testData_.end());
+    real dataMax = *std::max_element(testData_.begin(), testData_.end());
+
+    // fixed range estimator covering data range:
+    real bw = 0.1;
+    HistogramDensityEstimator hde;
+    hde.setBinWidth(bw);
+    hde.setRange(dataMin, dataMax);
+
+    // accumulation without range is an error:
+    HistogramDensityEstimator hdeNoRange;
+    hdeNoRange.setBinWidth(bw);
+    ASSERT_THROW(hdeNoRange.accumulate(testData_), std::logic_error);
+
+    // density from full sample (input must remain unsorted):
+    std::vector<real> unsorted = testData_;
+    SplineCurve1D fullDensity = hde.estimate(testData_);
+    ASSERT_TRUE(std::equal(unsorted.begin(), unsorted.end(), 
+                           testData_.begin()));
+
+    // accumulate sample in chunks:
+    size_t chunkSize = 999;
+    for(size_t i = 0; i < testData_.size(); i += chunkSize)
+    {
+        std::vector<real> chunk(
+                testData_.begin() + i, 
+                testData_.begin() + std::min(i + chunkSize, testData_.size()));
+        hde.accumulate(chunk);
+    }
+    ASSERT_EQ(testData_.size(), hde.numAccumulated());
+    SplineCurve1D accumulatedDensity = hde.accumulatedEstimate();
+
+    // evaluate both densities on fine grid:
+    int numEval = 10000;
+    real evalStep = (dataMax - dataMin + 4.0*bw)/numEval;
+    real integral = 0.0;
+    for(int i = 0; i < numEval; i++)
+    {
+        real eval = dataMin - 2.0*bw + i*evalStep;
+        real full = fullDensity.evaluate(eval, 0);
+        real accu = accumulatedDensity.evaluate(eval, 0);
+
+        ASSERT_LE(0.0, full);
+        ASSERT_NEAR(full, accu, std::sqrt(eps));
+        integral += full;
+    }
+    integral *= evalStep;
+    ASSERT_NEAR(1.0, integral, std::sqrt(eps));
+
+    // density vanishes outside range:
+    ASSERT_NEAR(0.0, fullDensity.evaluate(dataMin - 2.0*bw, 0), eps);
+    ASSERT_NEAR(0.0, fullDensity.evaluate(dataMax + 2.0*bw, 0), eps);
+
+    // adaptive range histogram of the same sample:
+    HistogramDensityEstimator hdeAdaptive;
+    hdeAdaptive.setBinWidth(bw);
+    std::vector<real> sorted = testData_;
+    SplineCurve1D adaptiveDensity = hdeAdaptive.estimate(sorted);
+
+    // fixed range histogram with bins aligned to the adaptive breaks, which 
+    // start half a bin width below the smallest sample:
+    HistogramDensityEstimator hdeAligned;
+    hdeAligned.setBinWidth(bw);
+    hdeAligned.setRange(dataMin - 0.5*bw, dataMax + 0.5*bw);
+    SplineCurve1D alignedDensity = hdeAligned.estimate(testData_);
+
+    // both histograms have the same bins, so that the bin densities (i.e. the
+    // control points of the interpolating splines) agree up to samples on 
+    // bin boundaries, which are assigned to different bins:
+    const std::vector<real> &adaptiveBins = adaptiveDensity.ctrlPoints();
+    const std::vector<real> &alignedBins = alignedDensity.ctrlPoints();
+    size_t numCommonBins = std::min(adaptiveBins.size(), alignedBins.size());
+    ASSERT_LE(adaptiveBins.size() - numCommonBins, 1);
+    ASSERT_LE(alignedBins.size() - numCommonBins, 1);
+    real binTol = 2.0/(testData_.size()*bw);
+    for(size_t i = 0; i < numCommonBins; i++)
+    {
+        ASSERT_NEAR(adaptiveBins[i], alignedBins[i], binTol);
+    }
+
+    // reset discards accumulated samples:
+    hde.resetAccumulator();
+    ASSERT_EQ(0, hde.numAccumulated());
+    SplineCurve1D emptyDensity = hde.accumulatedEstimate();
+    for(auto c : emptyDensity.ctrlPoints())
+    {
+        ASSERT_EQ(0.0, c);
+    }
+}
@@ -0,0 +1,211 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "statistics/histogram_density_estimator.hpp"
+#include "statistics/pooled_density_accumulator.hpp"
+
+
+/*!
+ * \brief Test fixture for the PooledDensityAccumulator.
+ *
+ * Creates several frames of samples drawn from Gaussian distributions with 
+ * different means and numbers of samples.
+ */
+class PooledDensityAccumulatorTest : public ::testing::Test
+{
+    public:
+
+        /*!
+         * Constructor creates the per-frame samples.
+         */
+        PooledDensityAccumulatorTest()
+        {
+            std::default_random_engine generator;
+
+            // create a random sample for each frame:
+            size_t numFrames = 5;
+            for(size_t i = 0; i < numFrames; i++)
+            {
+                std::normal_distribution<real> distribution(0.2*i, 1.0);
+                std::vector<real> frame;
+                for(size_t j = 0; j < 1000 + 100*i; j++)
+                {
+                    frame.push_back( distribution(generator) );
+                }
+                frames_.push_back(frame);
+            }
+
+            // evaluation points covering the data range:
+            for(int i = 0; i < 2000; i++)
+            {
+                evalPoints_.push_back(-10.0 + i*0.01);
+            }
+        };
+
+    protected:
+
+        std::vector<std::vector<real>> frames_;
+        std::vector<real> evalPoints_;
+};
+
+
+/*!
+ * Checks that an accumulator without bin width can not be used and that 
+ * invalid bin widths and inconsistent weights are rejected.
+ */
+TEST_F(PooledDensityAccumulatorTest, PooledDensityAccumulatorExceptionTest)
+{
+    PooledDensityAccumulator acc;
+    ASSERT_THROW(acc.addFrame(frames_.front()), std::logic_error);
+    ASSERT_THROW(acc.setBinWidth(0.0), std::logic_error);
+    ASSERT_THROW(acc.setBinWidth(-0.1), std::logic_error);
+
+    acc.setBinWidth(0.1);
+    std::vector<real> weights(frames_.front().size() + 1, 1.0);
+    ASSERT_THROW(acc.addFrame(frames_.front(), weights), std::logic_error);
+
+    // empty accumulator yields zero density:
+    for(auto d : acc.probabilityDensity(evalPoints_))
+    {
+        ASSERT_EQ(0.0, d);
+    }
+}
+
+
+/*!
+ * Checks that the pooled probability density is positive semi-definite, 
+ * integrates to one, and agrees with a fixed range histogram over the same 
+ * pooled sample.
+ */
+TEST_F(PooledDensityAccumulatorTest, PooledDensityAccumulatorProbabilityTest)
+{
+    real eps = std::numeric_limits<real>::epsilon();
+    real binWidth = 0.1;
+
+    // accumulate frames:
+    PooledDensityAccumulator acc;
+    acc.setBinWidth(binWidth);
+    std::vector<real> pooled;
+    for(auto frame : frames_)
+    {
+        acc.addFrame(frame);
+        pooled.insert(pooled.end(), frame.begin(), frame.end());
+    }
+    ASSERT_EQ(frames_.size(), acc.numFrames());
+    ASSERT_NEAR(pooled.size(), acc.totalWeight(), eps);
+
+    // evaluate density:
+    std::vector<real> density = acc.probabilityDensity(evalPoints_);
+    ASSERT_EQ(evalPoints_.size(), density.size());
+    real integral = 0.0;
+    for(auto d : density)
+    {
+        ASSERT_LE(0.0, d);
+        integral += d;
+    }
+    integral *= evalPoints_[1] - evalPoints_[0];
+    ASSERT_NEAR(1.0, integral, 1e-3);
+
+    // reference histogram on the same grid of bins:
+    real dataMin = *std::min_element(pooled.begin(), pooled.end());
+    real dataMax = *std::max_element(pooled.begin(), pooled.end());
+    real rangeLo = std::floor(dataMin/binWidth)*binWidth;
+    real rangeHi = (std::floor(dataMax/binWidth) + 1)*binWidth;
+    HistogramDensityEstimator hde;
+    hde.setBinWidth(binWidth);
+    hde.setRange(rangeLo, rangeHi);
+    SplineCurve1D reference = hde.estimate(pooled);
+
+    // compare at bin centres:
+    for(real s = rangeLo + 0.5*binWidth; s < rangeHi; s += binWidth)
+    {
+        std::vector<real> eval = {s};
+        ASSERT_NEAR(
+                reference.evaluate(s, 0), 
+                acc.probabilityDensity(eval).front(), 
+                std::sqrt(eps));
+    }
+}
+
+
+/*!
+ * Checks that the frame-averaged density equals the average of per-frame 
+ * histograms and that sample weights are taken into account.
+ */
+TEST_F(PooledDensityAccumulatorTest, PooledDensityAccumulatorFrameAverageTest)
+{
+    real eps = std::numeric_limits<real>::epsilon();
+    real binWidth = 0.25;
+    real weight = 0.5;
+
+    // accumulate frames with and without weights:
+    PooledDensityAccumulator acc;
+    PooledDensityAccumulator weightedAcc;
+    acc.setBinWidth(binWidth);
+    weightedAcc.setBinWidth(binWidth);
+    std::vector<real> average(evalPoints_.size(), 0.0);
+    for(auto frame : frames_)
+    {
+        acc.addFrame(frame);
+        weightedAcc.addFrame(frame, std::vector<real>(frame.size(), weight));
+
+        // per-frame density scaled by number of samples:
+        PooledDensityAccumulator frameAcc;
+        frameAcc.setBinWidth(binWidth);
+        frameAcc.addFrame(frame);
+        std::vector<real> frameDensity = frameAcc.frameAveragedDensity(
+                evalPoints_);
+        for(size_t i = 0; i < average.size(); i++)
+        {
+            average[i] += frameDensity[i]/frames_.size();
+        }
+    }
+
+    // compare to frame-averaged density:
+    std::vector<real> density = acc.frameAveragedDensity(evalPoints_);
+    std::vector<real> weighted = weightedAcc.frameAveragedDensity(evalPoints_);
+    for(size_t i = 0; i < evalPoints_.size(); i++)
+    {
+        real tol = std::sqrt(eps)*std::max(real(1.0), average[i]);
+        ASSERT_NEAR(average[i], density[i], tol);
+        ASSERT_NEAR(weight*density[i], weighted[i], tol);
+    }
+
+    // empty frames still count towards average:
+    acc.addFrame(std::vector<real>());
+    ASSERT_EQ(frames_.size() + 1, acc.numFrames());
+
+    // reset clears everything:
+    acc.reset();
+    ASSERT_EQ(0, acc.numFrames());
+    ASSERT_EQ(0.0, acc.totalWeight());
+}
+
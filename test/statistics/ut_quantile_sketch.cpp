@@ -0,0 +1,184 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "statistics/quantile_sketch.hpp"
+
+
+/*!
+ * \brief Test fixture for QuantileSketch.
+ *
+ * Creates a large random sample from a normal distribution.
+ */
+class QuantileSketchTest : public ::testing::Test
+{
+    public:
+
+        // constructor for creating test data:
+        QuantileSketchTest()
+        {
+            std::default_random_engine generator;
+            std::normal_distribution<real> distribution(1.0, 2.0);
+            for(size_t i = 0; i < 1e5; i++)
+            {
+                testData_.push_back( distribution(generator) );
+            }
+        }
+
+    protected:
+
+        // test data:
+        std::vector<real> testData_;
+
+        // fraction of test data smaller than given value:
+        real empiricalCdf(real x)
+        {
+            size_t num = std::count_if(
+                    testData_.begin(), 
+                    testData_.end(), 
+                    [x](real d){return d < x;});
+            return static_cast<real>(num)/testData_.size();
+        }
+};
+
+
+/*!
+ * Checks that the quantiles estimated from the sketch agree with the exact
+ * sample quantiles, i.e. that the fraction of the sample below the estimated 
+ * q-th quantile is close to q (with higher accuracy in the tails), and 
+ * that the extreme quantiles are exactly the minimum and maximum.
+ */
+TEST_F(QuantileSketchTest, QuantileSketchAccuracyTest)
+{
+    // create sketch from data:
+    QuantileSketch sketch;
+    for(auto x : testData_)
+    {
+        sketch.update(x);
+    }
+    ASSERT_EQ(testData_.size(), sketch.num());
+
+    // check a range of quantiles:
+    std::vector<real> quantiles = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+    for(auto q : quantiles)
+    {
+        real tol = 0.01*std::max(q*(1.0 - q), 0.1);
+        ASSERT_NEAR(q, empiricalCdf(sketch.quantile(q)), tol);
+    }
+
+    // extreme quantiles are minimum and maximum:
+    real eps = std::numeric_limits<real>::epsilon();
+    ASSERT_NEAR(
+            *std::min_element(testData_.begin(), testData_.end()), 
+            sketch.quantile(0.0), 
+            eps);
+    ASSERT_NEAR(
+            *std::max_element(testData_.begin(), testData_.end()), 
+            sketch.quantile(1.0), 
+            eps);
+
+    // quantiles are monotonic:
+    for(real q = 0.0; q < 1.0; q += 0.001)
+    {
+        ASSERT_LE(sketch.quantile(q), sketch.quantile(std::min(q + 0.001, 1.0)));
+    }
+
+    // invalid quantiles are rejected:
+    ASSERT_THROW(sketch.quantile(-0.1), std::logic_error);
+    ASSERT_THROW(sketch.quantile(1.1), std::logic_error);
+}
+
+
+/*!
+ * Checks that merging sketches of disjoint parts of the dataset yields 
+ * quantiles consistent with the full dataset, that shifting the sketch shifts
+ * the quantiles, and that infinite values are ignored.
+ */
+TEST_F(QuantileSketchTest, QuantileSketchMergeShiftTest)
+{
+    // sketches of two parts of dataset:
+    QuantileSketch sketchA;
+    QuantileSketch sketchB;
+    for(size_t i = 0; i < testData_.size(); i++)
+    {
+        if( i % 3 == 0 )
+        {
+            sketchA.update(testData_[i]);
+        }
+        else
+        {
+            sketchB.update(testData_[i]);
+        }
+    }
+
+    // merge and compare to exact quantiles:
+    sketchA.merge(sketchB);
+    ASSERT_EQ(testData_.size(), sketchA.num());
+    std::vector<real> quantiles = {0.05, 0.5, 0.95};
+    for(auto q : quantiles)
+    {
+        ASSERT_NEAR(q, empiricalCdf(sketchA.quantile(q)), 0.005);
+    }
+
+    // shift sketch:
+    real shift = 3.5;
+    real median = sketchA.quantile(0.5);
+    sketchA.shift(shift);
+    ASSERT_NEAR(median + shift, sketchA.quantile(0.5), 1e-4);
+
+    // infinite values are ignored:
+    QuantileSketch sketchInf;
+    sketchInf.update(std::numeric_limits<real>::infinity());
+    sketchInf.update(-std::numeric_limits<real>::infinity());
+    ASSERT_EQ(0, sketchInf.num());
+    ASSERT_EQ(0.0, sketchInf.quantile(0.5));
+    sketchInf.update(2.0);
+    ASSERT_EQ(2.0, sketchInf.quantile(0.5));
+}
+
+
+/*!
+ * Checks that the extreme quantiles are the minimum and maximum even if a 
+ * strong compression has merged all values into a single centroid.
+ */
+TEST_F(QuantileSketchTest, QuantileSketchSingleCentroidTest)
+{
+    // small compression parameter merges all values into one centroid:
+    QuantileSketch sketch(0.1);
+    std::vector<real> values = {1.0, 4.0, 2.0, 3.0, 3.5};
+    for(auto val : values)
+    {
+        sketch.update(val);
+    }
+
+    ASSERT_EQ(values.size(), sketch.num());
+    ASSERT_EQ(1.0, sketch.quantile(0.0));
+    ASSERT_EQ(4.0, sketch.quantile(1.0));
+}
@@ -147,3 +147,59 @@ TEST_F(SummaryStatisticsTest, SummaryStatisticsVarSdTest)
     ASSERT_NEAR(sd, testDataSummary.sd(), eps);
 }
 
+
+
+/*!
+ * Checks that merging the summary statistics of two disjoint parts of a 
+ * dataset yields the same result as updating a single object with the entire
+ * dataset. Also checks that merging with empty summary statistics is a no-op.
+ */
+TEST_F(SummaryStatisticsTest, SummaryStatisticsMergeTest)
+{
+    // tolerance threshold for floating point comparison:
+    real eps = 10*std::numeric_limits<real>::epsilon();
+
+    // summary statistics of entire data set:
+    SummaryStatistics fullSummary;
+    for(auto x : testData_)
+    {
+        fullSummary.update(x);
+    }
+
+    // try all possible ways of splitting the data set in two parts:
+    for(size_t split = 0; split <= testData_.size(); split++)
+    {
+        SummaryStatistics summaryA;
+        SummaryStatistics summaryB;
+        for(size_t i = 0; i < testData_.size(); i++)
+        {
+            if( i < split )
+            {
+                summaryA.update(testData_.at(i));
+            }
+            else
+            {
+                summaryB.update(testData_.at(i));
+            }
+        }
+
+        // merge second part into first:
+        summaryA.merge(summaryB);
+
+        // assert correctness:
+        ASSERT_EQ(fullSummary.num(), summaryA.num());
+        ASSERT_NEAR(fullSummary.min(), summaryA.min(), eps);
+        ASSERT_NEAR(fullSummary.max(), summaryA.max(), eps);
+        ASSERT_NEAR(fullSummary.mean(), summaryA.mean(), eps);
+        ASSERT_NEAR(fullSummary.var(), summaryA.var(), eps);
+        ASSERT_NEAR(fullSummary.sd(), summaryA.sd(), eps);
+    }
+
+    // merging empty summary statistics changes nothing:
+    SummaryStatistics emptySummary;
+    SummaryStatistics copySummary = fullSummary;
+    copySummary.merge(emptySummary);
+    ASSERT_EQ(fullSummary.num(), copySummary.num());
+    ASSERT_NEAR(fullSummary.mean(), copySummary.mean(), eps);
+    ASSERT_NEAR(fullSummary.var(), copySummary.var(), eps);
+}
@@ -0,0 +1,156 @@
+// CHAP - The Channel Annotation Package
+// 
+// Copyright (c) 2016 - 2018 Gianni Klesse, Shanlin Rao, Mark S. P. Sansom, and 
+// Stephen J. Tucker
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "statistics/summary_statistics_vector.hpp"
+
+
+/*!
+ * \brief Test fixture for SummaryStatisticsVector.
+ *
+ * Initialises a set of profiles used in all tests, where each profile 
+ * contains an infinite value at a different position.
+ */
+class SummaryStatisticsVectorTest : public ::testing::Test
+{
+    public:
+
+        // constructor for creating test data:
+        SummaryStatisticsVectorTest()
+        {
+            real inf = std::numeric_limits<real>::infinity();
+            profiles_ = {{0.3, 1.5, -0.9, 2.0},
+                         {1.5, inf, 0.1, -3.0},
+                         {-0.9, 0.7, -inf, 0.5},
+                         {std::sqrt(2.0), -5.1, 0.2, 1.1},
+                         {-5.1, 0.4, 3.3, 0.0}};
+        }
+
+    protected:
+
+        // test data:
+        std::vector<std::vector<real>> profiles_;
+};
+
+
+/*!
+ * Checks that the vector of summary statistics yields the same results as 
+ * updating a separate SummaryStatistics object for each element.
+ */
+TEST_F(SummaryStatisticsVectorTest, SummaryStatisticsVectorUpdateTest)
+{
+    // tolerance threshold for floating point comparison:
+    real eps = std::numeric_limits<real>::epsilon();
+
+    // update both vector and individual summary statistics:
+    size_t numElem = profiles_.front().size();
+    SummaryStatisticsVector sumStatVec(numElem);
+    std::vector<SummaryStatistics> sumStats(numElem);
+    for(auto p : profiles_)
+    {
+        sumStatVec.update(p);
+        SummaryStatistics::updateMultiple(sumStats, p);
+    }
+
+    // invalid size is rejected:
+    ASSERT_THROW(sumStatVec.update(std::vector<real>(numElem + 1)), 
+                 std::logic_error);
+    ASSERT_THROW(sumStatVec.at(numElem), std::out_of_range);
+
+    // compare results:
+    ASSERT_EQ(numElem, sumStatVec.size());
+    for(size_t i = 0; i < numElem; i++)
+    {
+        ASSERT_EQ(sumStats[i].num(), sumStatVec.at(i).num());
+        ASSERT_NEAR(sumStats[i].min(), sumStatVec.at(i).min(), eps);
+        ASSERT_NEAR(sumStats[i].max(), sumStatVec.at(i).max(), eps);
+        ASSERT_NEAR(sumStats[i].mean(), sumStatVec.at(i).mean(), eps);
+        ASSERT_NEAR(sumStats[i].var(), sumStatVec.at(i).var(), eps);
+        ASSERT_NEAR(sumStats[i].mean(), sumStatVec.mean().at(i), eps);
+        ASSERT_NEAR(sumStats[i].sd(), sumStatVec.sd().at(i), eps);
+    }
+
+    // shifting works as for individual summary statistics:
+    sumStatVec.shift(1.5);
+    for(size_t i = 0; i < numElem; i++)
+    {
+        sumStats[i].shift(1.5);
+        ASSERT_NEAR(sumStats[i].mean(), sumStatVec.at(i).mean(), eps);
+        ASSERT_NEAR(sumStats[i].min(), sumStatVec.at(i).min(), eps);
+        ASSERT_NEAR(sumStats[i].max(), sumStatVec.at(i).max(), eps);
+    }
+}
+
+
+/*!
+ * Checks that merging two vectors of summary statistics accumulated over 
+ * disjoint sets of profiles yields the same result as accumulating all 
+ * profiles in a single vector.
+ */
+TEST_F(SummaryStatisticsVectorTest, SummaryStatisticsVectorMergeTest)
+{
+    // tolerance threshold for floating point comparison:
+    real eps = 10*std::numeric_limits<real>::epsilon();
+
+    // accumulate all profiles and two disjoint subsets:
+    size_t numElem = profiles_.front().size();
+    SummaryStatisticsVector full(numElem);
+    SummaryStatisticsVector partA(numElem);
+    SummaryStatisticsVector partB(numElem);
+    for(size_t i = 0; i < profiles_.size(); i++)
+    {
+        full.update(profiles_[i]);
+        if( i < 2 )
+        {
+            partA.update(profiles_[i]);
+        }
+        else
+        {
+            partB.update(profiles_[i]);
+        }
+    }
+
+    // merge and compare:
+    partA.merge(partB);
+    std::vector<SummaryStatistics> fullStats = full.summaries();
+    std::vector<SummaryStatistics> mergedStats = partA.summaries();
+    for(size_t i = 0; i < numElem; i++)
+    {
+        ASSERT_EQ(fullStats[i].num(), mergedStats[i].num());
+        ASSERT_NEAR(fullStats[i].min(), mergedStats[i].min(), eps);
+        ASSERT_NEAR(fullStats[i].max(), mergedStats[i].max(), eps);
+        ASSERT_NEAR(fullStats[i].mean(), mergedStats[i].mean(), eps);
+        ASSERT_NEAR(fullStats[i].var(), mergedStats[i].var(), eps);
+    }
+
+    // merging vectors of different size is rejected:
+    SummaryStatisticsVector other(numElem + 1);
+    ASSERT_THROW(partA.merge(other), std::logic_error);
+}
+